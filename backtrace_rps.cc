@@ -273,8 +273,9 @@ Rps_Backtracer::pc_to_string(uintptr_t pc, bool* gotmain)
                             obzf-> get_physical_attr(RPS_ROOT_OB(_1EBVGSfW2m200z18rx)); //name∈named_attribute
                           if (namev && namev.is_string())
                             {
+                              std::string namstr = namev.as_cppstring();
                               u8_strncpy((uint8_t*)nambuf,
-                                         (const uint8_t*)(namev.as_cstring()),
+                                         (const uint8_t*)(namstr.c_str()),
                                          sizeof(nambuf)-1);
                             }
                         }
@@ -0,0 +1,1103 @@
+/****************************************************************
+ * file binstore_rps.cc
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * Description:
+ *      This file is part of the Reflective Persistent System.
+ *
+ *      It has the code of the compact binary snapshots of space
+ *      files, and of the converters between them and the canonical
+ *      JSON space files.
+ *
+ * Author(s):
+ *      Basile Starynkevitch, France    <basile@starynkevitch.net>
+ *      Niklas Rozencrantz, Sweden     <niklasr@protonmail.com>
+ *
+ *      © Copyright (C) 2026 The Reflective Persistent System Team
+ *      team@refpersys.org & http://refpersys.org/
+ *
+ * License:
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#include "refpersys.hh"
+
+
+
+extern "C" const char rps_binstore_gitid[];
+const char rps_binstore_gitid[]= RPS_GITID;
+
+
+extern "C" const char rps_binstore_shortgitid[];
+const char rps_binstore_shortgitid[]= RPS_SHORTGITID;
+
+
+extern "C" const char rps_binstore_basename[];
+const char rps_binstore_basename[]= RPS_BASENAME;
+
+extern "C" const char rps_binstore_baseid[];
+const char rps_binstore_baseid[]= RPS_BASEID;
+
+
+/// the header is the magic string, then the version and flags as
+/// little endian 32 bits words, then the JSON size and mtime, the body
+/// size and its checksum as little endian 64 bits words
+static constexpr size_t rps_binstore_magic_size = 8;
+static constexpr size_t rps_binstore_header_size = rps_binstore_magic_size + 2*4 + 4*8;
+
+/// nesting limit of decoded values, since corrupted data should
+/// not overflow the call stack
+static constexpr unsigned rps_binstore_max_depth = 256;
+
+void
+Rps_BinStoreReader::overflow(void) const
+{
+  throw std::runtime_error("truncated or corrupted binary store data");
+} // end Rps_BinStoreReader::overflow
+
+/// the FNV-1a hash of the body of a binary space file
+static uint64_t
+rps_binstore_checksum(const char*data, size_t len)
+{
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t ix=0; ix<len; ix++)
+    {
+      h ^= (unsigned char)data[ix];
+      h *= 1099511628211ULL;
+    }
+  return h;
+} // end rps_binstore_checksum
+
+static uint64_t
+rps_binstore_fixed(std::string_view sv, size_t off, unsigned nbytes)
+{
+  uint64_t r = 0;
+  for (int i=(int)nbytes-1; i>=0; i--)
+    r = (r << 8) | (unsigned char)sv[off+i];
+  return r;
+} // end rps_binstore_fixed
+
+/// is STR an oid in its canonical form, so kept in the oid table?
+static bool
+rps_binstore_canonical_oid(const std::string&str)
+{
+  if (str.size() != Rps_Id::nbchars || str[0] != '_' || !isalnum(str[1]))
+    return false;
+  if (!std::all_of(str.begin()+1, str.end(),
+                   [](char c)
+  {
+    return strchr(Rps_Id::b62digits, c) != nullptr;
+    }))
+  return false;
+  Rps_Id oid(str);
+  return oid.valid() && oid.to_string() == str;
+} // end rps_binstore_canonical_oid
+
+/// the string which would be loaded as an object, but not kept in
+/// the oid table since not canonical
+static bool
+rps_binstore_looks_like_oid(const std::string&str)
+{
+  return str.size() == Rps_Id::nbchars && str[0] == '_' && isalnum(str[1])
+         && std::all_of(str.begin()+1, str.end(),
+                        [](char c)
+  {
+    return strchr(Rps_Id::b62digits, c) != nullptr;
+  });
+} // end rps_binstore_looks_like_oid
+
+
+////////////////////////////////////////////////////////////////
+//// reading binary space files
+////////////////////////////////////////////////////////////////
+
+Rps_BinStoreSpace::Rps_BinStoreSpace(const std::string&path, std::string_view data)
+  : bss_path(path), bss_strings(), bss_oids(), bss_prolog(), bss_records(),
+    bss_jsonsize(0), bss_jsonmtime(0)
+{
+  if (data.size() < rps_binstore_header_size
+      || memcmp(data.data(), RPS_BINSTORE_MAGIC, rps_binstore_magic_size))
+    throw std::runtime_error("not a binary space file: " + path);
+  size_t off = rps_binstore_magic_size;
+  unsigned version = (unsigned) rps_binstore_fixed(data, off, 4);
+  off += 4;
+  unsigned flags = (unsigned) rps_binstore_fixed(data, off, 4);
+  off += 4;
+  if (version != RPS_BINSTORE_VERSION || flags != 0)
+    throw std::runtime_error("unsupported version "
+                             + std::to_string(version)
+                             + " of binary space file " + path);
+  bss_jsonsize = rps_binstore_fixed(data, off, 8);
+  off += 8;
+  bss_jsonmtime = (int64_t) rps_binstore_fixed(data, off, 8);
+  off += 8;
+  uint64_t bodysize = rps_binstore_fixed(data, off, 8);
+  off += 8;
+  uint64_t checksum = rps_binstore_fixed(data, off, 8);
+  off += 8;
+  RPS_ASSERT(off == rps_binstore_header_size);
+  if (bodysize != data.size() - off)
+    throw std::runtime_error("bad body size in binary space file " + path);
+  std::string_view body = data.substr(off);
+  if (checksum != rps_binstore_checksum(body.data(), body.size()))
+    throw std::runtime_error("bad checksum in binary space file " + path);
+  Rps_BinStoreReader rd(body);
+  uint64_t nbstrings = rd.varint();
+  if (nbstrings > body.size())
+    throw std::runtime_error("bad string pool in binary space file " + path);
+  bss_strings.reserve(nbstrings);
+  for (uint64_t ix=0; ix<nbstrings; ix++)
+    {
+      uint64_t len = rd.varint();
+      bss_strings.push_back(rd.bytes(len));
+    }
+  uint64_t nboids = rd.varint();
+  if (nboids > body.size()/Rps_Id::nbchars)
+    throw std::runtime_error("bad oid table in binary space file " + path);
+  bss_oids.reserve(nboids);
+  for (uint64_t ix=0; ix<nboids; ix++)
+    {
+      Rps_Id oid(std::string(rd.bytes(Rps_Id::nbchars)));
+      if (!oid.valid())
+        throw std::runtime_error("bad oid in binary space file " + path);
+      bss_oids.push_back(oid);
+    }
+  bss_prolog = string_at(rd.varint());
+  uint64_t nbrecords = rd.varint();
+  if (nbrecords > body.size())
+    throw std::runtime_error("bad record count in binary space file " + path);
+  bss_records.reserve(nbrecords);
+  for (uint64_t ix=0; ix<nbrecords; ix++)
+    {
+      uint64_t len = rd.varint();
+      bss_records.push_back(rd.bytes(len));
+    }
+  if (!rd.at_end())
+    throw std::runtime_error("trailing bytes in binary space file " + path);
+} // end Rps_BinStoreSpace::Rps_BinStoreSpace
+
+bool
+Rps_BinStoreSpace::is_fresh_for(const std::string&jsonpath) const
+{
+  struct stat jsonstat;
+  memset (&jsonstat, 0, sizeof(jsonstat));
+  if (stat(jsonpath.c_str(), &jsonstat))
+    return false;
+  int64_t mtimns = (int64_t)jsonstat.st_mtim.tv_sec * 1000000000LL
+                   + jsonstat.st_mtim.tv_nsec;
+  return (uint64_t)jsonstat.st_size == bss_jsonsize && mtimns == bss_jsonmtime;
+} // end Rps_BinStoreSpace::is_fresh_for
+
+Rps_BinStoreSpace::record_kind_en
+Rps_BinStoreSpace::record_start(Rps_BinStoreReader&rd, Rps_Id&oid, unsigned&lineno) const
+{
+  unsigned kind = rd.byte();
+  if (kind != bsrec_object && kind != bsrec_text)
+    throw std::runtime_error("bad record kind in binary space file " + bss_path);
+  oid = oid_at(rd.varint());
+  lineno = (unsigned) rd.varint();
+  return (record_kind_en) kind;
+} // end Rps_BinStoreSpace::record_start
+
+static Json::Value
+rps_binstore_read_json(const Rps_BinStoreSpace&bsp, Rps_BinStoreReader&rd, unsigned depth)
+{
+  if (depth > rps_binstore_max_depth)
+    throw std::runtime_error("too deep JSON in binary space file " + bsp.path());
+  switch (rd.byte())
+    {
+    case Rps_BinStoreSpace::bsjson_null:
+      return Json::Value(Json::nullValue);
+    case Rps_BinStoreSpace::bsjson_false:
+      return Json::Value(false);
+    case Rps_BinStoreSpace::bsjson_true:
+      return Json::Value(true);
+    case Rps_BinStoreSpace::bsjson_int:
+      return Json::Value((Json::Int64) rd.zigzag());
+    case Rps_BinStoreSpace::bsjson_uint:
+      return Json::Value((Json::UInt64) rd.varint());
+    case Rps_BinStoreSpace::bsjson_real:
+      return Json::Value(rd.float64());
+    case Rps_BinStoreSpace::bsjson_string:
+    {
+      std::string_view sv = bsp.string_at(rd.varint());
+      return Json::Value(sv.data(), sv.data()+sv.size());
+    }
+    case Rps_BinStoreSpace::bsjson_array:
+    {
+      Json::Value jarr(Json::arrayValue);
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        jarr.append(rps_binstore_read_json(bsp, rd, depth+1));
+      return jarr;
+    }
+    case Rps_BinStoreSpace::bsjson_object:
+    {
+      Json::Value jobj(Json::objectValue);
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        {
+          std::string key(bsp.string_at(rd.varint()));
+          jobj[key] = rps_binstore_read_json(bsp, rd, depth+1);
+        }
+      return jobj;
+    }
+    default:
+      break;
+    }
+  throw std::runtime_error("bad JSON tag in binary space file " + bsp.path());
+} // end rps_binstore_read_json
+
+Json::Value
+Rps_BinStoreSpace::read_json(Rps_BinStoreReader&rd) const
+{
+  return rps_binstore_read_json(*this, rd, 0);
+} // end Rps_BinStoreSpace::read_json
+
+static Json::Value
+rps_binstore_read_value_json(const Rps_BinStoreSpace&bsp, Rps_BinStoreReader&rd, unsigned depth)
+{
+  if (depth > rps_binstore_max_depth)
+    throw std::runtime_error("too deep value in binary space file " + bsp.path());
+  switch (rd.byte())
+    {
+    case Rps_BinStoreSpace::bstag_null:
+      return Json::Value(Json::nullValue);
+    case Rps_BinStoreSpace::bstag_int:
+      return Json::Value((Json::Int64) rd.zigzag());
+    case Rps_BinStoreSpace::bstag_real:
+      return Json::Value(rd.float64());
+    case Rps_BinStoreSpace::bstag_string:
+    {
+      std::string_view sv = bsp.string_at(rd.varint());
+      return Json::Value(sv.data(), sv.data()+sv.size());
+    }
+    case Rps_BinStoreSpace::bstag_objref:
+      return Json::Value(bsp.oid_at(rd.varint()).to_string());
+    case Rps_BinStoreSpace::bstag_set:
+    {
+      Json::Value jset(Json::objectValue);
+      Json::Value jelem(Json::arrayValue);
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        jelem.append(Json::Value(bsp.oid_at(rd.varint()).to_string()));
+      jset["vtype"] = Json::Value("set");
+      jset["elem"] = jelem;
+      return jset;
+    }
+    case Rps_BinStoreSpace::bstag_tuple:
+    {
+      Json::Value jtup(Json::objectValue);
+      Json::Value jcomp(Json::arrayValue);
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        {
+          uint64_t oidix = rd.varint();
+          if (oidix == 0)
+            jcomp.append(Json::Value(Json::nullValue));
+          else
+            jcomp.append(Json::Value(bsp.oid_at(oidix-1).to_string()));
+        }
+      jtup["vtype"] = Json::Value("tuple");
+      jtup["comp"] = jcomp;
+      return jtup;
+    }
+    case Rps_BinStoreSpace::bstag_closure:
+    {
+      Json::Value jclos(Json::objectValue);
+      Json::Value jenv(Json::arrayValue);
+      jclos["vtype"] = Json::Value("closure");
+      jclos["fn"] = Json::Value(bsp.oid_at(rd.varint()).to_string());
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        jenv.append(rps_binstore_read_value_json(bsp, rd, depth+1));
+      jclos["env"] = jenv;
+      uint64_t metaix = rd.varint();
+      if (metaix > 0)
+        {
+          jclos["metaobj"] = Json::Value(bsp.oid_at(metaix-1).to_string());
+          jclos["metarank"] = Json::Value((int) rd.zigzag());
+        }
+      return jclos;
+    }
+    case Rps_BinStoreSpace::bstag_json:
+      return rps_binstore_read_json(bsp, rd, depth+1);
+    default:
+      break;
+    }
+  throw std::runtime_error("bad value tag in binary space file " + bsp.path());
+} // end rps_binstore_read_value_json
+
+Json::Value
+Rps_BinStoreSpace::read_value_json(Rps_BinStoreReader&rd) const
+{
+  return rps_binstore_read_value_json(*this, rd, 0);
+} // end Rps_BinStoreSpace::read_value_json
+
+static void
+rps_binstore_skip_json(const Rps_BinStoreSpace&bsp, Rps_BinStoreReader&rd, unsigned depth)
+{
+  if (depth > rps_binstore_max_depth)
+    throw std::runtime_error("too deep JSON in binary space file " + bsp.path());
+  switch (rd.byte())
+    {
+    case Rps_BinStoreSpace::bsjson_null:
+    case Rps_BinStoreSpace::bsjson_false:
+    case Rps_BinStoreSpace::bsjson_true:
+      return;
+    case Rps_BinStoreSpace::bsjson_int:
+      (void) rd.zigzag();
+      return;
+    case Rps_BinStoreSpace::bsjson_uint:
+    case Rps_BinStoreSpace::bsjson_string:
+      (void) rd.varint();
+      return;
+    case Rps_BinStoreSpace::bsjson_real:
+      (void) rd.float64();
+      return;
+    case Rps_BinStoreSpace::bsjson_array:
+    {
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        rps_binstore_skip_json(bsp, rd, depth+1);
+      return;
+    }
+    case Rps_BinStoreSpace::bsjson_object:
+    {
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        {
+          (void) rd.varint();
+          rps_binstore_skip_json(bsp, rd, depth+1);
+        }
+      return;
+    }
+    default:
+      break;
+    }
+  throw std::runtime_error("bad JSON tag in binary space file " + bsp.path());
+} // end rps_binstore_skip_json
+
+void
+Rps_BinStoreSpace::skip_json(Rps_BinStoreReader&rd) const
+{
+  rps_binstore_skip_json(*this, rd, 0);
+} // end Rps_BinStoreSpace::skip_json
+
+static void
+rps_binstore_skip_value(const Rps_BinStoreSpace&bsp, Rps_BinStoreReader&rd, unsigned depth)
+{
+  if (depth > rps_binstore_max_depth)
+    throw std::runtime_error("too deep value in binary space file " + bsp.path());
+  switch (rd.byte())
+    {
+    case Rps_BinStoreSpace::bstag_null:
+      return;
+    case Rps_BinStoreSpace::bstag_int:
+      (void) rd.zigzag();
+      return;
+    case Rps_BinStoreSpace::bstag_real:
+      (void) rd.float64();
+      return;
+    case Rps_BinStoreSpace::bstag_string:
+    case Rps_BinStoreSpace::bstag_objref:
+      (void) rd.varint();
+      return;
+    case Rps_BinStoreSpace::bstag_set:
+    case Rps_BinStoreSpace::bstag_tuple:
+    {
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        (void) rd.varint();
+      return;
+    }
+    case Rps_BinStoreSpace::bstag_closure:
+    {
+      (void) rd.varint();
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        rps_binstore_skip_value(bsp, rd, depth+1);
+      if (rd.varint() > 0)
+        (void) rd.zigzag();
+      return;
+    }
+    case Rps_BinStoreSpace::bstag_json:
+      rps_binstore_skip_json(bsp, rd, depth+1);
+      return;
+    default:
+      break;
+    }
+  throw std::runtime_error("bad value tag in binary space file " + bsp.path());
+} // end rps_binstore_skip_value
+
+void
+Rps_BinStoreSpace::skip_value(Rps_BinStoreReader&rd) const
+{
+  rps_binstore_skip_value(*this, rd, 0);
+} // end Rps_BinStoreSpace::skip_value
+
+std::string
+Rps_BinStoreSpace::object_text(unsigned ix) const
+{
+  Rps_BinStoreReader rd(record(ix));
+  Rps_Id oid;
+  unsigned lineno = 0;
+  if (record_start(rd, oid, lineno) == bsrec_text)
+    return std::string(string_at(rd.varint()));
+  std::string_view head = string_at(rd.varint());
+  std::string_view tail = string_at(rd.varint());
+  Rps_Id classid = oid_at(rd.varint());
+  double mtime = rd.float64();
+  Json::Value jobject(Json::objectValue);
+  uint64_t nbcomps = rd.varint();
+  if (nbcomps > 0)
+    {
+      Json::Value jcomps(Json::arrayValue);
+      for (uint64_t cix=1; cix<nbcomps; cix++)
+        jcomps.append(read_value_json(rd));
+      jobject["comps"] = jcomps;
+    }
+  uint64_t nbattrs = rd.varint();
+  if (nbattrs > 0)
+    {
+      Json::Value jattrs(Json::arrayValue);
+      for (uint64_t aix=1; aix<nbattrs; aix++)
+        {
+          Json::Value jent(Json::objectValue);
+          jent["at"] = Json::Value(oid_at(rd.varint()).to_string());
+          jent["va"] = read_value_json(rd);
+          jattrs.append(jent);
+        }
+      jobject["attrs"] = jattrs;
+    }
+  Json::Value jextra = read_json(rd);
+  if (!jextra.isObject() || !rd.at_end())
+    throw std::runtime_error("bad object record of " + oid.to_string()
+                             + " in binary space file " + bss_path);
+  for (const std::string& key : jextra.getMemberNames())
+    jobject[key] = jextra[key];
+  jobject["oid"] = Json::Value(oid.to_string());
+  jobject["class"] = Json::Value(classid.to_string());
+  jobject["mtime"] = Json::Value(mtime);
+  std::ostringstream out;
+  out << head;
+  rps_dump_emit_object_json(out, jobject, mtime);
+  out << tail;
+  return out.str();
+} // end Rps_BinStoreSpace::object_text
+
+
+////////////////////////////////////////////////////////////////
+//// writing binary space files
+////////////////////////////////////////////////////////////////
+
+/// the pools and output buffer of a JSON to binary conversion
+class Rps_BinStoreWriter
+{
+  std::vector<const std::string*> bsw_strings;
+  std::unordered_map<std::string,unsigned> bsw_stringmap;
+  std::vector<const std::string*> bsw_oids;
+  std::unordered_map<std::string,unsigned> bsw_oidmap;
+public:
+  Rps_BinStoreWriter() {};
+  static void put_byte(std::string&out, unsigned char b)
+  {
+    out.push_back((char)b);
+  };
+  static void put_varint(std::string&out, uint64_t u)
+  {
+    while (u >= 0x80)
+      {
+        out.push_back((char)((u & 0x7f) | 0x80));
+        u >>= 7;
+      }
+    out.push_back((char)u);
+  };
+  static void put_zigzag(std::string&out, int64_t i)
+  {
+    put_varint(out, ((uint64_t)i << 1) ^ (uint64_t)(i >> 63));
+  };
+  static void put_fixed(std::string&out, uint64_t u, unsigned nbytes)
+  {
+    for (unsigned ix=0; ix<nbytes; ix++)
+      out.push_back((char)((u >> (8*ix)) & 0xff));
+  };
+  static void put_float64(std::string&out, double d)
+  {
+    uint64_t u = 0;
+    memcpy(&u, &d, sizeof(u));
+    put_fixed(out, u, 8);
+  };
+  unsigned string_index(const std::string&str)
+  {
+    auto it = bsw_stringmap.find(str);
+    if (it != bsw_stringmap.end())
+      return it->second;
+    unsigned ix = bsw_strings.size();
+    auto p = bsw_stringmap.insert({str, ix});
+    bsw_strings.push_back(&p.first->first);
+    return ix;
+  };
+  unsigned oid_index(const std::string&oidstr)
+  {
+    RPS_ASSERT(oidstr.size() == Rps_Id::nbchars);
+    auto it = bsw_oidmap.find(oidstr);
+    if (it != bsw_oidmap.end())
+      return it->second;
+    unsigned ix = bsw_oids.size();
+    auto p = bsw_oidmap.insert({oidstr, ix});
+    bsw_oids.push_back(&p.first->first);
+    return ix;
+  };
+  void put_json(std::string&out, const Json::Value&jv);
+  void put_value(std::string&out, const Json::Value&jv);
+  /// encode the object of text OBJTEXT into OUT, as a typed record
+  /// when re-emitting it gives the same text
+  void put_object(std::string&out, const std::string&oidstr, unsigned lineno,
+                  std::string_view objtext);
+  /// the body made of the pools, then the given prolog and records
+  std::string body(const std::string&prolog, const std::vector<std::string>&recvec);
+};                              // end class Rps_BinStoreWriter
+
+void
+Rps_BinStoreWriter::put_json(std::string&out, const Json::Value&jv)
+{
+  switch (jv.type())
+    {
+    case Json::nullValue:
+      put_byte(out, Rps_BinStoreSpace::bsjson_null);
+      return;
+    case Json::booleanValue:
+      put_byte(out, jv.asBool()?Rps_BinStoreSpace::bsjson_true:Rps_BinStoreSpace::bsjson_false);
+      return;
+    case Json::intValue:
+      put_byte(out, Rps_BinStoreSpace::bsjson_int);
+      put_zigzag(out, jv.asInt64());
+      return;
+    case Json::uintValue:
+      put_byte(out, Rps_BinStoreSpace::bsjson_uint);
+      put_varint(out, jv.asUInt64());
+      return;
+    case Json::realValue:
+      put_byte(out, Rps_BinStoreSpace::bsjson_real);
+      put_float64(out, jv.asDouble());
+      return;
+    case Json::stringValue:
+      put_byte(out, Rps_BinStoreSpace::bsjson_string);
+      put_varint(out, string_index(jv.asString()));
+      return;
+    case Json::arrayValue:
+      put_byte(out, Rps_BinStoreSpace::bsjson_array);
+      put_varint(out, jv.size());
+      for (const Json::Value& jcomp : jv)
+        put_json(out, jcomp);
+      return;
+    case Json::objectValue:
+    {
+      put_byte(out, Rps_BinStoreSpace::bsjson_object);
+      Json::Value::Members membvec = jv.getMemberNames();
+      put_varint(out, membvec.size());
+      for (const std::string& key : membvec)
+        {
+          put_varint(out, string_index(key));
+          put_json(out, jv[key]);
+        }
+    }
+    return;
+    }
+  throw std::runtime_error("unexpected JSON type in binary store conversion");
+} // end Rps_BinStoreWriter::put_json
+
+/// the values with the same meaning as in Rps_Value(const
+/// Json::Value&,Rps_Loader*) get their own tag; the other ones are
+/// kept as generic JSON
+void
+Rps_BinStoreWriter::put_value(std::string&out, const Json::Value&jv)
+{
+  switch (jv.type())
+    {
+    case Json::nullValue:
+      put_byte(out, Rps_BinStoreSpace::bstag_null);
+      return;
+    case Json::intValue:
+      put_byte(out, Rps_BinStoreSpace::bstag_int);
+      put_zigzag(out, jv.asInt64());
+      return;
+    case Json::realValue:
+      put_byte(out, Rps_BinStoreSpace::bstag_real);
+      put_float64(out, jv.asDouble());
+      return;
+    case Json::stringValue:
+    {
+      std::string str = jv.asString();
+      if (rps_binstore_canonical_oid(str))
+        {
+          put_byte(out, Rps_BinStoreSpace::bstag_objref);
+          put_varint(out, oid_index(str));
+          return;
+        }
+      else if (!rps_binstore_looks_like_oid(str))
+        {
+          put_byte(out, Rps_BinStoreSpace::bstag_string);
+          put_varint(out, string_index(str));
+          return;
+        }
+    }
+    break;
+    case Json::objectValue:
+    {
+      Json::Value jvtype = jv["vtype"];
+      std::string vtype = jvtype.isString()?jvtype.asString():std::string();
+      unsigned siz = jv.size();
+      auto all_oids = [](const Json::Value&jarr, bool withnull)
+      {
+        for (const Json::Value& jcomp : jarr)
+          if (!((withnull && jcomp.isNull())
+                || (jcomp.isString() && rps_binstore_canonical_oid(jcomp.asString()))))
+            return false;
+        return true;
+      };
+      if (vtype == "set" && siz == 2 && jv["elem"].isArray()
+          && all_oids(jv["elem"], false))
+        {
+          put_byte(out, Rps_BinStoreSpace::bstag_set);
+          put_varint(out, jv["elem"].size());
+          for (const Json::Value& jelem : jv["elem"])
+            put_varint(out, oid_index(jelem.asString()));
+          return;
+        }
+      else if (vtype == "tuple" && siz == 2 && jv["comp"].isArray()
+               && all_oids(jv["comp"], true))
+        {
+          put_byte(out, Rps_BinStoreSpace::bstag_tuple);
+          put_varint(out, jv["comp"].size());
+          for (const Json::Value& jcomp : jv["comp"])
+            put_varint(out, jcomp.isNull()?0:(1+oid_index(jcomp.asString())));
+          return;
+        }
+      else if (vtype == "closure" && jv["fn"].isString()
+               && rps_binstore_canonical_oid(jv["fn"].asString())
+               && jv["env"].isArray()
+               && (siz == 3
+                   || (siz == 5 && jv["metaobj"].isString()
+                       && rps_binstore_canonical_oid(jv["metaobj"].asString())
+                       && jv["metarank"].type() == Json::intValue
+                       && jv["metarank"].isInt())))
+        {
+          put_byte(out, Rps_BinStoreSpace::bstag_closure);
+          put_varint(out, oid_index(jv["fn"].asString()));
+          put_varint(out, jv["env"].size());
+          for (const Json::Value& jenv : jv["env"])
+            put_value(out, jenv);
+          if (siz == 5)
+            {
+              put_varint(out, 1+oid_index(jv["metaobj"].asString()));
+              put_zigzag(out, jv["metarank"].asInt());
+            }
+          else
+            put_varint(out, 0);
+          return;
+        }
+    }
+    break;
+    default:
+      break;
+    }
+  put_byte(out, Rps_BinStoreSpace::bstag_json);
+  put_json(out, jv);
+} // end Rps_BinStoreWriter::put_value
+
+void
+Rps_BinStoreWriter::put_object(std::string&out, const std::string&oidstr, unsigned lineno,
+                               std::string_view objtext)
+{
+  auto put_text = [&](void)
+  {
+    out.clear();
+    put_byte(out, Rps_BinStoreSpace::bsrec_text);
+    put_varint(out, oid_index(oidstr));
+    put_varint(out, lineno);
+    put_varint(out, string_index(std::string(objtext)));
+  };
+  /// the dumper emits the opening brace at the start of a line
+  size_t headlen = objtext.find("\n{");
+  if (headlen == std::string_view::npos
+      || objtext.find("\n#") != std::string_view::npos)
+    return put_text();
+  headlen++;
+  Json::Value jobject;
+  try
+    {
+      jobject = rps_load_string_view_to_json(objtext);
+    }
+  catch (const std::exception&)
+    {
+      return put_text();
+    }
+  if (!jobject.isObject()
+      || !jobject["oid"].isString() || jobject["oid"].asString() != oidstr
+      || !jobject["class"].isString()
+      || !rps_binstore_canonical_oid(jobject["class"].asString())
+      || !jobject["mtime"].isDouble()
+      || jobject.isMember("loadrout"))
+    return put_text();
+  if (jobject.isMember("comps") && !jobject["comps"].isArray())
+    return put_text();
+  if (jobject.isMember("attrs"))
+    {
+      const Json::Value& jattrs = jobject["attrs"];
+      if (!jattrs.isArray())
+        return put_text();
+      for (const Json::Value& jent : jattrs)
+        if (!jent.isObject() || jent.size() != 2
+            || !jent["at"].isString()
+            || !rps_binstore_canonical_oid(jent["at"].asString())
+            || !jent.isMember("va"))
+          return put_text();
+    }
+  double mtime = jobject["mtime"].asDouble();
+  std::ostringstream emitout;
+  rps_dump_emit_object_json(emitout, jobject, mtime);
+  std::string emitted = emitout.str();
+  if (objtext.substr(headlen, emitted.size()) != emitted)
+    return put_text();
+  std::string tail(objtext.substr(headlen + emitted.size()));
+  put_byte(out, Rps_BinStoreSpace::bsrec_object);
+  put_varint(out, oid_index(oidstr));
+  put_varint(out, lineno);
+  put_varint(out, string_index(std::string(objtext.substr(0, headlen))));
+  put_varint(out, string_index(tail));
+  put_varint(out, oid_index(jobject["class"].asString()));
+  put_float64(out, mtime);
+  if (jobject.isMember("comps"))
+    {
+      const Json::Value& jcomps = jobject["comps"];
+      put_varint(out, 1+jcomps.size());
+      for (const Json::Value& jcomp : jcomps)
+        put_value(out, jcomp);
+    }
+  else
+    put_varint(out, 0);
+  if (jobject.isMember("attrs"))
+    {
+      const Json::Value& jattrs = jobject["attrs"];
+      put_varint(out, 1+jattrs.size());
+      for (const Json::Value& jent : jattrs)
+        {
+          put_varint(out, oid_index(jent["at"].asString()));
+          put_value(out, jent["va"]);
+        }
+    }
+  else
+    put_varint(out, 0);
+  Json::Value jextra(Json::objectValue);
+  for (const std::string& key : jobject.getMemberNames())
+    if (key != "oid" && key != "class" && key != "mtime"
+        && key != "comps" && key != "attrs")
+      jextra[key] = jobject[key];
+  put_json(out, jextra);
+} // end Rps_BinStoreWriter::put_object
+
+std::string
+Rps_BinStoreWriter::body(const std::string&prolog, const std::vector<std::string>&recvec)
+{
+  unsigned prologix = string_index(prolog);
+  std::string out;
+  put_varint(out, bsw_strings.size());
+  for (const std::string* pstr : bsw_strings)
+    {
+      put_varint(out, pstr->size());
+      out.append(*pstr);
+    }
+  put_varint(out, bsw_oids.size());
+  for (const std::string* poid : bsw_oids)
+    out.append(*poid);
+  put_varint(out, prologix);
+  put_varint(out, recvec.size());
+  for (const std::string& rec : recvec)
+    {
+      put_varint(out, rec.size());
+      out.append(rec);
+    }
+  return out;
+} // end Rps_BinStoreWriter::body
+
+
+////////////////////////////////////////////////////////////////
+//// converters
+////////////////////////////////////////////////////////////////
+
+static bool
+rps_binstore_read_file(const std::string&path, std::string&content,
+                       struct stat*pstat, std::string*perr)
+{
+  int fd = open(path.c_str(), O_RDONLY|O_CLOEXEC);
+  if (fd < 0)
+    {
+      if (perr)
+        *perr = std::string("cannot open ") + path + ":" + strerror(errno);
+      return false;
+    }
+  memset (pstat, 0, sizeof(*pstat));
+  if (fstat(fd, pstat))
+    {
+      if (perr)
+        *perr = std::string("cannot stat ") + path + ":" + strerror(errno);
+      close(fd);
+      return false;
+    }
+  content.resize(pstat->st_size);
+  size_t off = 0;
+  while (off < content.size())
+    {
+      ssize_t nb = read(fd, &content[off], content.size() - off);
+      if (nb <= 0)
+        {
+          if (nb < 0 && errno == EINTR)
+            continue;
+          if (perr)
+            *perr = std::string("cannot read ") + path + ":"
+                    + (nb<0?strerror(errno):"unexpected end of file");
+          close(fd);
+          return false;
+        }
+      off += nb;
+    }
+  close(fd);
+  return true;
+} // end rps_binstore_read_file
+
+/// write CONTENT thru a temporary file renamed as PATH, with MTIMNS
+/// as modification time when positive
+static bool
+rps_binstore_write_file(const std::string&path, const std::string&content,
+                        int64_t mtimns, std::string*perr)
+{
+  char sufbuf[32];
+  memset (sufbuf, 0, sizeof(sufbuf));
+  snprintf (sufbuf, sizeof(sufbuf), "%%%d-tmp", (int)getpid());
+  std::string tmpath = path + sufbuf;
+  FILE* fil = fopen(tmpath.c_str(), "w");
+  if (!fil)
+    {
+      if (perr)
+        *perr = std::string("cannot open ") + tmpath + ":" + strerror(errno);
+      return false;
+    }
+  bool ok = fwrite(content.data(), 1, content.size(), fil) == content.size()
+            && fflush(fil) == 0;
+  if (ok && mtimns > 0)
+    {
+      struct timespec times[2];
+      times[0].tv_sec = 0;
+      times[0].tv_nsec = UTIME_NOW;
+      times[1].tv_sec = mtimns / 1000000000LL;
+      times[1].tv_nsec = mtimns % 1000000000LL;
+      ok = futimens(fileno(fil), times) == 0;
+    }
+  if (fclose(fil))
+    ok = false;
+  if (!ok || rename(tmpath.c_str(), path.c_str()))
+    {
+      if (perr)
+        *perr = std::string("cannot write ") + path + ":" + strerror(errno);
+      (void) remove(tmpath.c_str());
+      return false;
+    }
+  return true;
+} // end rps_binstore_write_file
+
+bool
+rps_binstore_convert_json_to_binary(const std::string&jsonpath,
+                                    const std::string&binpath,
+                                    std::string*perr)
+{
+  std::string jsontext;
+  struct stat jsonstat;
+  if (!rps_binstore_read_file(jsonpath, jsontext, &jsonstat, perr))
+    return false;
+  if (const char*badutf8 = rps_utf8_check(jsontext.data(), jsontext.size()))
+    {
+      if (perr)
+        *perr = std::string("non UTF8 line#")
+                + std::to_string(1 + std::count((const char*)jsontext.data(), badutf8, '\n'))
+                + " in " + jsonpath;
+      return false;
+    }
+  /// split at object starting lines, like the loader does
+  static constexpr char obstart[] = "\n//+ob_";
+  constexpr size_t obstartlen = sizeof(obstart)-1;
+  std::vector<size_t> startvec;
+  if (!jsontext.compare(0, obstartlen-1, obstart+1))
+    startvec.push_back(0);
+  for (size_t pos = jsontext.find(obstart); pos != std::string::npos;
+       pos = jsontext.find(obstart, pos+1))
+    startvec.push_back(pos+1);
+  std::string prolog = jsontext.substr(0, startvec.empty()?jsontext.size():startvec[0]);
+  Rps_BinStoreWriter wr;
+  std::vector<std::string> recvec;
+  recvec.reserve(startvec.size());
+  unsigned lineno = 1 + std::count(prolog.begin(), prolog.end(), '\n');
+  for (unsigned ix=0; ix<startvec.size(); ix++)
+    {
+      size_t start = startvec[ix];
+      size_t end = (ix+1<startvec.size())?startvec[ix+1]:jsontext.size();
+      std::string_view objtext(jsontext.data()+start, end-start);
+      std::string oidstr(objtext.substr(strlen("//+ob"), Rps_Id::nbchars));
+      if (!rps_binstore_canonical_oid(oidstr))
+        {
+          if (perr)
+            *perr = std::string("bad object starting line#")
+                    + std::to_string(lineno) + " in " + jsonpath;
+          return false;
+        }
+      recvec.emplace_back();
+      wr.put_object(recvec.back(), oidstr, lineno, objtext);
+      lineno += std::count(objtext.begin(), objtext.end(), '\n');
+    }
+  std::string body = wr.body(prolog, recvec);
+  std::string bintext;
+  bintext.reserve(rps_binstore_header_size + body.size());
+  bintext.append(RPS_BINSTORE_MAGIC, rps_binstore_magic_size);
+  Rps_BinStoreWriter::put_fixed(bintext, RPS_BINSTORE_VERSION, 4);
+  Rps_BinStoreWriter::put_fixed(bintext, 0, 4);
+  Rps_BinStoreWriter::put_fixed(bintext, jsonstat.st_size, 8);
+  Rps_BinStoreWriter::put_fixed(bintext,
+                                (int64_t)jsonstat.st_mtim.tv_sec * 1000000000LL
+                                + jsonstat.st_mtim.tv_nsec, 8);
+  Rps_BinStoreWriter::put_fixed(bintext, body.size(), 8);
+  Rps_BinStoreWriter::put_fixed(bintext, rps_binstore_checksum(body.data(), body.size()), 8);
+  bintext.append(body);
+  /// the snapshot is useless unless converting it back gives the
+  /// JSON space file, so check that before writing it
+  try
+    {
+      Rps_BinStoreSpace bsp(binpath, bintext);
+      std::string backtext(bsp.prolog());
+      for (unsigned ix=0; ix<bsp.nb_records(); ix++)
+        backtext += bsp.object_text(ix);
+      if (backtext != jsontext)
+        {
+          if (perr)
+            *perr = std::string("binary snapshot of ") + jsonpath
+                    + " does not convert back to it";
+          return false;
+        }
+    }
+  catch (const std::exception&exc)
+    {
+      if (perr)
+        *perr = std::string("binary snapshot of ") + jsonpath
+                + " is unreadable:" + exc.what();
+      return false;
+    }
+  return rps_binstore_write_file(binpath, bintext, 0, perr);
+} // end rps_binstore_convert_json_to_binary
+
+bool
+rps_binstore_convert_binary_to_json(const std::string&binpath,
+                                    const std::string&jsonpath,
+                                    std::string*perr, bool force)
+{
+  std::string bintext;
+  struct stat binstat;
+  if (!rps_binstore_read_file(binpath, bintext, &binstat, perr))
+    return false;
+  std::string jsontext;
+  int64_t jsonmtime = 0;
+  try
+    {
+      Rps_BinStoreSpace bsp(binpath, bintext);
+      jsontext.reserve(bsp.json_size());
+      jsontext.append(bsp.prolog());
+      for (unsigned ix=0; ix<bsp.nb_records(); ix++)
+        jsontext += bsp.object_text(ix);
+      if (jsontext.size() != bsp.json_size())
+        {
+          if (perr)
+            *perr = std::string("unexpected size of JSON converted from ") + binpath;
+          return false;
+        }
+      jsonmtime = bsp.json_mtime();
+      /// an edited or newer JSON space file would be silently lost,
+      /// and replaced by an older one backdated to look fresh
+      if (!force && !access(jsonpath.c_str(), F_OK) && !bsp.is_fresh_for(jsonpath))
+        {
+          if (perr)
+            *perr = jsonpath + " changed since its binary snapshot " + binpath
+                    + ", not overwritten without force-to-json";
+          return false;
+        }
+    }
+  catch (const std::exception&exc)
+    {
+      if (perr)
+        *perr = std::string("bad binary space file ") + binpath + ":" + exc.what();
+      return false;
+    }
+  /// keeping the original modification time keeps the snapshot fresh
+  return rps_binstore_write_file(jsonpath, jsontext, jsonmtime, perr);
+} // end rps_binstore_convert_binary_to_json
+
+int
+rps_binstore_convert_directory(const std::string&dirpath, bool tobinary, bool force)
+{
+  static constexpr char jsonsuffix[] = "-rps.json";
+  static constexpr char binsuffix[] = RPS_BINSTORE_SUFFIX;
+  const char*fromsuffix = tobinary?jsonsuffix:binsuffix;
+  const char*tosuffix = tobinary?binsuffix:jsonsuffix;
+  size_t fromsuflen = strlen(fromsuffix);
+  int nbconv = 0, nbfail = 0;
+  std::vector<std::string> namevec;
+  try
+    {
+      for (auto& ent : std::filesystem::directory_iterator(dirpath))
+        {
+          std::string name = ent.path().filename().string();
+          if (name.size() > fromsuflen + 2 && name[0] == 's' && name[1] == 'p'
+              && !name.compare(name.size()-fromsuflen, fromsuflen, fromsuffix))
+            namevec.push_back(name);
+        }
+    }
+  catch (const std::exception&exc)
+    {
+      RPS_WARNOUT("cannot convert space files in " << dirpath << ": " << exc.what());
+      return 1;
+    }
+  std::sort(namevec.begin(), namevec.end());
+  for (const std::string& name : namevec)
+    {
+      std::string frompath = dirpath + "/" + name;
+      std::string topath = dirpath + "/" + name.substr(0, name.size()-fromsuflen) + tosuffix;
+      std::string errmsg;
+      bool ok = tobinary
+                ? rps_binstore_convert_json_to_binary(frompath, topath, &errmsg)
+                : rps_binstore_convert_binary_to_json(frompath, topath, &errmsg, force);
+      if (ok)
+        {
+          nbconv++;
+          RPS_INFORMOUT("converted " << frompath << " to " << topath);
+        }
+      else
+        {
+          nbfail++;
+          RPS_WARNOUT("failed to convert " << frompath << ": " << errmsg);
+        }
+    }
+  RPS_INFORMOUT("converted " << nbconv << " space files "
+                << (tobinary?"to binary":"to JSON") << " in " << dirpath
+                << " with " << nbfail << " failures");
+  return nbfail;
+} // end rps_binstore_convert_directory
+
+/************************************************************** end of file binstore_rps.cc */
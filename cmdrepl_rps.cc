@@ -197,6 +197,10 @@ rps_full_evaluate_repl_expr(Rps_CallFrame*callframe, Rps_Value exprarg, Rps_Obje
     RPS_REPLEVAL_GIVES_PLAIN(_f.exprv);
   else if (_f.exprv.is_lextoken())
     RPS_REPLEVAL_GIVES_PLAIN(_f.exprv);
+  else if (_f.exprv.is_hamt())
+    RPS_REPLEVAL_GIVES_PLAIN(_f.exprv);
+  else if (_f.exprv.is_doublevect() || _f.exprv.is_intvect())
+    RPS_REPLEVAL_GIVES_PLAIN(_f.exprv);
   else if (_f.exprv.is_instance())
     {
       _f.classob = _f.exprv.compute_class(&_);
@@ -162,6 +162,7 @@ private:
   void write_generated_parser_impl_file(Rps_CallFrame*, Rps_ObjectRef);
   void write_manifest_file(void);
   void write_space_file(Rps_ObjectRef spacobr);
+  void write_binary_space_files(void);
   void scan_object_contents(Rps_ObjectRef obr);
   std::unique_ptr<std::ofstream> open_output_file(const std::string& relpath);
   void rename_opened_files(void);
@@ -381,6 +382,13 @@ Rps_Dumper::json_value(Rps_Value val)
     return Json::Value(Json::nullValue);
   else if (val.is_int())
     return Json::Value(Json::Int64(val.as_int()));
+  else if (val.is_double())
+    return Json::Value(val.as_double());
+  else if (val.is_immediate_string())
+    {
+      char buf[Rps_Value::immediate_string_maxlen+1];
+      return Rps_String::dump_json_cstr(val.string_cstr(buf));
+    }
   else if (val.is_ptr() && is_dumpable_value(val))
     {
       return val.to_ptr()->dump_json(this);
@@ -428,7 +436,8 @@ bool
 Rps_Dumper::is_dumpable_value(const Rps_Value val)
 {
   if (!val) return true;
-  if (val.is_int() || val.is_string() || val.is_set() || val.is_tuple())
+  if (val.is_int() || val.is_double() || val.is_string()
+      || val.is_set() || val.is_tuple())
     return true;
   if (val.is_closure())
     {
@@ -444,6 +453,10 @@ Rps_Dumper::is_dumpable_value(const Rps_Value val)
       else
         return is_dumpable_objref(instv->conn());
     }
+  else if (val.is_hamt()) // non dumpable entries are skipped
+    return true;
+  else if (val.is_doublevect() || val.is_intvect())
+    return true;
   if (val.is_object())
     return is_dumpable_objref(val.to_object());
   RPS_FATALOUT("Rps_Dumper::is_dumpable_value partly unimplemented for " << val);
@@ -487,8 +500,7 @@ Rps_Dumper::scan_source_file_for_constants(const std::string&relfilename)
   for (std::string linbuf; std::getline(ins, linbuf); )
     {
       lincnt++;
-      if (u8_check(reinterpret_cast<const uint8_t*> (linbuf.c_str()),
-                   linbuf.size()))
+      if (rps_utf8_check(linbuf.c_str(), linbuf.size()))
         {
           RPS_WARNOUT("file " << fullpath << ", line " << lincnt
                       << " non UTF8:" << linbuf);
@@ -921,6 +933,8 @@ Rps_Dumper::scan_roots(void)
     rps_dump_scan_object(this,obr);
     nbroots++;
   });
+  for (Rps_ObjectRef obattr : Rps_ObjectZone::attribute_indexes())
+    rps_dump_scan_object(this,obattr);
   RPS_DEBUG_LOG(DUMP, "dumper: scan_roots ends nbroots#" << nbroots);
 } // end Rps_Dumper::scan_roots
 
@@ -1068,6 +1082,29 @@ Rps_Dumper::write_all_space_files(void)
   RPS_INFORMOUT("wrote " << nbspace << " space files into " << du_topdir);
 } // end Rps_Dumper::write_all_space_files
 
+/// with --binary-store, the renamed JSON space files are converted
+/// to binary snapshots; a failure is not fatal since the JSON files
+/// are the canonical state
+void
+Rps_Dumper::write_binary_space_files(void)
+{
+  std::lock_guard<std::recursive_mutex> gu(du_mtx);
+  int nbconv = 0;
+  for (auto it: du_spacemap)
+    {
+      std::string basepath = du_topdir + "/persistore/sp" + it.second->sp_id.to_string();
+      std::string jsonpath = basepath + "-rps.json";
+      std::string binpath = basepath + RPS_BINSTORE_SUFFIX;
+      std::string errmsg;
+      if (rps_binstore_convert_json_to_binary(jsonpath, binpath, &errmsg))
+        nbconv++;
+      else
+        RPS_WARNOUT("dump failed to write binary space " << binpath
+                    << ": " << errmsg);
+    }
+  RPS_INFORMOUT("wrote " << nbconv << " binary space files into " << du_topdir);
+} // end Rps_Dumper::write_binary_space_files
+
 void
 Rps_Dumper::write_generated_roots_file(void)
 {
@@ -1784,6 +1821,14 @@ Rps_Dumper::write_manifest_file(void)
     jmanifest["plugins"] = jplugins;
     RPS_DEBUG_LOG(DUMP, "dumper write_manifest_file wrote " << nbplugins << " plugins.");
   }
+  {
+    Json::Value jattrindexes(Json::arrayValue);
+    for (Rps_ObjectRef obattr : Rps_ObjectZone::attribute_indexes())
+      if (is_dumpable_objref(obattr))
+        jattrindexes.append(Json::Value(obattr->oid().to_string()));
+    if (jattrindexes.size() > 0)
+      jmanifest["attribute_indexes"] = jattrindexes;
+  }
   {
     Json::Value jglobalnames(Json::arrayValue);
     int namecnt = 0;
@@ -1812,6 +1857,59 @@ Rps_Dumper::write_manifest_file(void)
 } // end Rps_Dumper::write_manifest_file
 
 
+void
+rps_dump_emit_object_json(std::ostream&out, const Json::Value&jobject, double mtime)
+{
+  std::string oidstr = jobject["oid"].asString();
+  out << "{" << std::endl;
+  out << " \"oid\": \"" << oidstr << '"' << ',' << std::endl;
+  {
+    char mtimbuf[16];
+    memset (mtimbuf, 0, sizeof(mtimbuf));
+    snprintf (mtimbuf, sizeof(mtimbuf), "%.2f", mtime);
+    out << " \"mtime\": " << mtimbuf << ',' << std::endl;
+  }
+  int countjat = 2; // both oid & mtime have been output
+  int nbjat = jobject.size();
+  Json::Value::Members jmembvec = jobject.getMemberNames();
+  for (const std::string& curmemstr : jmembvec)
+    {
+      const Json::Value& jcurmem = jobject[curmemstr];
+      if (curmemstr != std::string{"oid"}
+          && curmemstr != std::string{"mtime"})
+        {
+          std::ostringstream outmem;
+          outmem << jcurmem << std::flush;
+          std::string outstr = outmem.str();
+          if (!outstr.empty() && outstr[outstr.size()-1] == '\n')
+            {
+              outstr.pop_back();
+            }
+          RPS_DEBUG_LOG(DUMP, "outstr=\"" << Rps_QuotedC_String(outstr)
+                        << "\" for oid=" << oidstr);
+          out << " \"" << curmemstr << "\" : ";
+          int cnt = 0;
+          for (char c : outstr)
+            {
+              if (c=='\n' && cnt>0)
+                {
+                  out << "\n  ";
+                }
+              else
+                out << c;
+              cnt++;
+            }
+          if (countjat+1 < nbjat)
+            out << ',' << std::endl;
+          else
+            out << std::endl;
+          countjat++;
+        }
+    }
+  out << "}";
+} // end rps_dump_emit_object_json
+
+
 void
 Rps_Dumper::write_space_file(Rps_ObjectRef spacobr)
 {
@@ -1923,53 +2021,8 @@ Rps_Dumper::write_space_file(Rps_ObjectRef spacobr)
       Json::Value jobject(Json::objectValue);
       jobject["oid"] = Json::Value (curobr->oid().to_string());
       curobr->dump_json_content(this,jobject);
-      *pouts << "{" << std::endl;
-      *pouts << " \"oid\": \"" << curobr->oid().to_string() << '"' << ',' << std::endl;
-      {
-        double curmtim = curobr->ob_mtime;
-        char mtimbuf[16];
-        memset (mtimbuf, 0, sizeof(mtimbuf));
-        snprintf (mtimbuf, sizeof(mtimbuf), "%.2f", curmtim);
-        *pouts << " \"mtime\": " << mtimbuf << ',' << std::endl;
-      }
-      int countjat = 2; // both oid & mtime have been output
-      int nbjat = jobject.size();
-      Json::Value::Members jmembvec = jobject.getMemberNames();
-      for (const std::string& curmemstr : jmembvec)
-        {
-          const Json::Value& jcurmem = jobject[curmemstr];
-          if (curmemstr != std::string{"oid"}
-              && curmemstr != std::string{"mtime"})
-            {
-              std::ostringstream outmem;
-              outmem << jcurmem << std::flush;
-              std::string outstr = outmem.str();
-              if (!outstr.empty() && outstr[outstr.size()-1] == '\n')
-                {
-                  outstr.pop_back();
-                }
-              RPS_DEBUG_LOG(DUMP, "outstr=\"" << Rps_QuotedC_String(outstr)
-                            << "\" for oid=" << curobr->oid().to_string());
-              *pouts << " \"" << curmemstr << "\" : ";
-              int cnt = 0;
-              for (char c : outstr)
-                {
-                  if (c=='\n' && cnt>0)
-                    {
-                      *pouts << "\n  ";
-                    }
-                  else
-                    *pouts << c;
-                  cnt++;
-                }
-              if (countjat+1 < nbjat)
-                *pouts << ',' << std::endl;
-              else
-                *pouts << std::endl;
-              countjat++;
-            }
-        }
-      *pouts << "}" << std::endl;
+      rps_dump_emit_object_json(*pouts, jobject, curobr->ob_mtime);
+      *pouts << std::endl;
       *pouts << "//-ob" << curobr->oid().to_string();
       if (!namestr.empty())
         *pouts << ":" << namestr;
@@ -2016,6 +2069,8 @@ void rps_dump_into (std::string dirpath, Rps_CallFrame* callframe)
   RPS_DEBUG_LOG(DUMP, "rps_dump_into start dirpath=" << dirpath
                 << std::endl
                 << RPS_FULL_BACKTRACE(1, "rps_dump_into"));
+  if (rps_check_heap_before_dump)
+    Rps_ObjectZone::check_heap_integrity(rps_nbjobs);
   if (dirpath.empty())
     dirpath = std::string(".");
   int lendirpath = dirpath.size();
@@ -2149,6 +2204,8 @@ void rps_dump_into (std::string dirpath, Rps_CallFrame* callframe)
       dumper.write_manifest_file();
       RPS_UNIQUE_BREAKPOINT();
       dumper.rename_opened_files();
+      if (rps_binary_store)
+        dumper.write_binary_space_files();
       sync();
       RPS_UNIQUE_BREAKPOINT();
       double endelapsed = rps_elapsed_real_time();
@@ -188,6 +188,8 @@ rps_garbage_collect (std::function<void(Rps_GarbageCollector*)>* pfun)
   if (verbgc)
     RPS_INFORM("rps_garbage_collect before run; count#%ld",
                gcnt);
+  /// the thread materializing lazily loaded objects waits meanwhile
+  std::lock_guard<std::mutex> gulazy(rps_load_lazy_mutex);
   Rps_GarbageCollector the_gc([=](Rps_GarbageCollector*gc)
   {
     if (pfun)
@@ -201,6 +203,9 @@ rps_garbage_collect (std::function<void(Rps_GarbageCollector*)>* pfun)
                gcnt, (long) nbroots, (long)(the_gc.nb_scans()),
                (long)(the_gc.nb_marks()),  (long)(the_gc.nb_deletions()),
                the_gc.elapsed_time(), the_gc.process_time());
+  if (verbgc && Rps_InternTable::enabled())
+    RPS_INFORM("rps_garbage_collect keeps %ld interned values, %ld intern hits",
+               (long) Rps_InternTable::size(), (long) Rps_InternTable::nb_hits());
 } // end of rps_garbage_collect
 
 void
@@ -265,6 +270,8 @@ Rps_GarbageCollector::run_gc(void)
     Rps_QuasiZone::clear_all_gcmarks(gc);
     gc.mark_gcroots();
     Rps_PayloadSymbol::gc_mark_strong_symbols(&gc);
+    Rps_ObjectZone::gc_mark_attribute_indexes(&gc);
+    rps_load_gc_mark_lazy(&gc);
     while (!gc.gc_obscanque.empty())
       {
         auto obfront = gc.gc_obscanque.front();
@@ -273,6 +280,7 @@ Rps_GarbageCollector::run_gc(void)
         obfront->mark_gc_inside(gc);
         gc.gc_nbscan++;
       };
+    Rps_InternTable::gc_remove_unmarked(gc);
   });
   Rps_QuasiZone::every_zone
   (*this,
@@ -849,8 +849,8 @@ rps_gccjit_initialize_tmpdir(const char*tempdir)
 void
 rps_gccjit_initialize(void)
 {
-  ///called from main
-  RPS_ASSERT(rps_is_main_thread());
+  ///called once from main, in a thread overlapping the load; it
+  ///does not use the heap
   RPS_DEBUG_LOG(REPL, "rps_gccjit_initialize-d" << std::endl
                 << RPS_FULL_BACKTRACE(1, "rps_gccjit_initialize"));
   RPS_ASSERT(rps_gccjit_tmp_dirpath[0] == 0);
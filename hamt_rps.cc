@@ -0,0 +1,584 @@
+/****************************************************************
+ * file hamt_rps.cc
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * Description:
+ *      This file is part of the Reflective Persistent System.
+ *
+ *      It has the code of persistent hash array mapped tries, that is
+ *      immutable maps from values to values sharing their structure
+ *      between successive versions.
+ *
+ * Author(s):
+ *      Basile Starynkevitch, France    <basile@starynkevitch.net>
+ *      Niklas Rozencrantz, Sweden     <niklasr@protonmail.com>
+ *
+ *      © Copyright (C) 2026 The Reflective Persistent System Team
+ *      team@refpersys.org & http://refpersys.org/
+ *
+ * License:
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#include "refpersys.hh"
+
+
+
+extern "C" const char rps_hamt_gitid[];
+const char rps_hamt_gitid[]= RPS_GITID;
+
+
+extern "C" const char rps_hamt_shortgitid[];
+const char rps_hamt_shortgitid[]= RPS_SHORTGITID;
+
+
+extern "C" const char rps_hamt_basename[];
+const char rps_hamt_basename[]= RPS_BASENAME;
+
+extern "C" const char rps_hamt_baseid[];
+const char rps_hamt_baseid[]= RPS_BASEID;
+
+
+Rps_HamtZone*
+Rps_HamtZone::allocate_node(unsigned shift,
+                            std::uint32_t datamap, std::uint32_t nodemap,
+                            unsigned nbdata, unsigned nbnodes,
+                            unsigned count)
+{
+  RPS_ASSERT(count < maxsize);
+  RPS_ASSERT(shift <= hamt_collision_shift + hamt_bits);
+  unsigned nbslots = 2*nbdata + nbnodes;
+  return Rps_QuasiZone::rps_allocate_with_wordgap
+         <Rps_HamtZone,unsigned,std::uint32_t,std::uint32_t,unsigned,unsigned,unsigned>
+         ((nbslots*sizeof(Rps_Value))/sizeof(void*),
+          shift, datamap, nodemap, nbdata, nbnodes, count);
+} // end Rps_HamtZone::allocate_node
+
+
+const Rps_HamtZone*
+Rps_HamtZone::make_empty(void)
+{
+  return allocate_node(0, 0, 0, 0, 0, 0);
+} // end Rps_HamtZone::make_empty
+
+
+const Rps_HamtZone*
+Rps_HamtZone::make(const std::map<Rps_Value,Rps_Value>& mapv)
+{
+  const Rps_HamtZone* hz = make_empty();
+  for (auto it: mapv)
+    if (it.first && it.second)
+      hz = hz->put(it.first, it.second);
+  return hz;
+} // end Rps_HamtZone::make from std::map
+
+
+const Rps_HamtZone*
+Rps_HamtZone::make(const std::initializer_list<std::pair<Rps_Value,Rps_Value>>& il)
+{
+  const Rps_HamtZone* hz = make_empty();
+  for (auto it: il)
+    if (it.first && it.second)
+      hz = hz->put(it.first, it.second);
+  return hz;
+} // end Rps_HamtZone::make from initializer list
+
+
+/// make a node of the given shift containing only two entries of
+/// different keys, going down while their hash fragments are the same
+const Rps_HamtZone*
+Rps_HamtZone::make_pair_node(unsigned shift,
+                             Rps_Value key1, Rps_Value val1, Rps_HashInt h1,
+                             Rps_Value key2, Rps_Value val2, Rps_HashInt h2)
+{
+  if (shift >= hamt_collision_shift)
+    {
+      Rps_HamtZone* nd = allocate_node(shift, 0, 0, 2, 0, 2);
+      nd->_hamt_slots[0] = key1;
+      nd->_hamt_slots[1] = val1;
+      nd->_hamt_slots[2] = key2;
+      nd->_hamt_slots[3] = val2;
+      return nd;
+    };
+  unsigned frag1 = fragment(h1, shift);
+  unsigned frag2 = fragment(h2, shift);
+  if (frag1 == frag2)
+    {
+      const Rps_HamtZone* sub
+        = make_pair_node(shift+hamt_bits, key1, val1, h1, key2, val2, h2);
+      Rps_HamtZone* nd = allocate_node(shift, 0, 1U<<frag1, 0, 1, 2);
+      nd->_hamt_slots[0] = Rps_Value(sub);
+      return nd;
+    };
+  Rps_HamtZone* nd = allocate_node(shift, (1U<<frag1)|(1U<<frag2), 0, 2, 0, 2);
+  if (frag1 > frag2)
+    {
+      std::swap(key1, key2);
+      std::swap(val1, val2);
+    };
+  nd->_hamt_slots[0] = key1;
+  nd->_hamt_slots[1] = val1;
+  nd->_hamt_slots[2] = key2;
+  nd->_hamt_slots[3] = val2;
+  return nd;
+} // end Rps_HamtZone::make_pair_node
+
+
+Rps_Value
+Rps_HamtZone::find(Rps_Value key) const
+{
+  if (!key || _hamt_count == 0)
+    return Rps_Value(nullptr);
+  return find_hashed(key, key.valhash());
+} // end Rps_HamtZone::find
+
+
+Rps_Value
+Rps_HamtZone::find_hashed(Rps_Value key, Rps_HashInt h) const
+{
+  const Rps_HamtZone* nd = this;
+  for (;;)
+    {
+      if (nd->is_collision_node())
+        {
+          for (unsigned ix=0; ix<nd->_hamt_nbdata; ix++)
+            if (nd->data_key(ix) == key)
+              return nd->data_val(ix);
+          return Rps_Value(nullptr);
+        };
+      std::uint32_t bit = 1U << fragment(h, nd->_hamt_shift);
+      if (nd->_hamt_datamap & bit)
+        {
+          unsigned ix = bitindex(nd->_hamt_datamap, bit);
+          if (nd->data_key(ix) == key)
+            return nd->data_val(ix);
+          return Rps_Value(nullptr);
+        }
+      else if (nd->_hamt_nodemap & bit)
+        nd = nd->subnode(bitindex(nd->_hamt_nodemap, bit));
+      else
+        return Rps_Value(nullptr);
+    }
+} // end Rps_HamtZone::find_hashed
+
+
+const Rps_HamtZone*
+Rps_HamtZone::put(Rps_Value key, Rps_Value val) const
+{
+  RPS_ASSERT(_hamt_shift == 0);
+  if (!key)
+    throw std::invalid_argument("Rps_HamtZone::put with empty key");
+  if (!val)
+    return remove(key);
+  return put_hashed(key, val, key.valhash());
+} // end Rps_HamtZone::put
+
+
+const Rps_HamtZone*
+Rps_HamtZone::put_hashed(Rps_Value key, Rps_Value val, Rps_HashInt h) const
+{
+  unsigned nbslots = 2*_hamt_nbdata + _hamt_nbnodes;
+  if (is_collision_node())
+    {
+      for (unsigned ix=0; ix<_hamt_nbdata; ix++)
+        if (data_key(ix) == key)
+          {
+            if (data_val(ix) == val)
+              return this;
+            Rps_HamtZone* nd = allocate_node(_hamt_shift, 0, 0,
+                                             _hamt_nbdata, 0, _hamt_count);
+            for (unsigned sx=0; sx<nbslots; sx++)
+              nd->_hamt_slots[sx] = _hamt_slots[sx];
+            nd->_hamt_slots[2*ix+1] = val;
+            return nd;
+          };
+      Rps_HamtZone* nd = allocate_node(_hamt_shift, 0, 0,
+                                       _hamt_nbdata+1, 0, _hamt_count+1);
+      for (unsigned sx=0; sx<nbslots; sx++)
+        nd->_hamt_slots[sx] = _hamt_slots[sx];
+      nd->_hamt_slots[nbslots] = key;
+      nd->_hamt_slots[nbslots+1] = val;
+      return nd;
+    };
+  std::uint32_t bit = 1U << fragment(h, _hamt_shift);
+  if (_hamt_datamap & bit)
+    {
+      unsigned ix = bitindex(_hamt_datamap, bit);
+      Rps_Value oldkey = data_key(ix);
+      if (oldkey == key)
+        {
+          if (data_val(ix) == val)
+            return this;
+          Rps_HamtZone* nd = allocate_node(_hamt_shift, _hamt_datamap, _hamt_nodemap,
+                                           _hamt_nbdata, _hamt_nbnodes, _hamt_count);
+          for (unsigned sx=0; sx<nbslots; sx++)
+            nd->_hamt_slots[sx] = _hamt_slots[sx];
+          nd->_hamt_slots[2*ix+1] = val;
+          return nd;
+        };
+      /// both entries are moved into a new subnode
+      const Rps_HamtZone* sub
+        = make_pair_node(_hamt_shift+hamt_bits,
+                         oldkey, data_val(ix), oldkey.valhash(),
+                         key, val, h);
+      std::uint32_t newnodemap = _hamt_nodemap | bit;
+      unsigned nix = bitindex(newnodemap, bit);
+      Rps_HamtZone* nd = allocate_node(_hamt_shift, _hamt_datamap & ~bit, newnodemap,
+                                       _hamt_nbdata-1, _hamt_nbnodes+1, _hamt_count+1);
+      unsigned dx = 0;
+      for (unsigned ox=0; ox<_hamt_nbdata; ox++)
+        {
+          if (ox == ix)
+            continue;
+          nd->_hamt_slots[2*dx] = data_key(ox);
+          nd->_hamt_slots[2*dx+1] = data_val(ox);
+          dx++;
+        };
+      Rps_Value* newnodes = nd->_hamt_slots + 2*nd->_hamt_nbdata;
+      const Rps_Value* oldnodes = _hamt_slots + 2*_hamt_nbdata;
+      for (unsigned ox=0; ox<nix; ox++)
+        newnodes[ox] = oldnodes[ox];
+      newnodes[nix] = Rps_Value(sub);
+      for (unsigned ox=nix; ox<_hamt_nbnodes; ox++)
+        newnodes[ox+1] = oldnodes[ox];
+      return nd;
+    }
+  else if (_hamt_nodemap & bit)
+    {
+      unsigned nix = bitindex(_hamt_nodemap, bit);
+      const Rps_HamtZone* oldsub = subnode(nix);
+      const Rps_HamtZone* newsub = oldsub->put_hashed(key, val, h);
+      if (newsub == oldsub)
+        return this;
+      Rps_HamtZone* nd = allocate_node(_hamt_shift, _hamt_datamap, _hamt_nodemap,
+                                       _hamt_nbdata, _hamt_nbnodes,
+                                       _hamt_count - oldsub->_hamt_count
+                                       + newsub->_hamt_count);
+      for (unsigned sx=0; sx<nbslots; sx++)
+        nd->_hamt_slots[sx] = _hamt_slots[sx];
+      nd->_hamt_slots[2*_hamt_nbdata+nix] = Rps_Value(newsub);
+      return nd;
+    }
+  else
+    {
+      std::uint32_t newdatamap = _hamt_datamap | bit;
+      unsigned ix = bitindex(newdatamap, bit);
+      Rps_HamtZone* nd = allocate_node(_hamt_shift, newdatamap, _hamt_nodemap,
+                                       _hamt_nbdata+1, _hamt_nbnodes, _hamt_count+1);
+      for (unsigned sx=0; sx<2*ix; sx++)
+        nd->_hamt_slots[sx] = _hamt_slots[sx];
+      nd->_hamt_slots[2*ix] = key;
+      nd->_hamt_slots[2*ix+1] = val;
+      for (unsigned sx=2*ix; sx<nbslots; sx++)
+        nd->_hamt_slots[sx+2] = _hamt_slots[sx];
+      return nd;
+    }
+} // end Rps_HamtZone::put_hashed
+
+
+const Rps_HamtZone*
+Rps_HamtZone::remove(Rps_Value key) const
+{
+  RPS_ASSERT(_hamt_shift == 0);
+  if (!key || _hamt_count == 0)
+    return this;
+  return remove_hashed(key, key.valhash());
+} // end Rps_HamtZone::remove
+
+
+const Rps_HamtZone*
+Rps_HamtZone::remove_hashed(Rps_Value key, Rps_HashInt h) const
+{
+  unsigned nbslots = 2*_hamt_nbdata + _hamt_nbnodes;
+  if (is_collision_node())
+    {
+      for (unsigned ix=0; ix<_hamt_nbdata; ix++)
+        if (data_key(ix) == key)
+          {
+            /// a collision node always keeps at least one entry, and
+            /// is inlined by its parent when it has only one
+            RPS_ASSERT(_hamt_nbdata >= 2);
+            Rps_HamtZone* nd = allocate_node(_hamt_shift, 0, 0,
+                                             _hamt_nbdata-1, 0, _hamt_count-1);
+            unsigned dx = 0;
+            for (unsigned ox=0; ox<_hamt_nbdata; ox++)
+              {
+                if (ox == ix)
+                  continue;
+                nd->_hamt_slots[2*dx] = data_key(ox);
+                nd->_hamt_slots[2*dx+1] = data_val(ox);
+                dx++;
+              };
+            return nd;
+          };
+      return this;
+    };
+  std::uint32_t bit = 1U << fragment(h, _hamt_shift);
+  if (_hamt_datamap & bit)
+    {
+      unsigned ix = bitindex(_hamt_datamap, bit);
+      if (!(data_key(ix) == key))
+        return this;
+      Rps_HamtZone* nd = allocate_node(_hamt_shift, _hamt_datamap & ~bit, _hamt_nodemap,
+                                       _hamt_nbdata-1, _hamt_nbnodes, _hamt_count-1);
+      for (unsigned sx=0; sx<2*ix; sx++)
+        nd->_hamt_slots[sx] = _hamt_slots[sx];
+      for (unsigned sx=2*ix+2; sx<nbslots; sx++)
+        nd->_hamt_slots[sx-2] = _hamt_slots[sx];
+      return nd;
+    }
+  else if (_hamt_nodemap & bit)
+    {
+      unsigned nix = bitindex(_hamt_nodemap, bit);
+      const Rps_HamtZone* oldsub = subnode(nix);
+      const Rps_HamtZone* newsub = oldsub->remove_hashed(key, h);
+      if (newsub == oldsub)
+        return this;
+      if (newsub->_hamt_count == 1 && newsub->_hamt_nbnodes == 0)
+        {
+          /// keep the trie canonical: a single remaining entry is
+          /// inlined here instead of its subnode
+          std::uint32_t newdatamap = _hamt_datamap | bit;
+          unsigned ix = bitindex(newdatamap, bit);
+          Rps_HamtZone* nd = allocate_node(_hamt_shift, newdatamap, _hamt_nodemap & ~bit,
+                                           _hamt_nbdata+1, _hamt_nbnodes-1,
+                                           _hamt_count-1);
+          for (unsigned sx=0; sx<2*ix; sx++)
+            nd->_hamt_slots[sx] = _hamt_slots[sx];
+          nd->_hamt_slots[2*ix] = newsub->data_key(0);
+          nd->_hamt_slots[2*ix+1] = newsub->data_val(0);
+          for (unsigned sx=2*ix; sx<2*_hamt_nbdata; sx++)
+            nd->_hamt_slots[sx+2] = _hamt_slots[sx];
+          Rps_Value* newnodes = nd->_hamt_slots + 2*nd->_hamt_nbdata;
+          const Rps_Value* oldnodes = _hamt_slots + 2*_hamt_nbdata;
+          unsigned dx = 0;
+          for (unsigned ox=0; ox<_hamt_nbnodes; ox++)
+            if (ox != nix)
+              newnodes[dx++] = oldnodes[ox];
+          return nd;
+        };
+      Rps_HamtZone* nd = allocate_node(_hamt_shift, _hamt_datamap, _hamt_nodemap,
+                                       _hamt_nbdata, _hamt_nbnodes, _hamt_count-1);
+      for (unsigned sx=0; sx<nbslots; sx++)
+        nd->_hamt_slots[sx] = _hamt_slots[sx];
+      nd->_hamt_slots[2*_hamt_nbdata+nix] = Rps_Value(newsub);
+      return nd;
+    }
+  else
+    return this;
+} // end Rps_HamtZone::remove_hashed
+
+
+bool
+Rps_HamtZone::each_entry(const std::function<bool(Rps_Value,Rps_Value)>&fun) const
+{
+  for (unsigned ix=0; ix<_hamt_nbdata; ix++)
+    if (fun(data_key(ix), data_val(ix)))
+      return true;
+  for (unsigned nix=0; nix<_hamt_nbnodes; nix++)
+    if (subnode(nix)->each_entry(fun))
+      return true;
+  return false;
+} // end Rps_HamtZone::each_entry
+
+
+std::vector<std::pair<Rps_Value,Rps_Value>>
+    Rps_HamtZone::sorted_entries(void) const
+{
+  std::vector<std::pair<Rps_Value,Rps_Value>> vecent;
+  vecent.reserve(_hamt_count);
+  each_entry([&](Rps_Value key, Rps_Value val)
+  {
+    vecent.push_back({key,val});
+    return false;
+  });
+  std::sort(vecent.begin(), vecent.end(),
+            [](const std::pair<Rps_Value,Rps_Value>&e1,
+               const std::pair<Rps_Value,Rps_Value>&e2)
+  {
+    return Rps_Value::compare_total(e1.first, e2.first) < 0;
+  });
+  return vecent;
+} // end Rps_HamtZone::sorted_entries
+
+
+/// the hash does not depend upon the shape of the trie, so should be
+/// the same for equal maps built in different orders
+Rps_HashInt
+Rps_HamtZone::compute_hash(void) const
+{
+  std::uint64_t h1 = _hamt_count, h2 = 0;
+  each_entry([&](Rps_Value key, Rps_Value val)
+  {
+    std::uint64_t hk = key.valhash();
+    std::uint64_t hv = val.valhash();
+    h1 += hk*31 + hv*17;
+    h2 ^= (hk*hamt_width+1) * (hv|1);
+    return false;
+  });
+  Rps_HashInt h = (h1 * 13151) ^ (h2 * 13291) ^ (h2 >> 32);
+  if (RPS_UNLIKELY(h==0))
+    h = (h1&0xffff) + (h2&0xfffff) + 17;
+  return h;
+} // end Rps_HamtZone::compute_hash
+
+
+Rps_ObjectRef
+Rps_HamtZone::compute_class(Rps_CallFrame*stkf __attribute__((unused))) const
+{
+  /// no specific root class for HAMTs yet
+  return RPS_ROOT_OB(_6XLY6QfcDre02922jz); //value∈class
+} // end Rps_HamtZone::compute_class
+
+
+void
+Rps_HamtZone::gc_mark(Rps_GarbageCollector&gc, unsigned depth) const
+{
+  for (unsigned ix=0; ix<_hamt_nbdata; ix++)
+    {
+      gc.mark_value(data_key(ix), depth+1);
+      gc.mark_value(data_val(ix), depth+1);
+    };
+  for (unsigned nix=0; nix<_hamt_nbnodes; nix++)
+    gc.mark_value(_hamt_slots[2*_hamt_nbdata+nix], depth+1);
+} // end Rps_HamtZone::gc_mark
+
+
+void
+Rps_HamtZone::dump_scan(Rps_Dumper*du, unsigned depth) const
+{
+  RPS_ASSERT(du != nullptr);
+  each_entry([&](Rps_Value key, Rps_Value val)
+  {
+    rps_dump_scan_value(du, key, depth+1);
+    rps_dump_scan_value(du, val, depth+1);
+    return false;
+  });
+} // end Rps_HamtZone::dump_scan
+
+
+/// dumped as {"vtype":"hamt","entries":[{"hk":key,"hv":val},...]}
+/// with entries sorted by keys, so the dump is deterministic
+Json::Value
+Rps_HamtZone::dump_json(Rps_Dumper*du) const
+{
+  RPS_ASSERT(du != nullptr);
+  RPS_ASSERT(_hamt_shift == 0);
+  Json::Value jv(Json::objectValue);
+  jv["vtype"] = "hamt";
+  Json::Value jentries(Json::arrayValue);
+  for (auto ent: sorted_entries())
+    {
+      if (!rps_is_dumpable_value(du, ent.first)
+          || !rps_is_dumpable_value(du, ent.second))
+        continue;
+      Json::Value jent(Json::objectValue);
+      jent["hk"] = rps_dump_json_value(du, ent.first);
+      jent["hv"] = rps_dump_json_value(du, ent.second);
+      jentries.append(jent);
+    };
+  jv["entries"] = jentries;
+  return jv;
+} // end Rps_HamtZone::dump_json
+
+
+const Rps_HamtZone*
+Rps_HamtZone::load_from_json(Rps_Loader*ld, const Json::Value& jv)
+{
+  RPS_ASSERT(ld != nullptr);
+  if (!jv.isObject() || !jv.isMember("entries") || !jv["entries"].isArray())
+    throw RPS_RUNTIME_ERROR_OUT("Rps_HamtZone::load_from_json bad jv=" << jv);
+  const Json::Value& jentries = jv["entries"];
+  const Rps_HamtZone* hz = make_empty();
+  unsigned nbent = jentries.size();
+  for (unsigned ix=0; ix<nbent; ix++)
+    {
+      const Json::Value& jent = jentries[ix];
+      Rps_Value key(jent["hk"], ld);
+      Rps_Value val(jent["hv"], ld);
+      if (key && val)
+        hz = hz->put(key, val);
+    };
+  return hz;
+} // end Rps_HamtZone::load_from_json
+
+
+void
+Rps_HamtZone::val_output(std::ostream& outs, unsigned depth, unsigned maxdepth) const
+{
+  outs << "{hamt/" << _hamt_count;
+  if (depth > maxdepth)
+    {
+      outs << "...}";
+      return;
+    };
+  int cnt = 0;
+  for (auto ent: sorted_entries())
+    {
+      outs << ((cnt>0)?", ":" ");
+      if (cnt>0 && cnt % 4 == 0)
+        outs << std::endl;
+      ent.first.output(outs, depth+1, maxdepth);
+      outs << "↦";
+      ent.second.output(outs, depth+1, maxdepth);
+      cnt++;
+    };
+  outs << "}";
+} // end Rps_HamtZone::val_output
+
+
+bool
+Rps_HamtZone::equal(const Rps_ZoneValue&zv) const
+{
+  if (zv.stored_type() != Rps_Type::Hamt)
+    return false;
+  auto othz = reinterpret_cast<const Rps_HamtZone*>(&zv);
+  if (othz == this)
+    return true;
+  if (_hamt_count != othz->_hamt_count)
+    return false;
+  auto lh = lazy_hash();
+  auto othlh = othz->lazy_hash();
+  if (lh != 0 && othlh != 0 && lh != othlh)
+    return false;
+  return !each_entry([&](Rps_Value key, Rps_Value val)
+  {
+    return !(othz->find(key) == val);
+  });
+} // end Rps_HamtZone::equal
+
+
+bool
+Rps_HamtZone::less(const Rps_ZoneValue&zv) const
+{
+  if (zv.stored_type() != Rps_Type::Hamt)
+    return Rps_Type::Hamt < zv.stored_type();
+  auto othz = reinterpret_cast<const Rps_HamtZone*>(&zv);
+  if (othz == this)
+    return false;
+  if (_hamt_count != othz->_hamt_count)
+    return _hamt_count < othz->_hamt_count;
+  auto myentries = sorted_entries();
+  auto othentries = othz->sorted_entries();
+  for (unsigned ix=0; ix<_hamt_count; ix++)
+    {
+      int cmp = Rps_Value::compare_total(myentries[ix].first, othentries[ix].first);
+      if (cmp == 0)
+        cmp = Rps_Value::compare_total(myentries[ix].second, othentries[ix].second);
+      if (cmp != 0)
+        return cmp < 0;
+    };
+  return false;
+} // end Rps_HamtZone::less
+
+/************************************************************** end of file hamt_rps.cc */
@@ -189,6 +189,101 @@ bool Rps_Value::is_int() const
   return (_ival & 1) != 0;
 };
 
+bool Rps_Value::is_immediate_double() const
+{
+  return (_ival & immediate_tag_mask) == immediate_double_tag;
+};
+
+bool Rps_Value::is_immediate_string() const
+{
+  return (_ival & immediate_tag_mask) == immediate_string_tag;
+};
+
+bool
+Rps_Value::encode_immediate_string(const char*cstr, int len, intptr_t&enc)
+{
+  static_assert(sizeof(intptr_t) == 8);
+  if (cstr == nullptr || cstr == (const char*)RPS_EMPTYSLOT || !*cstr)
+    len = 0;
+  else if (len < 0)
+    len = strnlen(cstr, immediate_string_maxlen+1);
+  if (len > (int)immediate_string_maxlen)
+    return false;
+  uint64_t w = immediate_string_tag | (len << 3);
+  for (int ix=0; ix<len; ix++)
+    {
+      uint8_t c = (uint8_t)cstr[ix];
+      if (c == 0)
+        return false;
+      w |= ((uint64_t)c) << (8*(ix+1));
+    };
+  if (len > 0 && rps_utf8_check(cstr, len))
+    return false;
+  enc = (intptr_t)w;
+  return true;
+} // end Rps_Value::encode_immediate_string
+
+Rps_Value
+Rps_Value::make_string(const char*cstr, int len)
+{
+  Rps_Value res;
+  if (encode_immediate_string(cstr, len, res._ival))
+    return res;
+  return Rps_Value(Rps_String::make(cstr, len), Rps_ValPtrTag{});
+} // end Rps_Value::make_string
+
+const char*
+Rps_Value::string_cstr(char buf[immediate_string_maxlen+1]) const
+{
+  if (is_immediate_string())
+    {
+      uint64_t w = (uint64_t)_ival;
+      unsigned len = (w >> 3) & 7;
+      for (unsigned ix=0; ix<len; ix++)
+        buf[ix] = (char)((w >> (8*(ix+1))) & 0xff);
+      buf[len] = (char)0;
+      return buf;
+    }
+  else if (is_string())
+    return reinterpret_cast<const Rps_String*>(_pval)->cstr();
+  return nullptr;
+} // end Rps_Value::string_cstr
+
+/// the biased exponents of immediate doubles are above this offset
+/// and at most 255 more, see comment in class Rps_Value
+#define RPS_IMMEDIATE_DOUBLE_EXPONENT_OFFSET 896
+
+bool
+Rps_Value::encode_immediate_double(double d, intptr_t&enc)
+{
+  uint64_t bits = 0;
+  memcpy(&bits, &d, sizeof(bits));
+  // rotate left by one, to move the sign bit into bit 0
+  uint64_t rot = (bits << 1) | (bits >> 63);
+  if (rot > 1)   // non zero
+    {
+      unsigned bexp = (unsigned)(bits >> 52) & 0x7ff;
+      if (bexp <= RPS_IMMEDIATE_DOUBLE_EXPONENT_OFFSET
+          || bexp > RPS_IMMEDIATE_DOUBLE_EXPONENT_OFFSET + 255)
+        return false;
+      rot -= ((uint64_t)RPS_IMMEDIATE_DOUBLE_EXPONENT_OFFSET) << 53;
+    };
+  enc = (intptr_t)((rot << 3) | immediate_double_tag);
+  return true;
+} // end Rps_Value::encode_immediate_double
+
+double
+Rps_Value::decode_immediate_double(intptr_t enc)
+{
+  uint64_t rot = ((uint64_t)enc) >> 3;
+  if (rot > 1)
+    rot += ((uint64_t)RPS_IMMEDIATE_DOUBLE_EXPONENT_OFFSET) << 53;
+  uint64_t bits = (rot >> 1) | (rot << 63);
+  double d = 0.0;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+} // end Rps_Value::decode_immediate_double
+
 bool Rps_Value::is_ptr() const
 {
   return !is_int()
@@ -204,6 +299,10 @@ Rps_Value::type() const
     return Rps_Type::Int;
   else if (is_empty())
     return Rps_Type::None;
+  else if (is_immediate_double())
+    return Rps_Type::Double;
+  else if (is_immediate_string())
+    return Rps_Type::String;
   else
     return _pval->type();
 } // end Rps_Value::type()
@@ -260,6 +359,14 @@ Rps_Value::output(std::ostream&out, unsigned depth, unsigned maxdepth) const
     out << as_int();
   else if (is_empty())
     out << "__";
+  else if (is_immediate_double())
+    Rps_Double::output_double(out, decode_immediate_double(_ival));
+  else if (is_immediate_string())
+    {
+      char buf[immediate_string_maxlen+1];
+      Json::Value jstr(string_cstr(buf));
+      out << jstr;
+    }
   else if (is_ptr())
     {
       if (depth > maxdepth)
@@ -305,6 +412,14 @@ Rps_Value::valhash() const noexcept
       RPS_ASSERT(h != 0);
       return h;
     }
+  else if (is_immediate_double())
+    return Rps_Double::hash_double(decode_immediate_double(_ival));
+  else if (is_immediate_string())
+    {
+      // same hash as the boxed Rps_String
+      char buf[immediate_string_maxlen+1];
+      return rps_hash_cstr(string_cstr(buf));
+    }
   else if (is_ptr())
     {
       const Rps_ZoneValue*pval = as_ptr();
@@ -351,16 +466,36 @@ bool Rps_Value::is_lextoken() const
          && as_ptr()->stored_type() == Rps_Type::LexToken;
 } //end  Rps_Value::is_lextoken()
 
-bool Rps_Value::is_string() const
+bool Rps_Value::is_hamt() const
+{
+  return is_ptr()
+         && as_ptr()->stored_type() == Rps_Type::Hamt;
+} //end  Rps_Value::is_hamt()
+
+bool Rps_Value::is_doublevect() const
+{
+  return is_ptr()
+         && as_ptr()->stored_type() == Rps_Type::DoubleVect;
+} //end  Rps_Value::is_doublevect()
+
+bool Rps_Value::is_intvect() const
 {
   return is_ptr()
-         && as_ptr()->stored_type() == Rps_Type::String;
+         && as_ptr()->stored_type() == Rps_Type::IntVect;
+} //end  Rps_Value::is_intvect()
+
+bool Rps_Value::is_string() const
+{
+  return is_immediate_string()
+         || (is_ptr()
+             && as_ptr()->stored_type() == Rps_Type::String);
 } //end  Rps_Value::is_string()
 
 bool Rps_Value::is_double() const
 {
-  return is_ptr()
-         && as_ptr()->stored_type() == Rps_Type::Double;
+  return is_immediate_double()
+         || (is_ptr()
+             && as_ptr()->stored_type() == Rps_Type::Double);
 } //end  Rps_Value::is_double()
 
 bool Rps_Value::is_json() const
@@ -414,6 +549,55 @@ Rps_Value::as_json() const
 } // end Rps_Value::as_json
 
 
+const Rps_HamtZone*
+Rps_Value::as_hamt() const
+{
+  if (is_hamt())
+    return reinterpret_cast<const Rps_HamtZone*>(_pval);
+  else throw std::domain_error("Rps_Value::as_hamt: value is not genuine hamt");
+} // end Rps_Value::as_hamt
+
+const Rps_HamtZone*
+Rps_Value::to_hamt(const Rps_HamtZone*defhamt) const
+{
+  if (is_hamt())
+    return reinterpret_cast<const Rps_HamtZone*>(_pval);
+  else return defhamt;
+} // end Rps_Value::to_hamt
+
+const Rps_DoubleVectZone*
+Rps_Value::as_doublevect() const
+{
+  if (is_doublevect())
+    return reinterpret_cast<const Rps_DoubleVectZone*>(_pval);
+  else throw std::domain_error("Rps_Value::as_doublevect: value is not genuine double vector");
+} // end Rps_Value::as_doublevect
+
+const Rps_DoubleVectZone*
+Rps_Value::to_doublevect(void) const
+{
+  if (is_doublevect())
+    return reinterpret_cast<const Rps_DoubleVectZone*>(_pval);
+  else return nullptr;
+} // end Rps_Value::to_doublevect
+
+const Rps_IntVectZone*
+Rps_Value::as_intvect() const
+{
+  if (is_intvect())
+    return reinterpret_cast<const Rps_IntVectZone*>(_pval);
+  else throw std::domain_error("Rps_Value::as_intvect: value is not genuine int vector");
+} // end Rps_Value::as_intvect
+
+const Rps_IntVectZone*
+Rps_Value::to_intvect(void) const
+{
+  if (is_intvect())
+    return reinterpret_cast<const Rps_IntVectZone*>(_pval);
+  else return nullptr;
+} // end Rps_Value::to_intvect
+
+
 //////////////////////////////////////////////// routines common to
 //////////////////////////////////////////////// sequence of objects
 template<typename RpsSeq, Rps_Type seqty, unsigned k1, unsigned k2, unsigned k3>
@@ -897,10 +1081,23 @@ Rps_TupleValue::Rps_TupleValue(const Rps_Value val)
 {
 } // end Rps_TupleValue::Rps_TupleValue dynamic
 
+/// for an immediate string, a fresh Rps_String is allocated (or
+/// found in the intern table), which the caller should keep in a
+/// call frame slot; when only the characters are needed, use
+/// as_cppstring which never allocates in the heap
 const Rps_String*
 Rps_Value::as_string() const
 {
-  if (is_string())
+  if (is_immediate_string())
+    {
+      char buf[immediate_string_maxlen+1];
+      const char*cstr = string_cstr(buf);
+      if (const Rps_String*oldstr
+          = Rps_InternTable::find_string(cstr, (int)strlen(cstr)))
+        return oldstr;
+      return Rps_String::make(cstr);
+    }
+  else if (is_string())
     return reinterpret_cast<const Rps_String*>(_pval);
   else throw std::domain_error("Rps_Value::as_string: value is not genuine string");
 } // end Rps_Value::as_string
@@ -908,34 +1105,41 @@ Rps_Value::as_string() const
 const std::string
 Rps_Value::as_cppstring() const
 {
+  char buf[immediate_string_maxlen+1];
   if (is_string())
-    return to_string()->cppstring();
+    return std::string(string_cstr(buf));
   else
     throw std::domain_error("Rps_Value::as_cppstring: value is not genuine string");
 } // end Rps_Value::as_cppstring
 
+/// only for boxed strings: an immediate string has no C string
+/// outliving this value, use as_cppstring for it
 const char*
 Rps_Value::as_cstring() const
 {
-  if (is_string())
-    return to_string()->cstr();
+  if (is_immediate_string())
+    throw std::domain_error("Rps_Value::as_cstring: immediate string, use as_cppstring");
+  else if (is_string())
+    return reinterpret_cast<const Rps_String*>(_pval)->cstr();
   else
-    throw std::domain_error("Rps_Value::as_string: value is not genuine string");
+    throw std::domain_error("Rps_Value::as_cstring: value is not genuine string");
 } // end Rps_Value::as_cstring
 
+/// like as_string, may allocate for an immediate string
 const Rps_String*
 Rps_Value::to_string(const Rps_String*defstr) const
 {
   if (is_string())
-    return reinterpret_cast<const Rps_String*>(const_cast<Rps_ZoneValue*>(_pval));
+    return as_string();
   else return defstr;
 } // end Rps_Value::to_string
 
 const std::string
 Rps_Value::to_cppstring(std::string defstr) const
 {
-  auto strp = to_string();
-  if (strp) return strp->cppstring();
+  char buf[immediate_string_maxlen+1];
+  if (is_string())
+    return std::string(string_cstr(buf));
   else return defstr;
 } // end of Rps_Value::to_cppstring
 
@@ -976,10 +1180,13 @@ Rps_Value::to_instance(const Rps_InstanceZone*definst) const
   else return definst;
 } // end Rps_Value::to_instance
 
+/// for an immediate double, a fresh Rps_Double is allocated
 const Rps_Double*
 Rps_Value::as_boxed_double() const
 {
-  if (is_double())
+  if (is_immediate_double())
+    return Rps_Double::make(decode_immediate_double(_ival));
+  else if (is_double())
     return reinterpret_cast<const Rps_Double*>(_pval);
   else throw std::domain_error("Rps_Value::as_boxed_double: value is not genuine double");
 } // end Rps_Value::as_boxed_double
@@ -988,10 +1195,12 @@ Rps_Value::as_boxed_double() const
 double
 Rps_Value::as_double() const
 {
-  if (is_double())
-    return as_boxed_double()->dval();
+  if (is_immediate_double())
+    return decode_immediate_double(_ival);
+  else if (is_double())
+    return reinterpret_cast<const Rps_Double*>(_pval)->dval();
   else throw std::domain_error("Rps_Value::as_double: value is not genuine double");
-} // end Rps_Value::as_boxed_double
+} // end Rps_Value::as_double
 
 
 double
@@ -1018,6 +1227,15 @@ Rps_Value::operator == (const Rps_Value v) const
   if  (v._wptr == _wptr) return true;
   if (is_empty() || is_null()) return v.is_empty() || v.is_null();
   if (is_int()) return false;
+  if (is_double() || v.is_double())
+    return is_double() && v.is_double() && as_double() == v.as_double();
+  if (is_immediate_string() || v.is_immediate_string())
+    {
+      char buf[immediate_string_maxlen+1], vbuf[immediate_string_maxlen+1];
+      return is_string() && v.is_string()
+             && !strcmp(string_cstr(buf), v.string_cstr(vbuf));
+    };
+  if (!v.is_ptr()) return false;
   return (*as_ptr()) == (*v.as_ptr());
 }   // end Rps_Value::operator ==
 
@@ -1038,6 +1256,18 @@ Rps_Value::operator <= (const Rps_Value v) const
     return false;
   if (is_int())
     return (v.is_int() && (as_int() <= v.as_int() || v.is_ptr()));
+  if (is_double() && v.is_double())
+    return as_double() <= v.as_double();
+  if (is_immediate_double() || v.is_immediate_double())
+    return !v.is_int() && type() <= v.type();
+  if ((is_immediate_string() || v.is_immediate_string())
+      && is_string() && v.is_string())
+    {
+      char buf[immediate_string_maxlen+1], vbuf[immediate_string_maxlen+1];
+      return strcmp(string_cstr(buf), v.string_cstr(vbuf)) <= 0;
+    };
+  if (is_immediate_string() || v.is_immediate_string())
+    return !v.is_int() && type() <= v.type();
   if (is_ptr() && v.is_ptr())
     return (*as_ptr()) <= (*v.as_ptr());
   return false;
@@ -1054,11 +1284,86 @@ Rps_Value::operator < (const Rps_Value v) const
     return false;
   if (is_int())
     return (v.is_int() && (as_int() < v.as_int() || v.is_ptr()));
+  if (is_double() && v.is_double())
+    return as_double() < v.as_double();
+  if (is_immediate_double() || v.is_immediate_double())
+    return !v.is_int() && type() < v.type();
+  if ((is_immediate_string() || v.is_immediate_string())
+      && is_string() && v.is_string())
+    {
+      char buf[immediate_string_maxlen+1], vbuf[immediate_string_maxlen+1];
+      return strcmp(string_cstr(buf), v.string_cstr(vbuf)) < 0;
+    };
+  if (is_immediate_string() || v.is_immediate_string())
+    return !v.is_int() && type() < v.type();
   if (is_ptr() && v.is_ptr())
     return (*as_ptr()) <= (*v.as_ptr());
   return false;
 }   // end Rps_Value::operator <
 
+int
+Rps_Value::compare_total(const Rps_Value v1, const Rps_Value v2)
+{
+  if (v1._wptr == v2._wptr)
+    return 0;
+  auto kind = [](const Rps_Value v)
+  {
+    if (v.is_empty() || v.is_null()) return 0;
+    if (v.is_int()) return 1;
+    if (v.is_double()) return 2;
+    if (v.is_string()) return 3;
+    return 4;
+  };
+  int k1 = kind(v1), k2 = kind(v2);
+  if (k1 != k2)
+    return (k1 < k2) ? -1 : 1;
+  switch (k1)
+    {
+    case 0:
+      return 0;
+    case 1:
+    {
+      intptr_t i1 = v1.as_int(), i2 = v2.as_int();
+      return (i1 < i2) ? -1 : (i1 > i2) ? 1 : 0;
+    }
+    case 2:
+    {
+      /// NaNs are equal, and after every other double
+      double d1 = v1.as_double(), d2 = v2.as_double();
+      bool nan1 = std::isnan(d1), nan2 = std::isnan(d2);
+      if (nan1 || nan2)
+        return (int)nan1 - (int)nan2;
+      return (d1 < d2) ? -1 : (d1 > d2) ? 1 : 0;
+    }
+    case 3:
+    {
+      char buf1[immediate_string_maxlen+1], buf2[immediate_string_maxlen+1];
+      int c = strcmp(v1.string_cstr(buf1), v2.string_cstr(buf2));
+      return (c < 0) ? -1 : (c > 0) ? 1 : 0;
+    }
+    default:
+      break;
+    };
+  Rps_Type ty1 = v1.type(), ty2 = v2.type();
+  if (ty1 != ty2)
+    return (ty1 < ty2) ? -1 : 1;
+  if (ty1 == Rps_Type::Object)
+    {
+      Rps_Id id1 = v1.as_object()->oid(), id2 = v2.as_object()->oid();
+      return (id1 < id2) ? -1 : (id2 < id1) ? 1 : 0;
+    };
+  Rps_HashInt h1 = v1.valhash(), h2 = v2.valhash();
+  if (h1 != h2)
+    return (h1 < h2) ? -1 : 1;
+  if (*v1.as_ptr() == *v2.as_ptr())
+    return 0;
+  if (v1.as_ptr()->less(*v2.as_ptr()))
+    return -1;
+  if (v2.as_ptr()->less(*v1.as_ptr()))
+    return 1;
+  return 0;
+} // end Rps_Value::compare_total
+
 bool
 Rps_Value::operator > (const Rps_Value v) const
 {
@@ -1294,6 +1599,8 @@ Rps_ZoneValue::operator == (const Rps_ZoneValue&zv) const
 {
   if (this == &zv) return true;
   if (this->stored_type() != zv.stored_type()) return false;
+  /// distinct interned values are never equal, see Rps_InternTable
+  if (is_interned() && zv.is_interned()) return false;
   return equal(zv);
 }     // end Rps_ZoneValue::operator ==
 
@@ -1357,10 +1664,10 @@ rps_hash_cstr(const char*cstr, int len)
 }     // end of rps_hash_cstr
 
 Rps_Value::Rps_Value(const std::string&str)
-  : Rps_Value(Rps_String::make(str.c_str(), str.size()), Rps_ValPtrTag{}) {};
+  : Rps_Value(make_string(str.c_str(), str.size())) {};
 
 Rps_Value::Rps_Value(const char*str, int len)
-  : Rps_Value(Rps_String::make(str, len), Rps_ValPtrTag{}) {};
+  : Rps_Value(make_string(str, len)) {};
 
 
 const char*
@@ -1412,17 +1719,17 @@ Rps_String::make(const std::string&s)
 
 
 Rps_StringValue::Rps_StringValue (const char*cstr, int len)
-  : Rps_Value(Rps_String::make(cstr, len), Rps_ValPtrTag{})
+  : Rps_Value(make_string(cstr, len))
 {
 } // end Rps_StringValue::Rps_StringValue (const char*cstr, int len)
 
 Rps_StringValue::Rps_StringValue(const std::string str)
-  : Rps_Value(Rps_String::make(str), Rps_ValPtrTag{})
+  : Rps_Value(make_string(str.c_str(), str.size()))
 {
 } // end Rps_StringValue::Rps_StringValue
 
 Rps_StringValue::Rps_StringValue(const Rps_Value val)
-  : Rps_Value(val.is_string()?(val.to_string()):nullptr, Rps_ValPtrTag{})
+  : Rps_Value(val.is_string()?val:Rps_Value(nullptr))
 {
 } // end Rps_StringValue::Rps_StringValue(const Rps_Value val)
 
@@ -1437,17 +1744,19 @@ Rps_StringValue::Rps_StringValue(std::nullptr_t)
 } // end of Rps_StringValue::Rps_StringValue(nullptr_t)
 //////////////////////////////////////////////////////////// boxed doubles
 Rps_Value::Rps_Value (double d, Rps_DoubleTag)
-  : Rps_Value(Rps_Double::make(d), Rps_ValPtrTag())
+  : _wptr(nullptr)
 {
   if (RPS_UNLIKELY(std::isnan(d)))
     throw std::invalid_argument("NaN cannot be an Rps_Value");
+  if (!encode_immediate_double(d, _ival))
+    _pval = Rps_Double::make(d);
 };      // end Rps_Value::Rps_Value (double d, Rps_DoubleTag)
 
 Rps_Value::Rps_Value (double d) : Rps_Value::Rps_Value (d, Rps_DoubleTag{}) {};
 
 const Rps_Double* Rps_Value::to_boxed_double(const Rps_Double*defdbl) const
 {
-  if (is_double()) return reinterpret_cast<const Rps_Double*>(_pval);
+  if (is_double()) return as_boxed_double();
   else return defdbl;
 }
 
@@ -1467,12 +1776,12 @@ Rps_Double::make(double d)
 } // end  Rps_Double::make
 
 Rps_DoubleValue::Rps_DoubleValue (double d)
-  : Rps_Value(Rps_Double::make(d), Rps_ValPtrTag{})
+  : Rps_Value(d, Rps_DoubleTag{})
 {
 } // end Rps_DoubleValue::Rps_DoubleValue (double d=0.0)
 
 Rps_DoubleValue::Rps_DoubleValue(const Rps_Value val)
-  : Rps_Value(val.is_double()?val.to_boxed_double():nullptr,  Rps_ValPtrTag{})
+  : Rps_Value(val.is_double()?val:Rps_Value(nullptr))
 {
 } // end Rps_DoubleValue::Rps_DoubleValue
 
@@ -1514,12 +1823,14 @@ Rps_JsonZone::Rps_JsonZone(const Json::Value& jv)
 Rps_Payload*
 Rps_ObjectZone::get_payload(void) const
 {
+  materialize();
   return ob_payload.load();
 } // end Rps_ObjectZone::get_payload(void)
 
 Rps_PayloadClassInfo*
 Rps_ObjectZone::get_classinfo_payload(void) const
 {
+  materialize();
   auto payl = ob_payload.load();
   if (payl && RPS_UNLIKELY(payl->stored_type() == Rps_Type::PaylClassInfo))
     return reinterpret_cast<Rps_PayloadClassInfo*>(payl);
@@ -1529,6 +1840,7 @@ Rps_ObjectZone::get_classinfo_payload(void) const
 bool
 Rps_ObjectZone::has_erasable_payload(void) const
 {
+  materialize();
   auto py = ob_payload.load();
   if (py != nullptr)
     return py->is_erasable();
@@ -1539,7 +1851,7 @@ Rps_ObjectZone::has_erasable_payload(void) const
 void
 Rps_ObjectZone::clear_payload(void)
 {
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   Rps_Payload*oldpayl = ob_payload.exchange(nullptr);
   if (oldpayl)
     {
@@ -1557,12 +1869,20 @@ Rps_ObjectZone::clear_payload(void)
                                        + std::string (" cannot be removed from ")
                                        + oid().to_string());
             }
+          forget_payload_references(oldpayl);
           oldpayl->clear_owner();
         }
       delete oldpayl;
     }
 } // end Rps_ObjectZone::clear_payload
 
+void
+Rps_Payload::note_payload_references(Rps_Value oldval, Rps_Value newval)
+{
+  if (payl_owner)
+    payl_owner->note_references(oldval, newval);
+} // end Rps_Payload::note_payload_references
+
 Rps_ObjectRef
 Rps_ObjectZone::get_class(void) const
 {
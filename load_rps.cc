@@ -38,6 +38,9 @@
  ******************************************************************************/
 
 #include "refpersys.hh"
+//@@PKGCONFIG libelf
+#include "gelf.h"
+#include <link.h>
 
 
 
@@ -59,23 +62,29 @@ extern "C" char rps_loaded_directory[rps_path_byte_size];
 char rps_loaded_directory[rps_path_byte_size];
 
 Json::Value
-rps_load_string_to_json(const std::string&str, const char*filnam, int lineno)
+rps_load_string_view_to_json(std::string_view strv, const char*filnam, int lineno)
 {
   Json::CharReaderBuilder jsonreaderbuilder;
   std::unique_ptr<Json::CharReader> pjsonreader(jsonreaderbuilder.newCharReader());
   Json::Value jv;
   JSONCPP_STRING errstr;
   RPS_ASSERT(pjsonreader);
-  if (!pjsonreader->parse(str.c_str(), str.c_str() + str.size(), &jv, &errstr))
+  if (!pjsonreader->parse(strv.data(), strv.data() + strv.size(), &jv, &errstr))
     {
       if (filnam != nullptr && lineno > 0)
         {
           RPS_WARNOUT("JSON parse failure (loading) at " << filnam << ":" << lineno
-                      << std::endl << str);
+                      << std::endl << strv);
         }
       throw std::runtime_error(std::string("JSON parsing error:") + errstr);
     }
   return jv;
+} // end rps_load_string_view_to_json
+
+Json::Value
+rps_load_string_to_json(const std::string&str, const char*filnam, int lineno)
+{
+  return rps_load_string_view_to_json(std::string_view(str), filnam, lineno);
 } // end rps_load_string_to_json
 
 
@@ -92,6 +101,8 @@ class Rps_Loader
   std::set<Rps_Id> ld_spaceset;
   /// set of global roots id
   std::set<Rps_Id> ld_globrootsidset;
+  /// ids of the attributes having a secondary index
+  std::vector<Rps_Id> ld_attrindexids;
   /// mapping from plugins id to their dlopen-ed handle
   std::map<Rps_Id,void*> ld_pluginsmap;
   /// map of loaded objects
@@ -101,19 +112,169 @@ class Rps_Loader
   {
     double todo_addtime;
     std::function<void(Rps_Loader*)> todo_fun;
-    todo_st() : todo_addtime(0.0), todo_fun() {};
-    todo_st(double d, std::function<void(Rps_Loader*)> f)
-      : todo_addtime(d), todo_fun(f) {};
+    Rps_Id todo_spacid;         // of the object adding it, for profiling
+    todo_st() : todo_addtime(0.0), todo_fun(), todo_spacid() {};
+    todo_st(double d, std::function<void(Rps_Loader*)> f, Rps_Id spacid=Rps_Id())
+      : todo_addtime(d), todo_fun(f), todo_spacid(spacid) {};
   };
+  void run_todo(const todo_st&td);
   std::deque<struct todo_st> ld_todoque;
+  /// held while running todo functions, which may be run by several
+  /// threads once lazy objects are materialized; recursive since a
+  /// todo function may materialize another lazy object
+  std::recursive_mutex ld_todorunmtx;
   unsigned ld_todocount;
   static constexpr unsigned ld_maxtodo = 1<<20;
+  /// in the parallel second pass, space files are split at their
+  /// object starting lines into chunks of consecutive objects
+  struct second_pass_object_st
+  {
+    Rps_Id spo_oid;
+    unsigned spo_lineno;
+    unsigned spo_count;
+    std::string_view spo_text; // inside the mapped space file
+  };
+  struct second_pass_chunk_st
+  {
+    Rps_Id spc_spacid;
+    std::vector<second_pass_object_st> spc_objects;
+    /// todo functions added while parsing this chunk, queued after
+    /// all chunks in the serial order
+    std::vector<todo_st> spc_todos;
+    /// objects whose applying function of routine is resolved later,
+    /// since their class might still be loading in another thread
+    std::vector<std::pair<Rps_ObjectZone*,unsigned>> spc_routines;
+  };
+  static constexpr unsigned ld_chunkmaxobjects = 256;
+  static constexpr size_t ld_chunkmaxbytes = 256*1024;
+  static constexpr unsigned ld_parallelminobjects = 2048;
+  /// the chunk handled by the current worker thread, if any
+  static thread_local second_pass_chunk_st* ld_curchunk;
+  void split_space_second_pass(Rps_Id spacid, std::vector<second_pass_chunk_st>& chunkvec);
+  void parallel_second_pass(unsigned nbthreads);
+  void install_routine_applying_function(Rps_ObjectZone*obz, Rps_Id spacid, unsigned lineno);
   /// dictionary of payload loaders - used as a cache to avoid most dlsym-s
   std::map<std::string,rpsldpysig_t*> ld_payloadercache;
-  bool is_object_starting_line(Rps_Id spacid, unsigned lineno, const std::string&linbuf, Rps_Id*pobid);
+  /// the address of a function of the program, without dlsym for
+  /// most of them, see rps_load_collect_symbols
+  void* resolve_symbol(const char*name);
+  /// every space file is memory mapped once, read-only, and shared
+  /// by both passes; objects are parsed from slices of it. With
+  /// --binary-store a fresh binary snapshot is mapped instead of the
+  /// JSON file, and its records are the object slices.
+  struct space_map_st
+  {
+    std::string spm_path;
+    const char* spm_data;
+    size_t spm_size;
+    std::shared_ptr<Rps_BinStoreSpace> spm_binary;
+  };
+  std::map<Rps_Id,space_map_st> ld_spacemaps;
+  std::string_view mapped_space_file(Rps_Id spacid);
+  const Rps_BinStoreSpace* binary_space(Rps_Id spacid) const
+  {
+    auto it = ld_spacemaps.find(spacid);
+    if (it == ld_spacemaps.end())
+      return nullptr;
+    return it->second.spm_binary.get();
+  };
+  void unmap_space_files(void);
+  /// call F on the oid, line number and text of every object of a
+  /// space, giving in PROLOG the text before the first one
+  void each_object_in_space(Rps_Id spacid, std::string_view&prolog,
+                            const std::function<void(Rps_Id,unsigned,std::string_view)>&f);
+  bool is_object_starting_line(Rps_Id spacid, unsigned lineno, std::string_view linbuf, Rps_Id*pobid);
   Rps_ObjectRef fetch_one_constant_at(const char*oid,int lin);
   void parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
-                                      Rps_Id objid, const std::string& objbuf, unsigned count);
+                                      Rps_Id objid, std::string_view objbuf, unsigned count);
+  /// decode an object without building its whole Json::Value, giving
+  /// false when the DOM is needed, e.g. for a custom loading routine
+  bool pull_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
+                                     Rps_Id objid, std::string_view objbuf, unsigned count);
+  void load_object_extra_members(Rps_ObjectZone*obz, const Json::Value&objjson,
+                                 Rps_Id spacid, unsigned lineno,
+                                 Rps_Id objid, unsigned count);
+  void binary_record_second_pass (const Rps_BinStoreSpace&bsp, Rps_Id spacid,
+                                  unsigned lineno, Rps_Id objid,
+                                  std::string_view record, unsigned count);
+  /// load the contents of an object from its text or binary record
+  void load_object_contents (Rps_Id spacid, unsigned lineno,
+                             Rps_Id objid, std::string_view objtext, unsigned count)
+  {
+    if (const Rps_BinStoreSpace*bsp = binary_space(spacid))
+      binary_record_second_pass(*bsp, spacid, lineno, objid, objtext, count);
+    else
+      parse_json_buffer_second_pass(spacid, lineno, objid, objtext, count);
+  };
+  /// in the second pass, with --lazy-load most objects only get
+  /// their class, space and mtime, and are materialized later
+  void load_object_second_pass (Rps_Id spacid, unsigned lineno,
+                                Rps_Id objid, std::string_view objtext, unsigned count)
+  {
+    double startim = RPS_UNLIKELY(ld_profiling) ? rps_elapsed_real_time() : 0.0;
+    ld_curspacid = spacid;
+    if (!(RPS_UNLIKELY(rps_lazy_load)
+          && defer_object_second_pass(spacid, lineno, objid, objtext, count)))
+      load_object_contents(spacid, lineno, objid, objtext, count);
+    ld_curspacid = Rps_Id();
+    if (RPS_UNLIKELY(ld_profiling))
+      profile_object(spacid, objid, rps_elapsed_real_time() - startim);
+  };
+  /// load profiling, only with --load-profile=FILE, without any
+  /// debug output; see write_load_profile
+  struct profile_space_st
+  {
+    double psp_firstpass;       // real time of its first pass
+    double psp_secondpass;      // cumulated time decoding its objects
+    double psp_todo;            // cumulated time of todo functions they added
+    size_t psp_bytes;           // size of its mapped file
+    unsigned psp_nbobjects;
+  };
+  struct profile_payload_st
+  {
+    double ppl_time;            // cumulated time of the payload loader
+    unsigned ppl_count;
+  };
+  struct profile_object_st
+  {
+    double pob_time;
+    Rps_Id pob_oid;
+    Rps_Id pob_spacid;
+  };
+  /// with --lazy-load, the objects whose contents are decoded on
+  /// first use or by a background thread, from their text or record
+  /// in the space files, which stay mapped meanwhile
+  struct lazy_object_st
+  {
+    Rps_Id lzo_spacid;
+    unsigned lzo_lineno;
+    unsigned lzo_count;
+    std::string_view lzo_text;
+  };
+  std::mutex ld_lazymtx;
+  std::unordered_map<Rps_ObjectZone*,lazy_object_st> ld_lazymap;
+  /// the lazy objects not yet materialized, or being materialized
+  std::atomic<unsigned> ld_lazycount;
+  /// set once the todo functions of the load have run
+  std::atomic<bool> ld_lazyloaded;
+  static constexpr unsigned ld_lazybatch = 64;
+  const bool ld_profiling;
+  std::mutex ld_profmtx;
+  std::map<Rps_Id,profile_space_st> ld_profspaces;
+  std::map<std::string,profile_payload_st> ld_profpayloads;
+  /// a min-heap of the slowest objects to decode
+  std::vector<profile_object_st> ld_profslowest;
+  std::vector<std::pair<std::string,double>> ld_profphases;
+  static constexpr unsigned ld_profnbslowest = 24;
+  /// the space of the object loaded by the current thread
+  static thread_local Rps_Id ld_curspacid;
+  void profile_object(Rps_Id spacid, Rps_Id objid, double elapsed);
+  void profile_payload(const std::string&paylstr, double elapsed);
+  bool defer_object_second_pass (Rps_Id spacid, unsigned lineno,
+                                 Rps_Id objid, std::string_view objtext, unsigned count);
+  Rps_ObjectZone* some_lazy_object(void);
+  void lazy_materializer_thread(void);
+  double clamped_mtime(double mtim, Rps_Id objid, Rps_Id spacid, unsigned lineno);
 public:
   Rps_Loader(const std::string&topdir);
   ~Rps_Loader();
@@ -123,6 +284,7 @@ public:
   void initialize_root_objects(void);
   void initialize_constant_objects(void);
   void second_pass_space(Rps_Id spacid);
+  void build_attribute_indexes(void);
   std::string string_of_loaded_file(const std::string& relpath);
   std::string space_file_path(Rps_Id spacid);
   std::string load_real_path(const std::string& path);
@@ -134,6 +296,9 @@ public:
     return Rps_ObjectRef(nullptr);
   };
   void load_all_state_files(void);
+  /// for --check-pull-parser, decode every textual object with both
+  /// jsoncpp and the pull parser, giving the number of mismatches
+  unsigned check_pull_parser(void);
   void add_todo(const std::function<void(Rps_Loader*)>& todofun);
   void set_primitive_type_size_and_align(Rps_ObjectRef primtypob,
                                          unsigned sizeby, unsigned alignby);
@@ -144,6 +309,26 @@ public:
   {
     return ld_mapobjects.size();
   };
+  //// lazy loading, see defer_object_second_pass
+  unsigned nb_lazy_objects(void) const
+  {
+    return ld_lazycount.load();
+  };
+  /// called with the mutex of the pending object OBZ locked
+  void materialize_object(Rps_ObjectZone*obz);
+  void run_lazy_todo_functions(void);
+  void materialize_all_objects(void);
+  void gc_mark_lazy_objects(Rps_GarbageCollector*gc);
+  void start_lazy_materializer(void);
+  //// load profiling
+  bool is_profiling(void) const
+  {
+    return ld_profiling;
+  };
+  /// record the real time of the phase NAME begun at PHASESTART,
+  /// which becomes now
+  void profile_phase(const char*name, double&phasestart);
+  void write_load_profile(const std::string&path);
 };        // end class Rps_Loader
 
 
@@ -154,11 +339,24 @@ Rps_Loader::Rps_Loader(const std::string&topdir) :
   ld_mtx(),
   ld_spaceset(),
   ld_globrootsidset(),
+  ld_attrindexids(),
   ld_pluginsmap(),
   ld_mapobjects(),
   ld_todoque(),
+  ld_todorunmtx(),
   ld_todocount(0),
-  ld_payloadercache()
+  ld_payloadercache(),
+  ld_spacemaps(),
+  ld_lazymtx(),
+  ld_lazymap(),
+  ld_lazycount(0),
+  ld_lazyloaded(false),
+  ld_profiling(rps_load_profile != nullptr),
+  ld_profmtx(),
+  ld_profspaces(),
+  ld_profpayloads(),
+  ld_profslowest(),
+  ld_profphases()
 {
   RPS_DEBUG_LOG(LOAD, "Rps_Loader constr topdir=" << topdir
                 << " this@" << (void*)this
@@ -168,6 +366,7 @@ Rps_Loader::Rps_Loader(const std::string&topdir) :
 
 Rps_Loader::~Rps_Loader()
 {
+  unmap_space_files();
   RPS_DEBUG_LOG(LOAD, "Rps_Loader destr topdir=" << ld_topdir
                 << " this@" << (void*)this
                 << std::endl
@@ -223,7 +422,7 @@ Rps_Loader::space_file_path(Rps_Id spacid)
 
 
 bool
-Rps_Loader::is_object_starting_line(Rps_Id spacid, unsigned lineno, const std::string&linbuf, Rps_Id*pobid)
+Rps_Loader::is_object_starting_line(Rps_Id spacid, unsigned lineno, std::string_view linbuf, Rps_Id*pobid)
 {
   const char*reason = nullptr;
   const char*oidstart = nullptr;
@@ -249,7 +448,7 @@ Rps_Loader::is_object_starting_line(Rps_Id spacid, unsigned lineno, const std::s
       reason = "too short";
       goto bad;
     }
-  linestart = linbuf.c_str();
+  linestart = linbuf.data();
   oidstart = linestart + strlen("//+ob");
   char oidbuf[Rps_Id::nbchars+8];
   memset (oidbuf, 0, sizeof(oidbuf));
@@ -312,96 +511,234 @@ bad:
 
 
 
-void
-Rps_Loader::first_pass_space(Rps_Id spacid)
+/// map read-only the whole file of PATH, giving its size in *PSIZE
+static const char*
+rps_load_map_file(const std::string&path, size_t*psize)
 {
-  auto spacepath = load_real_path(space_file_path(spacid));
-  std::ifstream ins(spacepath);
-  std::string prologstr;
-  int obcnt = 0;
-  int expectedcnt = 0;
-  unsigned lincnt = 0;
-  RPS_DEBUG_LOG(LOAD, "first_pass_space start spacepath=" << spacepath);
-  for (std::string linbuf; std::getline(ins, linbuf); )
+  int fd = open(path.c_str(), O_RDONLY|O_CLOEXEC);
+  if (fd < 0)
+    throw std::runtime_error(std::string("cannot open space file ") + path
+                             + ":" + strerror(errno));
+  struct stat spacestat;
+  memset (&spacestat, 0, sizeof(spacestat));
+  if (fstat(fd, &spacestat))
     {
-      lincnt++;
-      if (u8_check(reinterpret_cast<const uint8_t*> (linbuf.c_str()),
-                   linbuf.size()))
-        {
-          RPS_WARN("non UTF8 line#%d in %s:\n%s",
-                   lincnt, spacepath.c_str(), linbuf.c_str());
-          char errbuf[40];
-          snprintf(errbuf, sizeof(errbuf), "non UTF8 line#%d", lincnt);
-          throw std::runtime_error(std::string(errbuf) + " in " + spacepath);
-        }
-      if (RPS_UNLIKELY(obcnt == 0))
+      int e = errno;
+      close(fd);
+      throw std::runtime_error(std::string("cannot stat space file ") + path
+                               + ":" + strerror(e));
+    }
+  size_t spacesize = (size_t)spacestat.st_size;
+  const char*spacedata = nullptr;
+  if (spacesize > 0)
+    {
+      void*ad = mmap(nullptr, spacesize, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (ad == MAP_FAILED)
         {
-          prologstr += linbuf;
-          prologstr += '\n';
+          int e = errno;
+          close(fd);
+          throw std::runtime_error(std::string("cannot mmap space file ") + path
+                                   + ":" + strerror(e));
         }
-      Rps_Id curobjid;
-      if (is_object_starting_line(spacid, lincnt, linbuf, &curobjid))
+      (void) madvise(ad, spacesize, MADV_SEQUENTIAL|MADV_WILLNEED);
+      spacedata = (const char*)ad;
+    };
+  close(fd);
+  *psize = spacesize;
+  return spacedata;
+} // end rps_load_map_file
+
+std::string_view
+Rps_Loader::mapped_space_file(Rps_Id spacid)
+{
+  auto it = ld_spacemaps.find(spacid);
+  if (it != ld_spacemaps.end())
+    return std::string_view(it->second.spm_data, it->second.spm_size);
+  auto spacepath = load_real_path(space_file_path(spacid));
+  if (rps_binary_store)
+    {
+      std::string binpath = ld_topdir + "/persistore/sp" + spacid.to_string()
+                            + RPS_BINSTORE_SUFFIX;
+      if (!access(binpath.c_str(), R_OK))
         {
-          RPS_DEBUG_LOG(LOAD, "firstpass got ob spacid:" << spacid
-                        << " linbuf: " << linbuf
-                        << " lincnt#" << lincnt
-                        << " curobjid:" << curobjid
-                        << " count:" << (obcnt+1));
-          if (RPS_UNLIKELY(obcnt == 0))
+          size_t binsize = 0;
+          const char*bindata = rps_load_map_file(binpath, &binsize);
+          try
             {
-              Json::Value prologjson;
-              try
+              auto bsp = std::make_shared<Rps_BinStoreSpace>(binpath,
+                         std::string_view(bindata, binsize));
+              if (bsp->is_fresh_for(spacepath))
                 {
-                  prologjson = rps_load_string_to_json(prologstr);
-                  if (prologjson.type() != Json::objectValue)
-                    RPS_FATAL("Rps_Loader::first_pass_space %s line#%d bad Json type #%d",
-                              spacepath.c_str(), (int)lincnt, (int)prologjson.type());
+                  ld_spacemaps.insert({spacid, space_map_st{binpath, bindata, binsize, bsp}});
+                  RPS_DEBUG_LOG(LOAD, "mapped_space_file spacid=" << spacid
+                                << " binary path=" << binpath
+                                << " size=" << binsize);
+                  return std::string_view(bindata, binsize);
                 }
-              catch (std::exception& exc)
-                {
-                  RPS_FATALOUT("Rps_Loader::first_pass_space " << " spacepath:" << spacepath
-                               << " line#" << lincnt
-                               << " failed to parse: " << exc.what());
-                };
-              Json::Value formatjson = prologjson["format"];
-              if (formatjson.type() !=Json::stringValue)
-                RPS_FATALOUT("space file " << spacepath
-                             << " with bad format type#" << (int)formatjson.type());
-              if (formatjson.asString() != RPS_MANIFEST_FORMAT
-                  && formatjson.asString() != RPS_PREVIOUS_MANIFEST_FORMAT)
-                RPS_FATALOUT("space file " << spacepath
-                             << "should have format: "
-                             << RPS_MANIFEST_FORMAT
-                             << " or " << RPS_PREVIOUS_MANIFEST_FORMAT
-                             << " but got "
-                             << formatjson);
-              if (prologjson["spaceid"].asString() != spacid.to_string())
-                RPS_FATAL("spacefile %s should have spaceid: '%s' but got '%s'",
-                          spacepath.c_str (), spacid.to_string().c_str(),
-                          prologjson["spaceid"].asString().c_str());
-              int majv = prologjson["rpsmajorversion"].asInt();
-              int minv = prologjson["rpsminorversion"].asInt();
-              if (majv != rps_get_major_version()
-                  || minv != rps_get_minor_version())
-                RPS_WARNOUT("space file " << spacepath
-                            << " was dumped by RefPerSys " << majv << "." << minv
-                            << " but is loaded by RefPerSys " << rps_get_major_version()
-                            << "." << rps_get_minor_version());
-              Json::Value nbobjectsjson =  prologjson["nbobjects"];
-              expectedcnt =nbobjectsjson.asInt();
+              RPS_WARNOUT("ignoring stale binary space file " << binpath
+                          << " older than " << spacepath);
             }
-          Rps_ObjectRef obref(Rps_ObjectZone::make_loaded(curobjid, this));
-          if (ld_mapobjects.find(curobjid) != ld_mapobjects.end())
+          catch (const std::exception&exc)
             {
-              RPS_WARN("duplicate object of oid %s in  line#%d in %s",
-                       curobjid.to_string().c_str(), lincnt, spacepath.c_str());
-              throw std::runtime_error(std::string("duplicate objid "
-                                                   + curobjid.to_string() + " in " + spacepath));
+              RPS_WARNOUT("ignoring bad binary space file " << binpath
+                          << ": " << exc.what());
             }
-          ld_mapobjects.insert({curobjid,obref});
-          obcnt++;
+          if (bindata)
+            munmap((void*)bindata, binsize);
+        }
+    }
+  size_t spacesize = 0;
+  const char*spacedata = rps_load_map_file(spacepath, &spacesize);
+  const char*badutf8 = rps_utf8_check(spacedata, spacesize);
+  if (badutf8)
+    {
+      unsigned badlin = 1 + std::count(spacedata, badutf8, '\n');
+      if (spacedata)
+        munmap((void*)spacedata, spacesize);
+      RPS_WARN("non UTF8 line#%u in %s", badlin, spacepath.c_str());
+      char errbuf[40];
+      snprintf(errbuf, sizeof(errbuf), "non UTF8 line#%u", badlin);
+      throw std::runtime_error(std::string(errbuf) + " in " + spacepath);
+    }
+  ld_spacemaps.insert({spacid, space_map_st{spacepath, spacedata, spacesize, nullptr}});
+  RPS_DEBUG_LOG(LOAD, "mapped_space_file spacid=" << spacid << " path=" << spacepath
+                << " size=" << spacesize);
+  return std::string_view(spacedata, spacesize);
+} // end Rps_Loader::mapped_space_file
+
+void
+Rps_Loader::unmap_space_files(void)
+{
+  for (auto& it : ld_spacemaps)
+    if (it.second.spm_data)
+      munmap((void*)it.second.spm_data, it.second.spm_size);
+  ld_spacemaps.clear();
+} // end Rps_Loader::unmap_space_files
+
+void
+Rps_Loader::each_object_in_space(Rps_Id spacid, std::string_view&prolog,
+                                 const std::function<void(Rps_Id,unsigned,std::string_view)>&f)
+{
+  static constexpr char obstart[] = "\n//+ob_";
+  constexpr size_t obstartlen = sizeof(obstart)-1;
+  std::string_view spacetext = mapped_space_file(spacid);
+  if (const Rps_BinStoreSpace*bsp = binary_space(spacid))
+    {
+      prolog = bsp->prolog();
+      for (unsigned ix=0; ix<bsp->nb_records(); ix++)
+        {
+          std::string_view rec = bsp->record(ix);
+          Rps_BinStoreReader rd(rec);
+          Rps_Id curobjid;
+          unsigned lineno = 0;
+          (void) bsp->record_start(rd, curobjid, lineno);
+          f(curobjid, lineno, rec);
         }
+      return;
     }
+  const char*start = spacetext.data();
+  const char*end = start + spacetext.size();
+  /// the next object starting line at or after FROM, found by the
+  /// vectorized memmem of the C library
+  auto next_object_start = [&](const char*from) -> const char*
+  {
+    if (from >= end)
+      return end;
+    const char*nl = (const char*) memmem(from, end-from, obstart, obstartlen);
+    return nl?(nl+1):end;
+  };
+  const char*cur = nullptr;
+  if (spacetext.size() >= obstartlen-1
+      && !memcmp(start, obstart+1, obstartlen-1))
+    cur = start;
+  else
+    cur = next_object_start(start);
+  prolog = std::string_view(start, cur-start);
+  unsigned lineno = 1 + std::count(start, cur, '\n');
+  while (cur < end)
+    {
+      const char*eol = (const char*) memchr(cur, '\n', end-cur);
+      if (!eol)
+        eol = end;
+      const char*next = next_object_start(eol);
+      Rps_Id curobjid;
+      if (is_object_starting_line(spacid, lineno, std::string_view(cur, eol-cur), &curobjid))
+        f(curobjid, lineno, std::string_view(cur, next-cur));
+      lineno += std::count(cur, next, '\n');
+      cur = next;
+    }
+} // end Rps_Loader::each_object_in_space
+
+void
+Rps_Loader::first_pass_space(Rps_Id spacid)
+{
+  double startim = rps_elapsed_real_time();
+  auto spacepath = load_real_path(space_file_path(spacid));
+  std::string_view prolog;
+  int obcnt = 0;
+  int expectedcnt = 0;
+  RPS_DEBUG_LOG(LOAD, "first_pass_space start spacepath=" << spacepath);
+  each_object_in_space(spacid, prolog,
+                       [&](Rps_Id curobjid, unsigned lincnt, std::string_view)
+  {
+    RPS_DEBUG_LOG(LOAD, "firstpass got ob spacid:" << spacid
+                  << " lincnt#" << lincnt
+                  << " curobjid:" << curobjid
+                  << " count:" << (obcnt+1));
+    if (RPS_UNLIKELY(obcnt == 0))
+      {
+        Json::Value prologjson;
+        try
+          {
+            prologjson = rps_load_string_view_to_json(prolog);
+            if (prologjson.type() != Json::objectValue)
+              RPS_FATAL("Rps_Loader::first_pass_space %s line#%d bad Json type #%d",
+                        spacepath.c_str(), (int)lincnt, (int)prologjson.type());
+          }
+        catch (std::exception& exc)
+          {
+            RPS_FATALOUT("Rps_Loader::first_pass_space " << " spacepath:" << spacepath
+                         << " line#" << lincnt
+                         << " failed to parse: " << exc.what());
+          };
+        Json::Value formatjson = prologjson["format"];
+        if (formatjson.type() !=Json::stringValue)
+          RPS_FATALOUT("space file " << spacepath
+                       << " with bad format type#" << (int)formatjson.type());
+        if (formatjson.asString() != RPS_MANIFEST_FORMAT
+            && formatjson.asString() != RPS_PREVIOUS_MANIFEST_FORMAT)
+          RPS_FATALOUT("space file " << spacepath
+                       << "should have format: "
+                       << RPS_MANIFEST_FORMAT
+                       << " or " << RPS_PREVIOUS_MANIFEST_FORMAT
+                       << " but got "
+                       << formatjson);
+        if (prologjson["spaceid"].asString() != spacid.to_string())
+          RPS_FATAL("spacefile %s should have spaceid: '%s' but got '%s'",
+                    spacepath.c_str (), spacid.to_string().c_str(),
+                    prologjson["spaceid"].asString().c_str());
+        int majv = prologjson["rpsmajorversion"].asInt();
+        int minv = prologjson["rpsminorversion"].asInt();
+        if (majv != rps_get_major_version()
+            || minv != rps_get_minor_version())
+          RPS_WARNOUT("space file " << spacepath
+                      << " was dumped by RefPerSys " << majv << "." << minv
+                      << " but is loaded by RefPerSys " << rps_get_major_version()
+                      << "." << rps_get_minor_version());
+        Json::Value nbobjectsjson =  prologjson["nbobjects"];
+        expectedcnt =nbobjectsjson.asInt();
+      }
+    Rps_ObjectRef obref(Rps_ObjectZone::make_loaded(curobjid, this));
+    if (ld_mapobjects.find(curobjid) != ld_mapobjects.end())
+      {
+        RPS_WARN("duplicate object of oid %s in  line#%d in %s",
+                 curobjid.to_string().c_str(), lincnt, spacepath.c_str());
+        throw std::runtime_error(std::string("duplicate objid "
+                                             + curobjid.to_string() + " in " + spacepath));
+      }
+    ld_mapobjects.insert({curobjid,obref});
+    obcnt++;
+  });
   if (obcnt != expectedcnt)
     {
       RPS_WARN("got %d objects in loaded space %s but expected %d of them",
@@ -409,19 +746,50 @@ Rps_Loader::first_pass_space(Rps_Id spacid)
       throw std::runtime_error(std::string("unexpected object count in ")
                                + spacepath);
     }
+  if (RPS_UNLIKELY(ld_profiling))
+    {
+      std::lock_guard<std::mutex> gu(ld_profmtx);
+      profile_space_st& prof = ld_profspaces[spacid];
+      prof.psp_firstpass = rps_elapsed_real_time() - startim;
+      prof.psp_bytes = mapped_space_file(spacid).size();
+      prof.psp_nbobjects = obcnt;
+    }
   RPS_DEBUG_LOG(LOAD, "first_pass_space end spacepath=" << spacepath << " obcnt="<< obcnt << std::endl
                 << "… read " << obcnt
                 << " objects while loading first pass of " << spacepath);
 } // end Rps_Loader::first_pass_space
 
+thread_local Rps_Loader::second_pass_chunk_st* Rps_Loader::ld_curchunk;
+thread_local Rps_Id Rps_Loader::ld_curspacid;
+
 void
 Rps_Loader::add_todo(const std::function<void(Rps_Loader*)>& todofun)
 {
+  if (ld_curchunk)
+    {
+      ld_curchunk->spc_todos.push_back(todo_st{rps_elapsed_real_time(),todofun,ld_curspacid});
+      return;
+    };
   std::lock_guard<std::recursive_mutex> gu(ld_mtx);
-  ld_todoque.push_back(todo_st{rps_elapsed_real_time(),todofun});
+  ld_todoque.push_back(todo_st{rps_elapsed_real_time(),todofun,ld_curspacid});
 } // end Rps_Loader::add_todo
 
 
+void
+Rps_Loader::run_todo(const todo_st&td)
+{
+  if (RPS_LIKELY(!ld_profiling))
+    {
+      td.todo_fun(this);
+      return;
+    };
+  double startim = rps_elapsed_real_time();
+  td.todo_fun(this);
+  double elapsed = rps_elapsed_real_time() - startim;
+  std::lock_guard<std::mutex> gu(ld_profmtx);
+  ld_profspaces[td.todo_spacid].psp_todo += elapsed;
+} // end Rps_Loader::run_todo
+
 // return the number of remaining todo functions
 int
 Rps_Loader::run_some_todo_functions(void)
@@ -430,6 +798,9 @@ Rps_Loader::run_some_todo_functions(void)
   constexpr int dosteps = 24;
   constexpr double doelaps = 0.05;
   int count=0;
+  /// todo functions were written for a sequential load, so they never
+  /// run concurrently
+  std::lock_guard<std::recursive_mutex> gurun(ld_todorunmtx);
   /// run at least the front todo entry
   {
     todo_st td;
@@ -443,7 +814,7 @@ Rps_Loader::run_some_todo_functions(void)
       if (ld_todocount++ > ld_maxtodo)
         RPS_FATALOUT("too many " << ld_todocount << " loader todo functions");
     }
-    td.todo_fun(this);
+    run_todo(td);
     count++;
   }
   /// run more entries provided they have been added before start
@@ -462,7 +833,7 @@ Rps_Loader::run_some_todo_functions(void)
         if (ld_todocount++ > ld_maxtodo)
           RPS_FATALOUT("too many " << ld_todocount << " loader todo functions");
       }
-      td.todo_fun(this);
+      run_todo(td);
       count++;
     }
   /// finally
@@ -528,19 +899,962 @@ Rps_Loader::fetch_one_constant_at(const char*oidstr, int lin)
 
 
 
+//////////////////////////////////////////////// pull parsing of JSON
+/// A small pull parser over a JSON text, accepting comments like the
+/// jsoncpp reader does. The loader uses it to build RefPerSys values
+/// directly from the text of each object, without an intermediate
+/// Json::Value tree. Errors are thrown as std::runtime_error.
+class Rps_JsonPullParser
+{
+  const char* jp_start;
+  const char* jp_cur;
+  const char* jp_end;
+  [[noreturn]] void fail(const char*msg) const
+  {
+    throw std::runtime_error(std::string("JSON pull parsing error: ") + msg
+                             + " at offset " + std::to_string(jp_cur - jp_start));
+  };
+  static void append_utf8(std::string&str, unsigned cp)
+  {
+    if (cp < 0x80)
+      str.push_back((char)cp);
+    else if (cp < 0x800)
+      {
+        str.push_back((char)(0xC0 | (cp >> 6)));
+        str.push_back((char)(0x80 | (cp & 0x3F)));
+      }
+    else if (cp < 0x10000)
+      {
+        str.push_back((char)(0xE0 | (cp >> 12)));
+        str.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        str.push_back((char)(0x80 | (cp & 0x3F)));
+      }
+    else
+      {
+        str.push_back((char)(0xF0 | (cp >> 18)));
+        str.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+        str.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        str.push_back((char)(0x80 | (cp & 0x3F)));
+      }
+  };
+  unsigned parse_hex4(void)
+  {
+    if (jp_end - jp_cur < 4)
+      fail("truncated \\u escape");
+    unsigned cp = 0;
+    for (int ix=0; ix<4; ix++)
+      {
+        char c = *jp_cur++;
+        cp <<= 4;
+        if (c >= '0' && c <= '9')
+          cp |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+          cp |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+          cp |= c - 'A' + 10;
+        else
+          fail("bad \\u escape");
+      }
+    return cp;
+  };
+public:
+  Rps_JsonPullParser(std::string_view sv)
+    : jp_start(sv.data()), jp_cur(sv.data()), jp_end(sv.data()+sv.size()) {};
+  /// skip spaces and comments, and give the next character or 0 at end
+  char peek(void)
+  {
+    for (;;)
+      {
+        while (jp_cur < jp_end && (*jp_cur == ' ' || *jp_cur == '\n'
+                                   || *jp_cur == '\t' || *jp_cur == '\r'))
+          jp_cur++;
+        if (jp_cur + 1 < jp_end && jp_cur[0] == '/' && jp_cur[1] == '/')
+          {
+            const char*eol = (const char*) memchr(jp_cur, '\n', jp_end - jp_cur);
+            jp_cur = eol?eol:jp_end;
+            continue;
+          }
+        if (jp_cur + 1 < jp_end && jp_cur[0] == '/' && jp_cur[1] == '*')
+          {
+            const char*eoc = (const char*) memmem(jp_cur+2, jp_end-jp_cur-2, "*/", 2);
+            if (!eoc)
+              fail("unterminated comment");
+            jp_cur = eoc+2;
+            continue;
+          }
+        return (jp_cur < jp_end)?*jp_cur:(char)0;
+      }
+  };
+  bool at_end(void)
+  {
+    return peek() == (char)0;
+  };
+  const char* position(void) const
+  {
+    return jp_cur;
+  };
+  void expect(char c)
+  {
+    if (peek() != c)
+      {
+        char msg[32];
+        snprintf(msg, sizeof(msg), "expecting '%c'", c);
+        fail(msg);
+      }
+    jp_cur++;
+  };
+  bool consume(char c)
+  {
+    if (peek() != c)
+      return false;
+    jp_cur++;
+    return true;
+  };
+  bool consume_literal(const char*lit)
+  {
+    size_t len = strlen(lit);
+    if (peek() != lit[0] || (size_t)(jp_end - jp_cur) < len
+        || memcmp(jp_cur, lit, len))
+      return false;
+    jp_cur += len;
+    return true;
+  };
+  std::string parse_string(void)
+  {
+    expect('"');
+    std::string str;
+    for (;;)
+      {
+        /// copy the unescaped run at once
+        const char*run = jp_cur;
+        while (jp_cur < jp_end && *jp_cur != '"' && *jp_cur != '\\')
+          jp_cur++;
+        str.append(run, jp_cur - run);
+        if (jp_cur >= jp_end)
+          fail("unterminated string");
+        if (*jp_cur == '"')
+          {
+            jp_cur++;
+            return str;
+          }
+        jp_cur++;
+        if (jp_cur >= jp_end)
+          fail("unterminated escape");
+        char esc = *jp_cur++;
+        switch (esc)
+          {
+          case '"':
+            str.push_back('"');
+            break;
+          case '\\':
+            str.push_back('\\');
+            break;
+          case '/':
+            str.push_back('/');
+            break;
+          case 'b':
+            str.push_back('\b');
+            break;
+          case 'f':
+            str.push_back('\f');
+            break;
+          case 'n':
+            str.push_back('\n');
+            break;
+          case 'r':
+            str.push_back('\r');
+            break;
+          case 't':
+            str.push_back('\t');
+            break;
+          case 'u':
+          {
+            unsigned cp = parse_hex4();
+            if (cp >= 0xD800 && cp < 0xDC00)
+              {
+                if (jp_end - jp_cur < 6 || jp_cur[0] != '\\' || jp_cur[1] != 'u')
+                  fail("lone high surrogate");
+                jp_cur += 2;
+                unsigned lo = parse_hex4();
+                if (lo < 0xDC00 || lo >= 0xE000)
+                  fail("bad low surrogate");
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+              }
+            append_utf8(str, cp);
+          }
+          break;
+          default:
+            fail("bad escape");
+          }
+      }
+  };
+  /// parse a number; give true and set I for an integral value which
+  /// fits in 64 bits, else set D. Like jsoncpp isInt64, a real
+  /// without fractional part is integral.
+  bool parse_number(std::int64_t&i, double&d)
+  {
+    peek();
+    const char*numstart = jp_cur;
+    bool isreal = false;
+    if (jp_cur < jp_end && *jp_cur == '-')
+      jp_cur++;
+    while (jp_cur < jp_end)
+      {
+        char c = *jp_cur;
+        if (isdigit(c))
+          jp_cur++;
+        else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+          {
+            isreal = true;
+            jp_cur++;
+          }
+        else
+          break;
+      }
+    if (jp_cur == numstart)
+      fail("expecting number");
+    char numbuf[64];
+    if (jp_cur - numstart >= (long)sizeof(numbuf))
+      fail("too long number");
+    memcpy(numbuf, numstart, jp_cur - numstart);
+    numbuf[jp_cur - numstart] = (char)0;
+    char*endnum = nullptr;
+    if (!isreal)
+      {
+        errno = 0;
+        long long ll = strtoll(numbuf, &endnum, 10);
+        if (errno == 0 && endnum && *endnum == (char)0)
+          {
+            i = ll;
+            return true;
+          }
+      }
+    d = strtod(numbuf, &endnum);
+    if (!endnum || *endnum)
+      fail("bad number");
+    if (std::floor(d) == d && d >= (double)INT64_MIN && d < (double)INT64_MAX)
+      {
+        i = (std::int64_t)d;
+        return true;
+      }
+    return false;
+  };
+  /// skip the next value and give its text
+  std::string_view skip_value(void)
+  {
+    char c = peek();
+    const char*valstart = jp_cur;
+    switch (c)
+      {
+      case '"':
+        parse_string();
+        break;
+      case '{':
+        jp_cur++;
+        if (!consume('}'))
+          {
+            do
+              {
+                parse_string();
+                expect(':');
+                skip_value();
+              }
+            while (consume(','));
+            expect('}');
+          }
+        break;
+      case '[':
+        jp_cur++;
+        if (!consume(']'))
+          {
+            do
+              skip_value();
+            while (consume(','));
+            expect(']');
+          }
+        break;
+      case 't':
+        if (!consume_literal("true"))
+          fail("bad literal");
+        break;
+      case 'f':
+        if (!consume_literal("false"))
+          fail("bad literal");
+        break;
+      case 'n':
+        if (!consume_literal("null"))
+          fail("bad literal");
+        break;
+      default:
+      {
+        std::int64_t i = 0;
+        double d = 0.0;
+        parse_number(i, d);
+      }
+      }
+    return std::string_view(valstart, jp_cur - valstart);
+  };
+  /// give the key and the text of every member of the next JSON object
+  std::vector<std::pair<std::string,std::string_view>> object_members(void)
+  {
+    std::vector<std::pair<std::string,std::string_view>> membvec;
+    expect('{');
+    if (consume('}'))
+      return membvec;
+    do
+      {
+        std::string key = parse_string();
+        expect(':');
+        std::string_view valtext = skip_value();
+        auto it = std::find_if(membvec.begin(), membvec.end(),
+                               [&](const std::pair<std::string,std::string_view>&p)
+        {
+          return p.first == key;
+        });
+        /// like jsoncpp, the last duplicate member wins
+        if (it != membvec.end())
+          it->second = valtext;
+        else
+          membvec.push_back({key, valtext});
+      }
+    while (consume(','));
+    expect('}');
+    return membvec;
+  };
+};        // end class Rps_JsonPullParser
+
+/// the Json::Value of the next pulled value, only for checking the
+/// pull parser against jsoncpp
+static Json::Value
+rps_pull_json(Rps_JsonPullParser&jp)
+{
+  char c = jp.peek();
+  switch (c)
+    {
+    case '{':
+    {
+      Json::Value jobj(Json::objectValue);
+      for (auto& memb : jp.object_members())
+        {
+          Rps_JsonPullParser subjp(memb.second);
+          jobj[memb.first] = rps_pull_json(subjp);
+        }
+      return jobj;
+    }
+    case '[':
+    {
+      Json::Value jarr(Json::arrayValue);
+      jp.expect('[');
+      if (jp.consume(']'))
+        return jarr;
+      do
+        jarr.append(rps_pull_json(jp));
+      while (jp.consume(','));
+      jp.expect(']');
+      return jarr;
+    }
+    case '"':
+      return Json::Value(jp.parse_string());
+    case 't':
+    case 'f':
+    case 'n':
+      if (jp.consume_literal("true"))
+        return Json::Value(true);
+      if (jp.consume_literal("false"))
+        return Json::Value(false);
+      if (jp.consume_literal("null"))
+        return Json::Value(Json::nullValue);
+      throw std::runtime_error("bad pulled JSON literal");
+    default:
+    {
+      std::int64_t i = 0;
+      double d = 0.0;
+      if (jp.parse_number(i, d))
+        return Json::Value((Json::Int64)i);
+      return Json::Value(d);
+    }
+    }
+} // end rps_pull_json
+
+/// compare a jsoncpp value with a pulled one; numbers are compared by
+/// value since the pull parser gives integers for integral reals
+static bool
+rps_pulled_json_same(const Json::Value&domjv, const Json::Value&pulljv)
+{
+  if (domjv.isNumeric() && pulljv.isNumeric())
+    {
+      if (domjv.isInt64() && pulljv.isInt64())
+        return domjv.asInt64() == pulljv.asInt64();
+      return domjv.asDouble() == pulljv.asDouble();
+    }
+  if (domjv.type() != pulljv.type())
+    return false;
+  switch (domjv.type())
+    {
+    case Json::arrayValue:
+      if (domjv.size() != pulljv.size())
+        return false;
+      for (Json::ArrayIndex ix=0; ix<domjv.size(); ix++)
+        if (!rps_pulled_json_same(domjv[ix], pulljv[ix]))
+          return false;
+      return true;
+    case Json::objectValue:
+      if (domjv.size() != pulljv.size())
+        return false;
+      for (auto& name : domjv.getMemberNames())
+        if (!pulljv.isMember(name)
+            || !rps_pulled_json_same(domjv[name], pulljv[name]))
+          return false;
+      return true;
+    default:
+      return domjv == pulljv;
+    }
+} // end rps_pulled_json_same
+
+static std::string_view
+rps_pull_member(const std::vector<std::pair<std::string,std::string_view>>&membvec,
+                const char*key)
+{
+  for (auto& memb : membvec)
+    if (memb.first == key)
+      return memb.second;
+  return std::string_view();
+} // end rps_pull_member
+
+static bool
+rps_pull_looks_like_oid(const std::string&str)
+{
+  return str.size() == Rps_Id::nbchars && str[0] == '_' && isalnum(str[1])
+         && std::all_of(str.begin()+1, str.end(),
+                        [](char c)
+  {
+    return strchr(Rps_Id::b62digits, c) != nullptr;
+  });
+} // end rps_pull_looks_like_oid
+
+/// the loaded object of a given oid
+static Rps_ObjectRef
+rps_load_objref_of_id(Rps_Id oid, Rps_Loader*ld)
+{
+  RPS_ASSERT(ld != nullptr);
+  Rps_ObjectRef obr= ld->find_object_by_oid(oid);
+  if (!obr)
+    {
+      RPS_WARNOUT("unknown oid " << oid);
+      throw  std::runtime_error(std::string{"unknown oid "} + oid.to_string());
+    }
+  return obr;
+} // end rps_load_objref_of_id
+
+/// like Rps_ObjectRef(const Json::Value&,Rps_Loader*) on a string
+static Rps_ObjectRef
+rps_pull_objref_of_string(const std::string&str, Rps_Loader*ld)
+{
+  RPS_ASSERT(ld != nullptr);
+  Rps_Id oid;
+  if (str.empty() || !(oid = Rps_Id(str)).valid())
+    throw std::runtime_error(std::string("pulled JSON string is not an object id:") + str);
+  return rps_load_objref_of_id(oid, ld);
+} // end rps_pull_objref_of_string
+
+static Rps_ObjectRef
+rps_pull_objref(Rps_JsonPullParser&jp, Rps_Loader*ld)
+{
+  if (jp.peek() != '"')
+    throw std::runtime_error("pulled JSON is not an object id");
+  return rps_pull_objref_of_string(jp.parse_string(), ld);
+} // end rps_pull_objref
+
+/// like Rps_Value(const Json::Value&,Rps_Loader*), but pulled; rare
+/// compound values fallback to a Json::Value of their own text
+static Rps_Value
+rps_pull_value(Rps_JsonPullParser&jp, Rps_Loader*ld)
+{
+  RPS_ASSERT(ld != nullptr);
+  char c = jp.peek();
+  if (c == '"')
+    {
+      std::string str = jp.parse_string();
+      if (rps_pull_looks_like_oid(str))
+        return Rps_ObjectValue(rps_pull_objref_of_string(str, ld));
+      return Rps_StringValue(str);
+    }
+  else if (c == '-' || isdigit(c))
+    {
+      std::int64_t i = 0;
+      double d = 0.0;
+      if (jp.parse_number(i, d))
+        return Rps_Value(i, Rps_Value::Rps_IntTag{});
+      RPS_ASSERT(!std::isnan(d));
+      return Rps_Value(d, Rps_Value::Rps_DoubleTag{});
+    }
+  else if (jp.consume_literal("null"))
+    return Rps_Value(nullptr);
+  else if (c == '{')
+    {
+      const char*objstart = jp.position();
+      auto membvec = jp.object_members();
+      std::string_view objtext(objstart, jp.position() - objstart);
+      std::string_view vtypetext = rps_pull_member(membvec, "vtype");
+      if (membvec.size() == 1 && membvec[0].first == "string"
+          && !membvec[0].second.empty() && membvec[0].second[0] == '"')
+        {
+          Rps_JsonPullParser subjp(membvec[0].second);
+          return Rps_StringValue(subjp.parse_string());
+        }
+      std::string vtype;
+      if (!vtypetext.empty() && vtypetext[0] == '"')
+        {
+          Rps_JsonPullParser subjp(vtypetext);
+          vtype = subjp.parse_string();
+        }
+      std::string_view elemtext = rps_pull_member(membvec, "elem");
+      std::string_view comptext = rps_pull_member(membvec, "comp");
+      if (vtype == "set" && membvec.size() == 2
+          && !elemtext.empty() && elemtext[0] == '[')
+        {
+          std::set<Rps_ObjectRef> setobr;
+          Rps_JsonPullParser subjp(elemtext);
+          subjp.expect('[');
+          if (!subjp.consume(']'))
+            {
+              do
+                {
+                  auto obrelem = rps_pull_objref(subjp, ld);
+                  if (obrelem)
+                    setobr.insert(obrelem);
+                }
+              while (subjp.consume(','));
+              subjp.expect(']');
+            }
+          return Rps_SetValue(setobr);
+        }
+      else if (vtype == "tuple" && membvec.size() == 2
+               && !comptext.empty() && comptext[0] == '[')
+        {
+          std::vector<Rps_ObjectRef> vecobr;
+          Rps_JsonPullParser subjp(comptext);
+          subjp.expect('[');
+          if (!subjp.consume(']'))
+            {
+              do
+                {
+                  if (subjp.consume_literal("null"))
+                    vecobr.push_back(Rps_ObjectRef(nullptr));
+                  else
+                    vecobr.push_back(rps_pull_objref(subjp, ld));
+                }
+              while (subjp.consume(','));
+              subjp.expect(']');
+            }
+          return Rps_TupleValue(vecobr);
+        }
+      else if (vtype == "closure")
+        {
+          std::string_view fntext = rps_pull_member(membvec, "fn");
+          std::string_view envtext = rps_pull_member(membvec, "env");
+          if (!fntext.empty() && !envtext.empty() && envtext[0] == '[')
+            {
+              Rps_JsonPullParser fnjp(fntext);
+              auto funobr = rps_pull_objref(fnjp, ld);
+              std::vector<Rps_Value> vecenv;
+              Rps_JsonPullParser envjp(envtext);
+              envjp.expect('[');
+              if (!envjp.consume(']'))
+                {
+                  do
+                    vecenv.push_back(rps_pull_value(envjp, ld));
+                  while (envjp.consume(','));
+                  envjp.expect(']');
+                }
+              Rps_ClosureValue thisclos(funobr, vecenv);
+              std::string_view metaobtext = rps_pull_member(membvec, "metaobj");
+              if (!metaobtext.empty())
+                {
+                  Rps_JsonPullParser metajp(metaobtext);
+                  auto metaobr = rps_pull_objref(metajp, ld);
+                  std::int64_t metark = 0;
+                  double d = 0.0;
+                  std::string_view metarktext = rps_pull_member(membvec, "metarank");
+                  if (!metarktext.empty())
+                    {
+                      Rps_JsonPullParser rkjp(metarktext);
+                      if (!rkjp.parse_number(metark, d))
+                        metark = (std::int64_t)d;
+                    }
+                  thisclos->put_persistent_metadata(metaobr, (int32_t)metark);
+                }
+              return thisclos;
+            }
+        }
+      /// instances, JSON values, hash tries, numerical vectors, and
+      /// anything strange, are rare enough to use a Json::Value
+      Json::Value jv = rps_load_string_view_to_json(objtext);
+      return Rps_Value(jv, ld);
+    }
+  /// arrays, booleans: fallback to the Json::Value decoding
+  std::string_view valtext = jp.skip_value();
+  Json::Value jv = rps_load_string_view_to_json(valtext);
+  return Rps_Value(jv, ld);
+} // end rps_pull_value
+
+
+/// decode the usual members of an object directly from its text; the
+/// other ones (for payloads, magic getters, applying functions) are
+/// put in a small Json::Value given to load_object_extra_members
+bool
+Rps_Loader::pull_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
+    Rps_Id objid, std::string_view objbuf, unsigned count)
+{
+  Rps_JsonPullParser jp(objbuf);
+  std::vector<std::pair<std::string,std::string_view>> membvec;
+  /// the whole text is scanned before any change, so on syntax errors
+  /// the DOM path reports them
+  try
+    {
+      membvec = jp.object_members();
+    }
+  catch (const std::exception&)
+    {
+      return false;
+    }
+  if (!rps_pull_member(membvec, "loadrout").empty())
+    return false;
+  Json::Value objjson(Json::objectValue);
+  for (auto& memb : membvec)
+    if (memb.first != "attrs" && memb.first != "comps")
+      objjson[memb.first] = rps_load_string_view_to_json(memb.second);
+  if (objjson["oid"].asString() != objid.to_string())
+    RPS_FATALOUT("pull_json_buffer_second_pass spacid=" << spacid
+                 << " lineno:" << lineno
+                 << " objid:" << objid
+                 << " unexpected");
+  auto obz = Rps_ObjectZone::find(objid);
+  if (!obz)
+    RPS_FATALOUT("pull_json_buffer_second_pass spacid=" << spacid
+                 << " lineno:" << lineno
+                 << " unknown objid:" << objid);
+  auto obzspace = Rps_ObjectZone::find(spacid);
+  {
+    Rps_JsonPullParser classjp(rps_pull_member(membvec, "class"));
+    obz->loader_set_class (this, rps_pull_objref(classjp, this));
+  }
+  RPS_ASSERT (obzspace);
+  obz->loader_set_space (this, obzspace);
+  obz->loader_set_mtime (this, clamped_mtime(objjson["mtime"].asDouble(),
+                         objid, spacid, lineno));
+  std::string_view compstext = rps_pull_member(membvec, "comps");
+  if (!compstext.empty())
+    {
+      Rps_JsonPullParser compjp(compstext);
+      if (compjp.consume('['))
+        {
+          if (!compjp.consume(']'))
+            {
+              do
+                obz->loader_add_comp(this, rps_pull_value(compjp, this));
+              while (compjp.consume(','));
+              compjp.expect(']');
+            }
+        }
+      else
+        RPS_WARNOUT("pull_json_buffer_second_pass spacid=" << spacid
+                    << " lineno:" << lineno
+                    << " objid:" << objid
+                    << " bad comps:" << compstext);
+    }
+  std::string_view attrstext = rps_pull_member(membvec, "attrs");
+  if (!attrstext.empty())
+    {
+      Rps_JsonPullParser attrjp(attrstext);
+      if (attrjp.consume('['))
+        {
+          if (!attrjp.consume(']'))
+            {
+              do
+                {
+                  if (attrjp.peek() != '{')
+                    {
+                      attrjp.skip_value();
+                      continue;
+                    }
+                  auto entvec = attrjp.object_members();
+                  std::string_view attext = rps_pull_member(entvec, "at");
+                  std::string_view vatext = rps_pull_member(entvec, "va");
+                  if (attext.empty() || vatext.empty())
+                    continue;
+                  Rps_JsonPullParser atjp(attext);
+                  auto atobr = rps_pull_objref(atjp, this);
+                  RPS_ASSERT(atobr);
+                  Rps_JsonPullParser vajp(vatext);
+                  auto atval = rps_pull_value(vajp, this);
+                  RPS_ASSERT(atval);
+                  obz->loader_put_attr(this, atobr, atval);
+                }
+              while (attrjp.consume(','));
+              attrjp.expect(']');
+            }
+        }
+      else
+        RPS_WARNOUT("pull_json_buffer_second_pass spacid=" << spacid
+                    << " lineno:" << lineno
+                    << " objid:" << objid
+                    << " bad attrs:" << attrstext);
+    }
+  load_object_extra_members(obz, objjson, spacid, lineno, objid, count);
+  return true;
+} // end of Rps_Loader::pull_json_buffer_second_pass
+
+/// Only the object texts are checked; binary spaces are skipped. The
+/// members other than attrs and comps are also parsed by jsoncpp when
+/// loading, but are compared here too.
+unsigned
+Rps_Loader::check_pull_parser(void)
+{
+  unsigned nbobj = 0;
+  unsigned nbmismatch = 0;
+  double startim = rps_elapsed_real_time();
+  for (Rps_Id spacid: ld_spaceset)
+    {
+      (void) mapped_space_file(spacid);
+      if (binary_space(spacid))
+        continue;
+      std::string_view prolog;
+      each_object_in_space(spacid, prolog,
+                           [&](Rps_Id objid, unsigned lineno, std::string_view objtext)
+      {
+        nbobj++;
+        Json::Value domjv = rps_load_string_view_to_json(objtext);
+        Json::Value pulljv;
+        try
+          {
+            Rps_JsonPullParser jp(objtext);
+            pulljv = rps_pull_json(jp);
+            if (!jp.at_end())
+              throw std::runtime_error("trailing text after pulled JSON");
+          }
+        catch (const std::exception&exc)
+          {
+            RPS_WARNOUT("check_pull_parser spacid=" << spacid
+                        << " lineno:" << lineno
+                        << " objid:" << objid
+                        << " pull parsing failed: " << exc.what());
+            nbmismatch++;
+            return;
+          }
+        if (!rps_pulled_json_same(domjv, pulljv))
+          {
+            RPS_WARNOUT("check_pull_parser spacid=" << spacid
+                        << " lineno:" << lineno
+                        << " objid:" << objid
+                        << " pulled JSON differs:" << std::endl
+                        << pulljv << std::endl
+                        << "from jsoncpp one:" << std::endl
+                        << domjv);
+            nbmismatch++;
+          }
+      });
+    }
+  RPS_INFORMOUT("check_pull_parser compared " << nbobj << " objects with "
+                << nbmismatch << " mismatches in "
+                << (rps_elapsed_real_time() - startim) << " sec");
+  return nbmismatch;
+} // end Rps_Loader::check_pull_parser
+
+/// like Rps_Value(const Json::Value&,Rps_Loader*) on a tagged value
+/// of a binary space file; generic JSON ones use it
+static Rps_Value
+rps_binstore_load_value(Rps_BinStoreReader&rd, const Rps_BinStoreSpace&bsp, Rps_Loader*ld)
+{
+  RPS_ASSERT(ld != nullptr);
+  switch (rd.byte())
+    {
+    case Rps_BinStoreSpace::bstag_null:
+      return Rps_Value(nullptr);
+    case Rps_BinStoreSpace::bstag_int:
+      return Rps_Value((std::int64_t)rd.zigzag(), Rps_Value::Rps_IntTag{});
+    case Rps_BinStoreSpace::bstag_real:
+    {
+      double d = rd.float64();
+      /// integral reals are integers, as Json::Value::isInt64 says
+      if (d >= (double)INT64_MIN && d < (double)INT64_MAX && std::trunc(d) == d)
+        return Rps_Value((std::int64_t)d, Rps_Value::Rps_IntTag{});
+      RPS_ASSERT(!std::isnan(d));
+      return Rps_Value(d, Rps_Value::Rps_DoubleTag{});
+    }
+    case Rps_BinStoreSpace::bstag_string:
+      return Rps_StringValue(std::string(bsp.string_at(rd.varint())));
+    case Rps_BinStoreSpace::bstag_objref:
+      return Rps_ObjectValue(rps_load_objref_of_id(bsp.oid_at(rd.varint()), ld));
+    case Rps_BinStoreSpace::bstag_set:
+    {
+      std::set<Rps_ObjectRef> setobr;
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        setobr.insert(rps_load_objref_of_id(bsp.oid_at(rd.varint()), ld));
+      return Rps_SetValue(setobr);
+    }
+    case Rps_BinStoreSpace::bstag_tuple:
+    {
+      std::vector<Rps_ObjectRef> vecobr;
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        {
+          uint64_t oidix = rd.varint();
+          if (oidix == 0)
+            vecobr.push_back(Rps_ObjectRef(nullptr));
+          else
+            vecobr.push_back(rps_load_objref_of_id(bsp.oid_at(oidix-1), ld));
+        }
+      return Rps_TupleValue(vecobr);
+    }
+    case Rps_BinStoreSpace::bstag_closure:
+    {
+      auto funobr = rps_load_objref_of_id(bsp.oid_at(rd.varint()), ld);
+      std::vector<Rps_Value> vecenv;
+      uint64_t nb = rd.varint();
+      for (uint64_t ix=0; ix<nb; ix++)
+        vecenv.push_back(rps_binstore_load_value(rd, bsp, ld));
+      Rps_ClosureValue thisclos(funobr, vecenv);
+      uint64_t metaix = rd.varint();
+      if (metaix > 0)
+        {
+          auto metaobr = rps_load_objref_of_id(bsp.oid_at(metaix-1), ld);
+          int32_t metark = (int32_t) rd.zigzag();
+          thisclos->put_persistent_metadata(metaobr, metark);
+        }
+      return thisclos;
+    }
+    case Rps_BinStoreSpace::bstag_json:
+    {
+      Json::Value jv = bsp.read_json(rd);
+      return Rps_Value(jv, ld);
+    }
+    default:
+      break;
+    }
+  throw std::runtime_error("bad value tag in binary space file " + bsp.path());
+} // end rps_binstore_load_value
+
+/// load an object from its record in a binary space file; records
+/// keeping the JSON text of their object are parsed as usual
+void
+Rps_Loader::binary_record_second_pass (const Rps_BinStoreSpace&bsp, Rps_Id spacid,
+                                       unsigned lineno, Rps_Id objid,
+                                       std::string_view record, unsigned count)
+{
+  Rps_BinStoreReader rd(record);
+  Rps_Id recoid;
+  unsigned reclineno = 0;
+  if (bsp.record_start(rd, recoid, reclineno) == Rps_BinStoreSpace::bsrec_text)
+    {
+      parse_json_buffer_second_pass(spacid, lineno, objid,
+                                    bsp.string_at(rd.varint()), count);
+      return;
+    }
+  if (recoid != objid)
+    RPS_FATALOUT("binary_record_second_pass spacid=" << spacid
+                 << " lineno:" << lineno
+                 << " objid:" << objid
+                 << " unexpected");
+  /// the head and tail texts are only needed to convert back to JSON
+  (void) rd.varint();
+  (void) rd.varint();
+  Rps_Id classid = bsp.oid_at(rd.varint());
+  double mtim = rd.float64();
+  auto obz = Rps_ObjectZone::find(objid);
+  if (!obz)
+    RPS_FATALOUT("binary_record_second_pass spacid=" << spacid
+                 << " lineno:" << lineno
+                 << " unknown objid:" << objid);
+  auto obzspace = Rps_ObjectZone::find(spacid);
+  obz->loader_set_class (this, rps_load_objref_of_id(classid, this));
+  RPS_ASSERT (obzspace);
+  obz->loader_set_space (this, obzspace);
+  obz->loader_set_mtime (this, clamped_mtime(mtim, objid, spacid, lineno));
+  uint64_t nbcomps = rd.varint();
+  if (nbcomps > 1)
+    {
+      obz->loader_reserve_comps(this, (unsigned)std::min<uint64_t>(nbcomps-1, record.size()));
+      for (uint64_t cix=1; cix<nbcomps; cix++)
+        obz->loader_add_comp(this, rps_binstore_load_value(rd, bsp, this));
+    }
+  uint64_t nbattrs = rd.varint();
+  for (uint64_t aix=1; aix<nbattrs; aix++)
+    {
+      auto atobr = rps_load_objref_of_id(bsp.oid_at(rd.varint()), this);
+      auto atval = rps_binstore_load_value(rd, bsp, this);
+      RPS_ASSERT(atval);
+      obz->loader_put_attr(this, atobr, atval);
+    }
+  Json::Value objjson = bsp.read_json(rd);
+  if (!objjson.isObject())
+    RPS_FATALOUT("binary_record_second_pass spacid=" << spacid
+                 << " lineno:" << lineno
+                 << " objid:" << objid
+                 << " bad extra members:" << objjson);
+  objjson["oid"] = Json::Value(objid.to_string());
+  objjson["class"] = Json::Value(classid.to_string());
+  objjson["mtime"] = Json::Value(mtim);
+  load_object_extra_members(obz, objjson, spacid, lineno, objid, count);
+} // end of Rps_Loader::binary_record_second_pass
+
+/// loaded modification times are limited to five minutes after the
+/// start of loading
+double
+Rps_Loader::clamped_mtime(double mtim, Rps_Id objid, Rps_Id spacid, unsigned lineno)
+{
+  if (mtim > this->ld_startclock + 300.0)
+    {
+      double cormtim = this->ld_startclock + 300.0;
+      RPS_WARNOUT("parse_json_buffer_second_pass mtime of object " << objid
+                  << " is too far in the future in  spacid=" << spacid
+                  << " lineno:" << lineno
+                  << " changed from " << mtim << " to " << cormtim);
+      mtim = cormtim;
+    }
+  return mtim;
+} // end Rps_Loader::clamped_mtime
+
 ////////////////
 void
 Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
-    Rps_Id objid, const std::string& objbuf, unsigned count)
+    Rps_Id objid, std::string_view objbuf, unsigned count)
 {
   RPS_DEBUG_LOG(LOAD, "parse_json_buffer_second_pass start spacid=" << spacid << " #" << count
                 << " lineno=" <<lineno
                 << " objid=" <<objid
                 << " objbuf:\n" << objbuf);
+  /// lines starting with # are skipped, so need a filtered copy
+  bool withhashlines = (!objbuf.empty() && objbuf[0] == '#')
+                       || objbuf.find("\n#") != std::string_view::npos;
+  if (RPS_LIKELY(!withhashlines)
+      && pull_json_buffer_second_pass(spacid, lineno, objid, objbuf, count))
+    return;
   Json::Value objjson;
   try
     {
-      objjson = rps_load_string_to_json(objbuf);
+      if (RPS_UNLIKELY(withhashlines))
+        {
+          std::string filtbuf;
+          filtbuf.reserve(objbuf.size());
+          size_t pos = 0;
+          while (pos < objbuf.size())
+            {
+              size_t eol = objbuf.find('\n', pos);
+              if (eol == std::string_view::npos)
+                eol = objbuf.size();
+              if (objbuf[pos] != '#')
+                {
+                  filtbuf.append(objbuf.data()+pos, eol-pos);
+                  filtbuf.push_back('\n');
+                }
+              pos = eol+1;
+            }
+          objjson = rps_load_string_to_json(filtbuf);
+        }
+      else
+        objjson = rps_load_string_view_to_json(objbuf);
       if (objjson.type() != Json::objectValue)
         RPS_FATALOUT("parse_json_buffer_second_pass spacid=" << spacid
                      << " lineno:" << lineno
@@ -576,17 +1890,8 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
   obz->loader_set_class (this, Rps_ObjectRef(objjson["class"], this));
   RPS_ASSERT (obzspace);
   obz->loader_set_space (this, obzspace);
-  double mtim =  objjson["mtime"].asDouble();
-  if (mtim > this->ld_startclock + 300.0)
-    {
-      double cormtim = this->ld_startclock + 300.0;
-      RPS_WARNOUT("parse_json_buffer_second_pass mtime of object " << objid
-                  << " is too far in the future in  spacid=" << spacid
-                  << " lineno:" << lineno
-                  << " changed from " << mtim << " to " << cormtim);
-      mtim = cormtim;
-    }
-  obz->loader_set_mtime (this,mtim);
+  obz->loader_set_mtime (this, clamped_mtime(objjson["mtime"].asDouble(),
+                         objid, spacid, lineno));
   if (objjson.isMember("comps"))
     {
       auto compjson = objjson["comps"];
@@ -639,10 +1944,128 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
                          << " objid:" << objid
                          << " bad attrjson:" << attrjson);
     }
+  load_object_extra_members(obz, objjson, spacid, lineno, objid, count);
+} // end of Rps_Loader::parse_json_buffer_second_pass
+
+
+////////////////////////////////////////////////////////////////
+//// resolved symbols: thousands of loaded objects need a rpsapply*,
+//// rpsget* or rpsldpy_* function of the program. Instead of as many
+//// dlsym calls, serialized since dlsym is not reentrant, all of them
+//// are collected at once from the dynamic symbol table of the
+//// executable, read with libelf, relocated by its load bias and
+//// checked against dlsym on one of them. Other names, e.g. of
+//// loading routines or in plugins, still go thru dlsym.
+
+static std::unordered_map<std::string,void*> rps_load_symbmap;
+static std::once_flag rps_load_symbonce;
+
+static int
+rps_load_program_bias(struct dl_phdr_info*info, size_t, void*data)
+{
+  /// the main program comes first
+  *(uintptr_t*)data = (uintptr_t)info->dlpi_addr;
+  return 1;
+} // end rps_load_program_bias
+
+static bool
+rps_load_is_resolved_symbol(const char*name)
+{
+  return !strncmp(name, RPS_APPLYINGFUN_PREFIX, sizeof(RPS_APPLYINGFUN_PREFIX)-1)
+         || !strncmp(name, RPS_GETTERFUN_PREFIX, sizeof(RPS_GETTERFUN_PREFIX)-1)
+         || !strncmp(name, RPS_PAYLOADING_PREFIX, sizeof(RPS_PAYLOADING_PREFIX)-1);
+} // end rps_load_is_resolved_symbol
+
+static void
+rps_load_collect_symbols(void)
+{
+  double startrealt = rps_elapsed_real_time();
+  uintptr_t bias = 0;
+  dl_iterate_phdr(rps_load_program_bias, &bias);
+  int fd = open("/proc/self/exe", O_RDONLY|O_CLOEXEC);
+  if (fd < 0)
+    {
+      RPS_WARNOUT("rps_load_collect_symbols cannot open /proc/self/exe: "
+                  << strerror(errno));
+      return;
+    };
+  Elf*elf = elf_begin(fd, ELF_C_READ, nullptr);
+  if (!elf)
+    {
+      RPS_WARNOUT("rps_load_collect_symbols cannot read ELF of /proc/self/exe: "
+                  << elf_errmsg(-1));
+      close(fd);
+      return;
+    };
+  Elf_Scn*scn = nullptr;
+  while ((scn = elf_nextscn(elf, scn)) != nullptr)
+    {
+      GElf_Shdr shdr;
+      if (!gelf_getshdr(scn, &shdr) || shdr.sh_type != SHT_DYNSYM
+          || shdr.sh_entsize == 0)
+        continue;
+      Elf_Data*data = elf_getdata(scn, nullptr);
+      if (!data)
+        continue;
+      size_t nbsym = shdr.sh_size / shdr.sh_entsize;
+      for (size_t ix=1; ix<nbsym; ix++)
+        {
+          GElf_Sym sym;
+          if (!gelf_getsym(data, (int)ix, &sym)
+              || sym.st_shndx == SHN_UNDEF
+              || GELF_ST_TYPE(sym.st_info) != STT_FUNC)
+            continue;
+          const char*name = elf_strptr(elf, shdr.sh_link, sym.st_name);
+          if (name && rps_load_is_resolved_symbol(name))
+            rps_load_symbmap.insert({name, (void*)(bias + sym.st_value)});
+        }
+    }
+  elf_end(elf);
+  close(fd);
+  if (!rps_load_symbmap.empty())
+    {
+      auto it = rps_load_symbmap.begin();
+      void*ad = dlsym(rps_proghdl, it->first.c_str());
+      if (ad != it->second)
+        {
+          RPS_WARNOUT("rps_load_collect_symbols got " << it->second
+                      << " for " << it->first << " but dlsym gives " << ad
+                      << ", so ignores " << rps_load_symbmap.size() << " symbols");
+          rps_load_symbmap.clear();
+        }
+    };
+  RPS_DEBUG_LOG(LOAD, "rps_load_collect_symbols collected " << rps_load_symbmap.size()
+                << " symbols in " << (rps_elapsed_real_time() - startrealt) << " s");
+} // end rps_load_collect_symbols
+
+void*
+Rps_Loader::resolve_symbol(const char*name)
+{
+  RPS_ASSERT(name != nullptr);
+  std::call_once(rps_load_symbonce, rps_load_collect_symbols);
+  auto it = rps_load_symbmap.find(name);
+  if (it != rps_load_symbmap.end())
+    return it->second;
+  /// perhaps defined by a --plugin-after-load plugin, still being
+  /// dlopen-ed
+  rps_wait_plugins_loading();
+  std::lock_guard<std::recursive_mutex> gu(ld_mtx);
+  return dlsym(rps_proghdl, name);
+} // end Rps_Loader::resolve_symbol
+
+
+/// load the members of an object which are not handled by the pull
+/// parser: magic attribute getter, applying function, payload and
+/// custom loading routine
+void
+Rps_Loader::load_object_extra_members(Rps_ObjectZone*obz, const Json::Value&objjson,
+                                      Rps_Id spacid, unsigned lineno,
+                                      Rps_Id objid, unsigned count)
+{
+  RPS_ASSERT(obz != nullptr);
   if (objjson.isMember("magicattr"))
     {
       RPS_DEBUG_LOG(LOAD, "parse_json_buffer_second_pass magicattr objid=" << objid);
-      std::lock_guard<std::recursive_mutex> gu(ld_mtx);
       char getfunambuf[sizeof(RPS_GETTERFUN_PREFIX)+8+Rps_Id::nbchars];
       memset(getfunambuf, 0, sizeof(getfunambuf));
       char obidbuf[32];
@@ -651,7 +2074,7 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
       strcpy(getfunambuf, RPS_GETTERFUN_PREFIX);
       strcat(getfunambuf+strlen(RPS_GETTERFUN_PREFIX), obidbuf);
       RPS_ASSERT(strlen(getfunambuf)<sizeof(getfunambuf)-4);
-      void*funad = dlsym(rps_proghdl, getfunambuf);
+      void*funad = resolve_symbol(getfunambuf);
       if (!funad)
         RPS_FATALOUT("cannot dlsym " << getfunambuf << " for magic attribute getter of objid:" <<  objid
                      << " lineno:" << lineno << ", spacid:" << spacid
@@ -661,7 +2084,6 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
   if (objjson.isMember("applying"))
     {
       RPS_DEBUG_LOG(LOAD, "parse_json_buffer_second_pass applying objid=" << objid);
-      std::lock_guard<std::recursive_mutex> gu(ld_mtx);
       char appfunambuf[sizeof(RPS_APPLYINGFUN_PREFIX)+8+Rps_Id::nbchars];
       memset(appfunambuf, 0, sizeof(appfunambuf));
       char obidbuf[32];
@@ -670,7 +2092,7 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
       strcpy(appfunambuf, RPS_APPLYINGFUN_PREFIX);
       strcat(appfunambuf+strlen(RPS_APPLYINGFUN_PREFIX), obidbuf);
       RPS_ASSERT(strlen(appfunambuf)<sizeof(appfunambuf)-4);
-      void*funad = dlsym(rps_proghdl, appfunambuf);
+      void*funad = resolve_symbol(appfunambuf);
       if (!funad)
         RPS_FATALOUT("cannot dlsym " << appfunambuf << " for applying function of objid:" <<  objid
                      << " lineno:" << lineno << ", spacid:" << spacid
@@ -690,7 +2112,7 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
             if (isalpha(firstc))
               {
                 std::string symstr = std::string(RPS_PAYLOADING_PREFIX) + paylstr;
-                void* symad = dlsym(rps_proghdl, symstr.c_str());
+                void* symad = resolve_symbol(symstr.c_str());
                 if (!symad)
                   RPS_FATALOUT("cannot dlsym " << symstr << " for payload of objid:" <<  objid
                                << " lineno:" << lineno << ", spacid:" << spacid
@@ -718,7 +2140,10 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
       };
       if (pldfun)
         {
+          double startim = RPS_UNLIKELY(ld_profiling) ? rps_elapsed_real_time() : 0.0;
           (*pldfun)(obz,this,objjson,spacid,lineno);
+          if (RPS_UNLIKELY(ld_profiling))
+            profile_payload(paylstr, rps_elapsed_real_time() - startim);
         }
       else
         {
@@ -730,27 +2155,10 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
                        << std::endl);
         }
     }; //// end handling of "payload" JSON member
-  if (obz->is_instance_of(RPS_ROOT_OB(_3O1QUNKZ4bU02amQus) //∈rps_routine
-                         ))
-    {
-      std::lock_guard<std::recursive_mutex> gu(ld_mtx);
-      char appfunambuf[sizeof(RPS_APPLYINGFUN_PREFIX)+8+Rps_Id::nbchars];
-      memset(appfunambuf, 0, sizeof(appfunambuf));
-      char obidbuf[32];
-      memset (obidbuf, 0, sizeof(obidbuf));
-      obz->oid().to_cbuf24(obidbuf);
-      strcpy(appfunambuf, RPS_APPLYINGFUN_PREFIX);
-      strcat(appfunambuf+strlen(RPS_APPLYINGFUN_PREFIX), obidbuf);
-      RPS_ASSERT(strlen(appfunambuf)<sizeof(appfunambuf)-4);
-      void*funad = dlsym(rps_proghdl, appfunambuf);
-      if (!funad)
-        RPS_WARNOUT("cannot dlsym " << appfunambuf << " for applying function of objid:" <<  objid
-                    << Rps_ObjectRef(obz)
-                    << " lineno:" << lineno << ", spacid:" << spacid
-                    << ":: " << dlerror());
-      else
-        obz->loader_put_applyingfunction(this, reinterpret_cast<rps_applyingfun_t*>(funad));
-    };
+  if (ld_curchunk)
+    ld_curchunk->spc_routines.push_back({obz, lineno});
+  else
+    install_routine_applying_function(obz, spacid, lineno);
 
   if (objjson.isMember("loadrout"))
     {
@@ -763,7 +2171,7 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
                     << std::endl << objjson);
       else
         {
-          void*ldroutad = dlsym(rps_proghdl, loadroutstr.c_str());
+          void*ldroutad = resolve_symbol(loadroutstr.c_str());
           if (!ldroutad)
             RPS_WARNOUT("cannot dlsym " << loadroutstr
                         << " for loading routine function of objid:" <<  objid
@@ -774,90 +2182,465 @@ Rps_Loader::parse_json_buffer_second_pass (Rps_Id spacid, unsigned lineno,
           (*ldrout)(obz, this, objjson, spacid, lineno);
         };
     };        // end if has "loadrout" member
-  RPS_DEBUG_LOG(LOAD, "parse_json_buffer_second_pass end objid=" << objid << " #" << count
+  RPS_DEBUG_LOG(LOAD, "load_object_extra_members end objid=" << objid << " #" << count
                 << std::endl);
-} // end of Rps_Loader::parse_json_buffer_second_pass
+} // end of Rps_Loader::load_object_extra_members
+
+/// instances of rps_routine get their applying function by name
+void
+Rps_Loader::install_routine_applying_function(Rps_ObjectZone*obz, Rps_Id spacid, unsigned lineno)
+{
+  RPS_ASSERT(obz != nullptr);
+  if (!obz->is_instance_of(RPS_ROOT_OB(_3O1QUNKZ4bU02amQus) //∈rps_routine
+                          ))
+    return;
+  char appfunambuf[sizeof(RPS_APPLYINGFUN_PREFIX)+8+Rps_Id::nbchars];
+  memset(appfunambuf, 0, sizeof(appfunambuf));
+  char obidbuf[32];
+  memset (obidbuf, 0, sizeof(obidbuf));
+  obz->oid().to_cbuf24(obidbuf);
+  strcpy(appfunambuf, RPS_APPLYINGFUN_PREFIX);
+  strcat(appfunambuf+strlen(RPS_APPLYINGFUN_PREFIX), obidbuf);
+  RPS_ASSERT(strlen(appfunambuf)<sizeof(appfunambuf)-4);
+  void*funad = resolve_symbol(appfunambuf);
+  if (!funad)
+    RPS_WARNOUT("cannot dlsym " << appfunambuf << " for applying function of objid:" <<  obz->oid()
+                << Rps_ObjectRef(obz)
+                << " lineno:" << lineno << ", spacid:" << spacid
+                << ":: " << dlerror());
+  else
+    obz->loader_put_applyingfunction(this, reinterpret_cast<rps_applyingfun_t*>(funad));
+} // end of Rps_Loader::install_routine_applying_function
 
 ////////////////////////////////////////////////////////////////
 
 
-void
-Rps_Loader::second_pass_space(Rps_Id spacid)
+////////////////////////////////////////////////////////////////
+//// lazy loading: with --lazy-load, the second pass gives most
+//// objects only their class, space and modification time, and
+//// remembers where their text or binary record is. Their
+//// attributes, components, payload and functions are decoded by
+//// materialize_object, on first use thru Rps_ObjectZone::materialize
+//// or from a background thread. Roots, constants, classes, symbols,
+//// spaces and objects with an unusual payload or a magic getter or
+//// a custom loading routine are loaded eagerly.
+
+/// the loader kept alive after loading while some objects are lazy
+static Rps_Loader* rps_lazy_loader;
+
+std::mutex rps_load_lazy_mutex;
+
+/// payloads whose loading routine only fills their owner, so can be
+/// deferred
+static const std::set<std::string> rps_lazy_payloads =
 {
-  RPS_DEBUG_LOG(LOAD, "Rps_Loader::second_pass_space start spacid:" << spacid
-                << std::endl << RPS_FULL_BACKTRACE(0, "RpsLoader::second_pass_space"));
-  auto spacepath = load_real_path(space_file_path(spacid));
-  std::ifstream ins(spacepath);
-  unsigned lincnt = 0;
-  unsigned obcnt = 0;
-  Rps_Id prevoid;
-  unsigned prevlin=0;
-  std::string objbuf;
-  for (std::string linbuf; std::getline(ins, linbuf); )
+  "objmap", "setob", "string_buffer", "string_dictionary",
+  "value_map", "vectob", "vectval",
+};
+
+/// register an object of the second pass as lazy, giving false when
+/// it should be loaded now
+bool
+Rps_Loader::defer_object_second_pass (Rps_Id spacid, unsigned lineno,
+                                      Rps_Id objid, std::string_view objtext,
+                                      unsigned count)
+{
+  static const std::set<Rps_Id> eageridset =
+  {
+#define RPS_INSTALL_ROOT_OB(Oid) Rps_Id(#Oid),
+#include "generated/rps-roots.hh"
+#define RPS_INSTALL_CONSTANT_OB(Oid) Rps_Id(#Oid),
+#include "generated/rps-constants.hh"
+  };
+  if (ld_globrootsidset.find(objid) != ld_globrootsidset.end()
+      || eageridset.find(objid) != eageridset.end())
+    return false;
+  Rps_ObjectZone*obz = Rps_ObjectZone::find(objid);
+  Rps_ObjectZone*obzspace = Rps_ObjectZone::find(spacid);
+  if (!obz || !obzspace)
+    return false;
+  Rps_ObjectRef obclass;
+  double mtim = 0.0;
+  try
     {
-      lincnt++;
-      if (linbuf.size() > 0 && linbuf[0] == '#')
-        continue;
-      Rps_Id curobjid;
-      if (is_object_starting_line(spacid,lincnt,linbuf,&curobjid))
+      std::string_view objbuf = objtext;
+      const Rps_BinStoreSpace*bsp = binary_space(spacid);
+      if (bsp)
         {
-          obcnt++;
-          RPS_DEBUG_LOG(LOAD, "secondpass lincnt="<< lincnt
-                        << " curobjid=" << curobjid
-                        << " obcnt=" << obcnt);
-          if (objbuf.size() > 0 && prevoid && prevlin>0)
+          Rps_BinStoreReader rd(objtext);
+          Rps_Id recoid;
+          unsigned reclineno = 0;
+          if (bsp->record_start(rd, recoid, reclineno) == Rps_BinStoreSpace::bsrec_text)
+            objbuf = bsp->string_at(rd.varint());
+          else
             {
-              try
+              if (recoid != objid)
+                return false;
+              (void) rd.varint();
+              (void) rd.varint();
+              obclass = rps_load_objref_of_id(bsp->oid_at(rd.varint()), this);
+              mtim = rd.float64();
+              uint64_t nbcomps = rd.varint();
+              for (uint64_t cix=1; cix<nbcomps; cix++)
+                bsp->skip_value(rd);
+              uint64_t nbattrs = rd.varint();
+              for (uint64_t aix=1; aix<nbattrs; aix++)
                 {
-                  parse_json_buffer_second_pass(spacid, prevlin, prevoid, objbuf, obcnt);
+                  (void) rd.varint();
+                  bsp->skip_value(rd);
                 }
-              catch (const std::exception& exc)
-                {
-                  RPS_FATALOUT("failed second pass in space " << spacid
-                               << " prevoid:" << prevoid
-                               << " line#" << prevlin
-                               << std::endl
-                               << "… got exception of type "
-                               << typeid(exc).name()
-                               << ":"
-                               << exc.what());
-                };
-              prevoid = Rps_Id(nullptr);
+              Json::Value objjson = bsp->read_json(rd);
+              if (!objjson.isObject()
+                  || objjson.isMember("magicattr") || objjson.isMember("loadrout"))
+                return false;
+              if (objjson.isMember("payload")
+                  && rps_lazy_payloads.find(objjson["payload"].asString()) == rps_lazy_payloads.end())
+                return false;
             }
-          objbuf.clear();
-          objbuf = linbuf + '\n';
-          prevoid = curobjid;
-          prevlin = lincnt;
         }
-      else if (objbuf.size() > 0)
+      if (!obclass)
         {
-          objbuf += linbuf;
-          objbuf += '\n';
+          /// texts with # lines are unusual, and filtered when loaded
+          if ((!objbuf.empty() && objbuf[0] == '#')
+              || objbuf.find("\n#") != std::string_view::npos)
+            return false;
+          Rps_JsonPullParser jp(objbuf);
+          auto membvec = jp.object_members();
+          if (!rps_pull_member(membvec, "magicattr").empty()
+              || !rps_pull_member(membvec, "loadrout").empty())
+            return false;
+          std::string_view payltext = rps_pull_member(membvec, "payload");
+          if (!payltext.empty()
+              && rps_lazy_payloads.find(rps_load_string_view_to_json(payltext).asString())
+              == rps_lazy_payloads.end())
+            return false;
+          std::string_view classtext = rps_pull_member(membvec, "class");
+          std::string_view mtimetext = rps_pull_member(membvec, "mtime");
+          if (classtext.empty() || mtimetext.empty())
+            return false;
+          Rps_JsonPullParser classjp(classtext);
+          obclass = rps_pull_objref(classjp, this);
+          mtim = rps_load_string_view_to_json(mtimetext).asDouble();
         }
-    } // end for getline
-  if (objbuf.size() > 0 && prevoid && prevlin>0)
+    }
+  catch (const std::exception&)
+    {
+      /// the eager loading reports the problem
+      return false;
+    };
+  if (!obclass || mtim <= 0.0)
+    return false;
+  obz->loader_set_class (this, obclass);
+  obz->loader_set_space (this, obzspace);
+  obz->loader_set_mtime (this, clamped_mtime(mtim, objid, spacid, lineno));
+  {
+    std::lock_guard<std::mutex> gu(ld_lazymtx);
+    ld_lazymap.insert({obz, lazy_object_st{spacid, lineno, count, objtext}});
+    ld_lazycount++;
+    obz->ob_lazystate.store(Rps_ObjectZone::OBLAZY_PENDING, std::memory_order_release);
+  }
+  return true;
+} // end of Rps_Loader::defer_object_second_pass
+
+void
+Rps_Loader::materialize_object(Rps_ObjectZone*obz)
+{
+  RPS_ASSERT(obz != nullptr);
+  lazy_object_st lzo;
+  {
+    std::lock_guard<std::mutex> gu(ld_lazymtx);
+    auto it = ld_lazymap.find(obz);
+    RPS_ASSERT(it != ld_lazymap.end());
+    lzo = it->second;
+    ld_lazymap.erase(it);
+  }
+  obz->ob_lazystate.store(Rps_ObjectZone::OBLAZY_LOADING);
+  /// the class, space or mtime might have been changed meanwhile
+  Rps_ObjectZone*obzclass = obz->ob_class.load();
+  Rps_ObjectZone*obzspace = obz->ob_space.load();
+  double mtim = obz->ob_mtime.load();
+  try
+    {
+      load_object_contents(lzo.lzo_spacid, lzo.lzo_lineno, obz->oid(),
+                           lzo.lzo_text, lzo.lzo_count);
+    }
+  catch (const std::exception& exc)
+    {
+      RPS_FATALOUT("failed to materialize lazy object " << obz->oid()
+                   << " of space " << lzo.lzo_spacid
+                   << " line#" << lzo.lzo_lineno
+                   << std::endl
+                   << "… got exception of type "
+                   << typeid(exc).name()
+                   << ":"
+                   << exc.what());
+    };
+  obz->change_class(obzclass);
+  obz->ob_space.store(obzspace);
+  obz->ob_mtime.store(mtim);
+  if (Rps_ObjectZone::ob_attrindexcount_.load() > 0)
+    {
+      std::lock_guard<std::recursive_mutex> guix(Rps_ObjectZone::ob_attrindexmtx_);
+      for (auto& atit : obz->ob_attrs)
+        Rps_ObjectZone::attr_index_change(obz, atit.first.optr(), nullptr, atit.second);
+    };
+  obz->ob_lazystate.store(Rps_ObjectZone::OBLAZY_NONE, std::memory_order_release);
+  if (ld_lazycount.fetch_sub(1) == 1 && ld_lazyloaded.load())
+    {
+      std::lock_guard<std::mutex> gu(ld_lazymtx);
+      unmap_space_files();
+      RPS_DEBUG_LOG(LOAD, "Rps_Loader materialized every lazy object");
+    }
+} // end of Rps_Loader::materialize_object
+
+/// once loading is done, the todo functions added by payload loaders
+/// run after materializing their object
+void
+Rps_Loader::run_lazy_todo_functions(void)
+{
+  if (!ld_lazyloaded.load() || ld_curchunk)
+    return;
+  while (run_some_todo_functions() > 0)
+    continue;
+} // end of Rps_Loader::run_lazy_todo_functions
+
+Rps_ObjectZone*
+Rps_Loader::some_lazy_object(void)
+{
+  std::lock_guard<std::mutex> gu(ld_lazymtx);
+  if (ld_lazymap.empty())
+    return nullptr;
+  return ld_lazymap.begin()->first;
+} // end of Rps_Loader::some_lazy_object
+
+/// the objects being materialized by other threads are finished there
+void
+Rps_Loader::materialize_all_objects(void)
+{
+  while (Rps_ObjectZone*obz = some_lazy_object())
+    obz->materialize();
+} // end of Rps_Loader::materialize_all_objects
+
+/// the references of pending objects are unknown, so every loaded
+/// object is kept
+void
+Rps_Loader::gc_mark_lazy_objects(Rps_GarbageCollector*gc)
+{
+  RPS_ASSERT(gc != nullptr);
+  if (ld_lazycount.load() == 0)
+    return;
+  for (auto& it : ld_mapobjects)
+    gc->mark_obj(it.second);
+} // end of Rps_Loader::gc_mark_lazy_objects
+
+void
+Rps_Loader::lazy_materializer_thread(void)
+{
+  pthread_setname_np(pthread_self(), "rps-lazyload");
+  double startrealt = rps_elapsed_real_time();
+  unsigned nbdone = 0;
+  bool more = true;
+  while (more)
     {
-      try
+      /// a few objects at a time, pausing for garbage collections
+      std::lock_guard<std::mutex> gu(rps_load_lazy_mutex);
+      for (unsigned cnt=0; more && cnt<ld_lazybatch; cnt++)
         {
-          parse_json_buffer_second_pass(spacid, prevlin, prevoid, objbuf, obcnt);
+          Rps_ObjectZone*obz = some_lazy_object();
+          if (obz)
+            {
+              obz->materialize();
+              nbdone++;
+            }
+          else
+            more = false;
         }
-      catch (const std::exception& exc)
-        {
-          RPS_FATALOUT("failed second pass in " << spacid
-                       << " prevoid:" << prevoid
-                       << " line#" << prevlin
-                       << std::endl
-                       << "… got exception of type "
-                       << typeid(exc).name()
-                       << ":"
-                       << exc.what());
-        };
-      prevoid = Rps_Id(nullptr);
-    };
+    }
+  RPS_DEBUG_LOG(LOAD, "Rps_Loader lazy materializer did " << nbdone
+                << " objects in " << (rps_elapsed_real_time() - startrealt) << " s");
+} // end of Rps_Loader::lazy_materializer_thread
+
+void
+Rps_Loader::start_lazy_materializer(void)
+{
+  std::thread thr([this](void)
+  {
+    lazy_materializer_thread();
+  });
+  thr.detach();
+} // end of Rps_Loader::start_lazy_materializer
+
+void
+Rps_ObjectZone::materialize_lazy(void) const
+{
+  RPS_ASSERT(rps_lazy_loader != nullptr);
+  {
+    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    /// done by another thread while we waited, or being done by this one
+    if (ob_lazystate.load() != OBLAZY_PENDING)
+      return;
+    rps_lazy_loader->materialize_object(const_cast<Rps_ObjectZone*>(this));
+  }
+  rps_lazy_loader->run_lazy_todo_functions();
+} // end Rps_ObjectZone::materialize_lazy
+
+unsigned
+rps_load_nb_lazy_objects(void)
+{
+  if (!rps_lazy_loader)
+    return 0;
+  return rps_lazy_loader->nb_lazy_objects();
+} // end rps_load_nb_lazy_objects
+
+void
+rps_load_materialize_all(void)
+{
+  if (rps_lazy_loader && rps_lazy_loader->nb_lazy_objects() > 0)
+    rps_lazy_loader->materialize_all_objects();
+} // end rps_load_materialize_all
+
+void
+rps_load_gc_mark_lazy(Rps_GarbageCollector*gc)
+{
+  if (rps_lazy_loader)
+    rps_lazy_loader->gc_mark_lazy_objects(gc);
+} // end rps_load_gc_mark_lazy
+
+
+void
+Rps_Loader::second_pass_space(Rps_Id spacid)
+{
+  RPS_DEBUG_LOG(LOAD, "Rps_Loader::second_pass_space start spacid:" << spacid
+                << std::endl << RPS_FULL_BACKTRACE(0, "RpsLoader::second_pass_space"));
+  std::string_view prolog;
+  unsigned obcnt = 0;
+  each_object_in_space(spacid, prolog,
+                       [&](Rps_Id curobjid, unsigned lincnt, std::string_view objtext)
+  {
+    obcnt++;
+    RPS_DEBUG_LOG(LOAD, "secondpass lincnt="<< lincnt
+                  << " curobjid=" << curobjid
+                  << " obcnt=" << obcnt);
+    try
+      {
+        load_object_second_pass(spacid, lincnt, curobjid, objtext, obcnt);
+      }
+    catch (const std::exception& exc)
+      {
+        RPS_FATALOUT("failed second pass in space " << spacid
+                     << " curobjid:" << curobjid
+                     << " line#" << lincnt
+                     << std::endl
+                     << "… got exception of type "
+                     << typeid(exc).name()
+                     << ":"
+                     << exc.what());
+      };
+  });
   RPS_DEBUG_LOG(LOAD, "Rps_Loader::second_pass_space end spacid:" << spacid);
 } // end of Rps_Loader::second_pass_space
 
 
+/// read the space file and split it, at object starting lines, into
+/// chunks of consecutive objects appended to CHUNKVEC
+void
+Rps_Loader::split_space_second_pass(Rps_Id spacid, std::vector<second_pass_chunk_st>& chunkvec)
+{
+  std::string_view prolog;
+  unsigned obcnt = 0;
+  size_t chunkbytes = 0;
+  each_object_in_space(spacid, prolog,
+                       [&](Rps_Id curobjid, unsigned lincnt, std::string_view objtext)
+  {
+    obcnt++;
+    if (chunkvec.empty() || chunkvec.back().spc_spacid != spacid
+        || chunkvec.back().spc_objects.size() >= ld_chunkmaxobjects
+        || chunkbytes >= ld_chunkmaxbytes)
+      {
+        chunkvec.emplace_back();
+        chunkvec.back().spc_spacid = spacid;
+        chunkbytes = 0;
+      };
+    chunkvec.back().spc_objects.push_back(second_pass_object_st{curobjid, lincnt, obcnt, objtext});
+    chunkbytes += objtext.size();
+  });
+  RPS_DEBUG_LOG(LOAD, "Rps_Loader::split_space_second_pass spacid:" << spacid
+                << " obcnt:" << obcnt
+                << " chunks:" << chunkvec.size());
+} // end of Rps_Loader::split_space_second_pass
+
+
+/// the second pass of all spaces, done by NBTHREADS threads taking
+/// chunks of objects in turn. The todo functions added while parsing
+/// a chunk are queued after all of them, in the order of the serial
+/// second pass.
+void
+Rps_Loader::parallel_second_pass(unsigned nbthreads)
+{
+  double startrealt = rps_elapsed_real_time();
+  std::vector<second_pass_chunk_st> chunkvec;
+  for (Rps_Id spacid: ld_spaceset)
+    split_space_second_pass(spacid, chunkvec);
+  if (nbthreads > chunkvec.size())
+    nbthreads = chunkvec.size();
+  if (nbthreads < 1)
+    nbthreads = 1;
+  std::atomic<unsigned> nextchunk(0);
+  auto worker = [&](void)
+  {
+    for (;;)
+      {
+        unsigned chkix = nextchunk.fetch_add(1);
+        if (chkix >= chunkvec.size())
+          break;
+        second_pass_chunk_st& curchunk = chunkvec[chkix];
+        ld_curchunk = &curchunk;
+        for (second_pass_object_st& curob : curchunk.spc_objects)
+          {
+            try
+              {
+                load_object_second_pass(curchunk.spc_spacid, curob.spo_lineno,
+                                        curob.spo_oid, curob.spo_text,
+                                        curob.spo_count);
+              }
+            catch (const std::exception& exc)
+              {
+                RPS_FATALOUT("failed parallel second pass in space " << curchunk.spc_spacid
+                             << " oid:" << curob.spo_oid
+                             << " line#" << curob.spo_lineno
+                             << std::endl
+                             << "… got exception of type "
+                             << typeid(exc).name()
+                             << ":"
+                             << exc.what());
+              };
+          }
+        ld_curchunk = nullptr;
+      }
+  };
+  {
+    std::vector<std::thread> thrvec;
+    for (unsigned tix=1; tix<nbthreads; tix++)
+      thrvec.emplace_back(worker);
+    worker();
+    for (std::thread&thr : thrvec)
+      thr.join();
+  }
+  for (second_pass_chunk_st& curchunk : chunkvec)
+    {
+      for (auto& rout : curchunk.spc_routines)
+        install_routine_applying_function(rout.first, curchunk.spc_spacid, rout.second);
+      std::lock_guard<std::recursive_mutex> gu(ld_mtx);
+      for (todo_st& td : curchunk.spc_todos)
+        ld_todoque.push_back(td);
+    }
+  RPS_DEBUG_LOG(LOAD, "Rps_Loader::parallel_second_pass parsed " << chunkvec.size()
+                << " chunks of " << ld_mapobjects.size() << " objects with "
+                << nbthreads << " threads in "
+                << (rps_elapsed_real_time() - startrealt) << " s");
+} // end of Rps_Loader::parallel_second_pass
+
+
 void
 Rps_Loader::load_all_state_files(void)
 {
@@ -867,6 +2650,7 @@ Rps_Loader::load_all_state_files(void)
   RPS_DEBUG_LOG(LOAD, "Rps_Loader::load_all_state_files start this@" << (void*)this
                 << std::endl << RPS_FULL_BACKTRACE(0, "RpsLoader::load_all_state_files"));
   int spacecnt1 = 0, spacecnt2 = 0;
+  double phasestart = rps_elapsed_real_time();
   Rps_Id initialspaceid("_8J6vNYtP5E800eCr5q"); //"initial_space"∈space
   first_pass_space(initialspaceid);
   spacecnt1++;
@@ -886,25 +2670,37 @@ Rps_Loader::load_all_state_files(void)
   RPS_INFORM("%s loaded %d space files in first pass",
              thisprog, spacecnt1);
   initialize_constant_objects();
-  /// conceptually, the second pass might be done in parallel
-  /// (multi-threaded, with different threads working on different
-  /// spaces), but this require more clever locking and
-  /// synchronization, so might be done after reaching our milestone#2
-  for (Rps_Id spacid: ld_spaceset)
+  profile_phase("first pass", phasestart);
+  /// with several --jobs and enough objects, the second pass is
+  /// done in parallel on chunks of objects, within and across
+  /// spaces; otherwise space by space.
+  bool parallelpass = rps_nbjobs > 1 && ld_mapobjects.size() >= ld_parallelminobjects;
+  if (parallelpass)
     {
       run_some_todo_functions();
-      second_pass_space(spacid);
-      spacecnt2++;
-      usleep(30);
+      parallel_second_pass((unsigned)rps_nbjobs);
+      spacecnt2 = ld_spaceset.size();
     }
+  else
+    for (Rps_Id spacid: ld_spaceset)
+      {
+        run_some_todo_functions();
+        second_pass_space(spacid);
+        spacecnt2++;
+      }
   RPS_INFORM("%s loaded %d space files in second pass",
              thisprog, spacecnt2);
+  profile_phase(parallelpass ? "parallel second pass" : "second pass", phasestart);
   rps_load_add_todo(this,  rps_initialize_carburetta_after_load);
   while (run_some_todo_functions()>0)
-    {
-      // we sleep a tiny bit, so elapsed time is growing...
-      usleep(20);
-    };
+    continue;
+  profile_phase("final todo functions", phasestart);
+  /// the object texts are no longer needed, unless some are lazy
+  ld_lazyloaded.store(true);
+  if (ld_lazycount.load() > 0)
+    RPS_INFORM("%s deferred %u lazy objects", thisprog, ld_lazycount.load());
+  else
+    unmap_space_files();
   RPS_DEBUG_LOG(LOAD, "Rps_Loader::load_all_state_files end this@"
                 << (void*)this);
   RPS_INFORM("%s loaded %d space files in first pass,\n"
@@ -936,8 +2732,7 @@ Rps_Loader::string_of_loaded_file(const std::string&relpath)
   for (std::string linbuf; std::getline(inp, linbuf); )
     {
       lincnt++;
-      if (u8_check(reinterpret_cast<const uint8_t*> (linbuf.c_str()),
-                   linbuf.size()))
+      if (rps_utf8_check(linbuf.c_str(), linbuf.size()))
         {
           RPS_WARN("non UTF8 line#%d in %s:\n%s",
                    lincnt, fullpath.c_str(), linbuf.c_str());
@@ -1027,13 +2822,13 @@ Rps_Value::Rps_Value(const Json::Value &jv, Rps_Loader*ld)
           *this= Rps_SetValue(setobr);
           return;
         }
-      else if (str == "tuple" && siz==2 && jv.isMember("elem")
+      else if (str == "tuple" && siz==2 && jv.isMember("comp")
                && (jcomp=jv["comp"]).isArray())
         {
           subsiz = jcomp.size();
           std::vector<Rps_ObjectRef> vecobr;
           vecobr.reserve(subsiz);
-          for (int ix=0; ix<(int)siz; ix++)
+          for (int ix=0; ix<(int)subsiz; ix++)
             {
               auto obrcomp = Rps_ObjectRef(jcomp[ix], ld);
               vecobr.push_back(obrcomp);
@@ -1052,6 +2847,21 @@ Rps_Value::Rps_Value(const Json::Value &jv, Rps_Loader*ld)
         {
           *this = Rps_JsonZone::load_from_json(ld, jv);
         }
+      else if (str == "hamt" && jv.isMember("entries"))
+        {
+          *this = Rps_Value(Rps_HamtZone::load_from_json(ld, jv));
+          return;
+        }
+      else if (str == "dblvect" && jv.isMember("b64"))
+        {
+          *this = Rps_Value(Rps_DoubleVectZone::load_from_json(ld, jv));
+          return;
+        }
+      else if (str == "intvect" && jv.isMember("b64"))
+        {
+          *this = Rps_Value(Rps_IntVectZone::load_from_json(ld, jv));
+          return;
+        }
       else if (str == "closure"
                && jv.isMember("fn")
                && jv.isMember("env"))
@@ -1348,6 +3158,22 @@ Rps_Loader::parse_manifest_file(void)
                   << " we have " << sizeglobroots << " globalroots "
                   << " for compiled RPS_NB_ROOT_OB=" << RPS_NB_ROOT_OB);
   }
+  /// parse the optional attribute_indexes, built after loading
+  if (manifjson.isMember("attribute_indexes"))
+    {
+      auto attrixjson = manifjson["attribute_indexes"];
+      if (attrixjson.type() !=  Json::arrayValue)
+        RPS_FATAL("manifest map in %s should have attribute_indexes: [...]",
+                  manifpath.c_str ());
+      for (int ix=0; ix<(int)attrixjson.size(); ix++)
+        {
+          Rps_Id curattrid (attrixjson[ix].asString());
+          RPS_ASSERT(curattrid);
+          ld_attrindexids.push_back(curattrid);
+        }
+      RPS_DEBUG_LOG(LOAD, "loader parse_manifest_file " << ld_attrindexids.size()
+                    << " attribute indexes");
+    };
   /// parse plugins
   {
     auto pluginsjson = manifjson["plugins"];
@@ -1586,6 +3412,215 @@ void Rps_Loader::load_install_roots(void)
 
 
 
+/// the secondary attribute indexes listed in the manifest are built
+/// once every object is loaded, scanning them in parallel
+void
+Rps_Loader::build_attribute_indexes(void)
+{
+  if (ld_attrindexids.empty())
+    return;
+  std::vector<Rps_ObjectRef> vecattr;
+  for (Rps_Id attrid : ld_attrindexids)
+    {
+      Rps_ObjectRef obattr = find_object_by_oid(attrid);
+      if (obattr)
+        vecattr.push_back(obattr);
+      else
+        RPS_WARNOUT("loader: missing indexed attribute " << attrid
+                    << " in " << ld_topdir);
+    }
+  double startrealt = rps_elapsed_real_time();
+  Rps_ObjectZone::rebuild_attribute_indexes(vecattr);
+  RPS_DEBUG_LOG(LOAD, "loader built " << vecattr.size()
+                << " attribute indexes in "
+                << (rps_elapsed_real_time() - startrealt) << " s");
+} // end Rps_Loader::build_attribute_indexes
+
+////////////////////////////////////////////////////////////////
+//// load profiling, with --load-profile=FILE
+
+void
+Rps_Loader::profile_phase(const char*name, double&phasestart)
+{
+  double now = rps_elapsed_real_time();
+  if (RPS_UNLIKELY(ld_profiling))
+    {
+      std::lock_guard<std::mutex> gu(ld_profmtx);
+      ld_profphases.push_back({name, now - phasestart});
+    }
+  phasestart = now;
+} // end Rps_Loader::profile_phase
+
+void
+Rps_Loader::profile_object(Rps_Id spacid, Rps_Id objid, double elapsed)
+{
+  auto faster = [](const profile_object_st&left, const profile_object_st&right)
+  {
+    return left.pob_time > right.pob_time;
+  };
+  std::lock_guard<std::mutex> gu(ld_profmtx);
+  ld_profspaces[spacid].psp_secondpass += elapsed;
+  if (ld_profslowest.size() >= ld_profnbslowest)
+    {
+      if (elapsed <= ld_profslowest.front().pob_time)
+        return;
+      std::pop_heap(ld_profslowest.begin(), ld_profslowest.end(), faster);
+      ld_profslowest.pop_back();
+    };
+  ld_profslowest.push_back(profile_object_st{elapsed, objid, spacid});
+  std::push_heap(ld_profslowest.begin(), ld_profslowest.end(), faster);
+} // end Rps_Loader::profile_object
+
+void
+Rps_Loader::profile_payload(const std::string&paylstr, double elapsed)
+{
+  std::lock_guard<std::mutex> gu(ld_profmtx);
+  profile_payload_st& prof = ld_profpayloads[paylstr];
+  prof.ppl_time += elapsed;
+  prof.ppl_count++;
+} // end Rps_Loader::profile_payload
+
+/// write the load profile into PATH, as JSON if it ends with .json,
+/// otherwise as text, on stdout for -
+void
+Rps_Loader::write_load_profile(const std::string&path)
+{
+  std::lock_guard<std::mutex> gu(ld_profmtx);
+  double totaltime = rps_wallclock_real_time() - ld_startclock;
+  size_t totalbytes = 0;
+  for (auto& it : ld_profspaces)
+    totalbytes += it.second.psp_bytes;
+  unsigned nbobjects = ld_mapobjects.size();
+  std::vector<profile_object_st> slowvec = ld_profslowest;
+  std::sort(slowvec.begin(), slowvec.end(),
+            [](const profile_object_st&left, const profile_object_st&right)
+  {
+    return left.pob_time > right.pob_time;
+  });
+  auto rate = [](double nb, double tim)
+  {
+    return (tim > 0.0) ? (nb/tim) : 0.0;
+  };
+  bool asjson = path.size() > 5 && path.substr(path.size()-5) == ".json";
+  std::ofstream outf;
+  if (path != "-")
+    {
+      outf.open(path);
+      if (!outf)
+        {
+          RPS_WARNOUT("cannot write load profile into " << path
+                      << ":" << strerror(errno));
+          return;
+        }
+    };
+  std::ostream& out = (path == "-") ? std::cout : outf;
+  if (asjson)
+    {
+      Json::Value jprof(Json::objectValue);
+      jprof["topdir"] = Json::Value(ld_topdir);
+      jprof["nbobjects"] = Json::Value(nbobjects);
+      jprof["nblazy"] = Json::Value(ld_lazycount.load());
+      jprof["realtime"] = Json::Value(totaltime);
+      jprof["bytes"] = Json::Value((Json::UInt64) totalbytes);
+      jprof["objectspersecond"] = Json::Value(rate(nbobjects, totaltime));
+      Json::Value jphases(Json::arrayValue);
+      for (auto& ph : ld_profphases)
+        {
+          Json::Value jph(Json::objectValue);
+          jph["phase"] = Json::Value(ph.first);
+          jph["time"] = Json::Value(ph.second);
+          jphases.append(jph);
+        }
+      jprof["phases"] = jphases;
+      Json::Value jspaces(Json::arrayValue);
+      for (auto& it : ld_profspaces)
+        {
+          const profile_space_st& prof = it.second;
+          Json::Value jsp(Json::objectValue);
+          jsp["space"] = it.first ? Json::Value(it.first.to_string()) : Json::Value(Json::nullValue);
+          jsp["nbobjects"] = Json::Value(prof.psp_nbobjects);
+          jsp["bytes"] = Json::Value((Json::UInt64) prof.psp_bytes);
+          jsp["firstpass"] = Json::Value(prof.psp_firstpass);
+          jsp["secondpass"] = Json::Value(prof.psp_secondpass);
+          jsp["todo"] = Json::Value(prof.psp_todo);
+          jsp["objectspersecond"] = Json::Value(rate(prof.psp_nbobjects, prof.psp_secondpass));
+          jspaces.append(jsp);
+        }
+      jprof["spaces"] = jspaces;
+      Json::Value jpayloads(Json::arrayValue);
+      for (auto& it : ld_profpayloads)
+        {
+          Json::Value jpl(Json::objectValue);
+          jpl["payload"] = Json::Value(it.first);
+          jpl["count"] = Json::Value(it.second.ppl_count);
+          jpl["time"] = Json::Value(it.second.ppl_time);
+          jpayloads.append(jpl);
+        }
+      jprof["payloads"] = jpayloads;
+      Json::Value jslowest(Json::arrayValue);
+      for (auto& slow : slowvec)
+        {
+          Json::Value jsl(Json::objectValue);
+          jsl["oid"] = Json::Value(slow.pob_oid.to_string());
+          jsl["space"] = Json::Value(slow.pob_spacid.to_string());
+          jsl["time"] = Json::Value(slow.pob_time);
+          jslowest.append(jsl);
+        }
+      jprof["slowest"] = jslowest;
+      Json::StreamWriterBuilder jswb;
+      jswb["indentation"] = " ";
+      std::unique_ptr<Json::StreamWriter> jsw(jswb.newStreamWriter());
+      jsw->write(jprof, &out);
+      out << std::endl;
+    }
+  else
+    {
+      char buf[256];
+      snprintf(buf, sizeof(buf),
+               "RefPerSys load profile: %u objects, %zu bytes in %.4f s, %.0f objects/s\n",
+               nbobjects, totalbytes, totaltime, rate(nbobjects, totaltime));
+      out << buf << "from " << ld_topdir;
+      if (ld_lazycount.load() > 0)
+        out << ", " << ld_lazycount.load() << " lazy objects";
+      out << std::endl << std::endl << "phases:" << std::endl;
+      for (auto& ph : ld_profphases)
+        {
+          snprintf(buf, sizeof(buf), "  %-28s %9.4f s\n", ph.first.c_str(), ph.second);
+          out << buf;
+        }
+      out << std::endl << "spaces:" << std::endl;
+      snprintf(buf, sizeof(buf), "  %-20s %8s %10s %9s %9s %9s %10s\n",
+               "space", "objects", "bytes", "first s", "second s", "todo s", "objects/s");
+      out << buf;
+      for (auto& it : ld_profspaces)
+        {
+          const profile_space_st& prof = it.second;
+          snprintf(buf, sizeof(buf), "  %-20s %8u %10zu %9.4f %9.4f %9.4f %10.0f\n",
+                   it.first ? it.first.to_string().c_str() : "(none)",
+                   prof.psp_nbobjects, prof.psp_bytes, prof.psp_firstpass,
+                   prof.psp_secondpass, prof.psp_todo,
+                   rate(prof.psp_nbobjects, prof.psp_secondpass));
+          out << buf;
+        }
+      out << std::endl << "payload loaders:" << std::endl;
+      for (auto& it : ld_profpayloads)
+        {
+          snprintf(buf, sizeof(buf), "  %-28s %8u %9.4f s\n",
+                   it.first.c_str(), it.second.ppl_count, it.second.ppl_time);
+          out << buf;
+        }
+      out << std::endl << "slowest objects:" << std::endl;
+      for (auto& slow : slowvec)
+        {
+          snprintf(buf, sizeof(buf), "  %s in %s %9.6f s\n",
+                   slow.pob_oid.to_string().c_str(),
+                   slow.pob_spacid.to_string().c_str(), slow.pob_time);
+          out << buf;
+        }
+    }
+  out.flush();
+} // end Rps_Loader::write_load_profile
+
 void rps_load_from (const std::string& dirpath)
 {
   unsigned nbloaded = 0;
@@ -1597,7 +3632,10 @@ void rps_load_from (const std::string& dirpath)
                 << std::endl
                 << RPS_FULL_BACKTRACE(1, "rps_load_from"));
   {
-    Rps_Loader loader(dirpath);
+    std::unique_ptr<Rps_Loader> loaderptr(new Rps_Loader(dirpath));
+    Rps_Loader& loader = *loaderptr;
+    if (rps_lazy_load)
+      rps_lazy_loader = loaderptr.get();
     try
       {
         loader.parse_manifest_file();
@@ -1608,13 +3646,26 @@ void rps_load_from (const std::string& dirpath)
           if (!access(usermanifest.c_str(), R_OK))
             loader.parse_user_manifest(usermanifest);
         }
+        if (rps_check_pull_parser)
+          {
+            unsigned nbmismatch = loader.check_pull_parser();
+            if (nbmismatch > 0)
+              RPS_FATALOUT("pull parser differs from jsoncpp on "
+                           << nbmismatch << " objects in " << dirpath);
+          }
         loader.load_all_state_files();
+        double phasestart = rps_elapsed_real_time();
         loader.load_install_roots();
         RPS_DEBUG_LOG(LOAD, "rps_load_from start dirpath=" << dirpath << " after load_install_roots");
         rps_initialize_roots_after_loading(&loader);
         rps_initialize_symbols_after_loading(&loader);
         rps_set_native_data_in_loader(&loader);
+        loader.profile_phase("roots and symbols", phasestart);
+        loader.build_attribute_indexes();
+        loader.profile_phase("attribute indexes", phasestart);
         nbloaded = loader.nb_loaded_objects();
+        if (loader.is_profiling())
+          loader.write_load_profile(rps_load_profile);
         RPS_DEBUG_LOG(LOAD, "rps_load_from start dirpath=" << dirpath << " nbloaded=" << nbloaded);
       }
     catch (const std::exception& exc)
@@ -1626,6 +3677,15 @@ void rps_load_from (const std::string& dirpath)
                      << ":"
                      << exc.what());
       }
+    if (loader.nb_lazy_objects() > 0)
+      {
+        /// kept, with its mapped space files, for the lazy objects
+        loaderptr.release();
+        if (!rps_batch)
+          loader.start_lazy_materializer();
+      }
+    else
+      rps_lazy_loader = nullptr;
   };
   RPS_ASSERT(nbloaded > 0);
   endrealt = rps_elapsed_real_time();
@@ -1674,22 +3734,23 @@ rpsldpy_classinfo(Rps_ObjectZone*obz, Rps_Loader*ld, const Json::Value& jv, Rps_
                  << " has incomplete payload"
                  << std::endl
                  << " jv " << (jv));
-  auto paylclainf = obz->put_new_plain_payload<Rps_PayloadClassInfo>();
-  RPS_ASSERT(paylclainf != nullptr);
+  /// everything is decoded first, then the payload is put and filled
+  /// with the class locked: in the parallel second pass, instances of
+  /// this class are loaded concurrently by Rps_InstanceZone::load_from_json,
+  /// which looks at the payload with the class locked
   auto obsuperclass = Rps_ObjectRef(jv["class_super"], ld);
   RPS_ASSERT(obsuperclass);
-  paylclainf->put_superclass(obsuperclass);
+  Rps_ObjectRef obsymb;
   if (jv.isMember("class_symb"))
     {
       Json::Value jclasssymb = jv["class_symb"];
-      auto obsymb = Rps_ObjectRef(jclasssymb, ld);
+      obsymb = Rps_ObjectRef(jclasssymb, ld);
       if (!obsymb)
         RPS_FATALOUT("rpsldpy_classinfo: object " << obz->oid()
                      << " in space " << spacid << " lineno#" << lineno
                      << " has bad class_symb"
                      << std::endl
                      << " jclasssymb " <<(jclasssymb));
-      paylclainf->loader_put_symbname(obsymb, ld);
     }
   Json::Value jvmethodict = jv["class_methodict"];
   unsigned nbmeth = 0;
@@ -1700,6 +3761,8 @@ rpsldpy_classinfo(Rps_ObjectZone*obz, Rps_Loader*ld, const Json::Value& jv, Rps_
                  << std::endl
                  << " jvmethodict " <<(jvmethodict));
   nbmeth = jvmethodict.size();
+  std::vector<std::pair<Rps_ObjectRef,Rps_Value>> methvec;
+  methvec.reserve(nbmeth);
   for (int methix=0; methix<(int)nbmeth; methix++)
     {
       Json::Value jvcurmethent = jvmethodict[methix];
@@ -1727,20 +3790,31 @@ rpsldpy_classinfo(Rps_ObjectZone*obz, Rps_Loader*ld, const Json::Value& jv, Rps_
                      << ", valclo=" << valclo
                      << std::endl
                      << " jvcurmethent: " <<jvcurmethent);
-      paylclainf->put_own_method(obsel,valclo);
+      methvec.push_back({obsel,valclo});
     }
+  const Rps_SetOb*atset = nullptr;
   if (jv.isMember("class_attrset"))
     {
       auto jvatset = jv["class_attrset"];
       auto valaset = Rps_Value(jvatset, ld);
       if (valaset.is_set())
-        paylclainf->loader_put_attrset(valaset.as_set(), ld);
+        atset = valaset.as_set();
       else if (!valaset.is_empty())
         RPS_FATALOUT("rpsldpy_classinfo: object " << obz->oid()
                      << " in space " << spacid << " lineno#" << lineno
                      << " with bad class_attrset" << std::endl
                      << " jvatset:" << jvatset);
     }
+  std::lock_guard<std::recursive_mutex> guobz(*(obz->objmtxptr()));
+  auto paylclainf = obz->put_new_plain_payload<Rps_PayloadClassInfo>();
+  RPS_ASSERT(paylclainf != nullptr);
+  paylclainf->put_superclass(obsuperclass);
+  if (obsymb)
+    paylclainf->loader_put_symbname(obsymb, ld);
+  for (auto& meth : methvec)
+    paylclainf->put_own_method(meth.first, Rps_ClosureValue(meth.second));
+  if (atset)
+    paylclainf->loader_put_attrset(atset, ld);
 } // end of rpsldpy_classinfo
 
 
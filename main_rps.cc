@@ -359,6 +359,95 @@ struct argp_option rps_progoptions[] =
     , //
     /*group:*/0 ///
   },
+  /* ======= hash-consing of immutable values ======= */
+  {/*name:*/ "intern-values", ///
+    /*key:*/ RPSPROGOPT_INTERN_VALUES, ///
+    /*arg:*/ nullptr, ///
+    /*flags:*/ 0, ///
+    /*doc:*/ "Share structurally equal immutable values (strings, sets\n"
+    " and tuples) thru a weak intern table, see Rps_InternTable.\n", //
+    /*group:*/0 ///
+  },
+  /* ======= inverse references ======= */
+  {/*name:*/ "referrers-index", ///
+    /*key:*/ RPSPROGOPT_REFERRERS_INDEX, ///
+    /*arg:*/ nullptr, ///
+    /*flags:*/ 0, ///
+    /*doc:*/ "Build after load the index of referrers, that is of objects\n"
+    " referencing a given one, then maintain it incrementally.\n", //
+    /*group:*/0 ///
+  },
+  /* ======= binary snapshots of space files ======= */
+  {/*name:*/ "binary-store", ///
+    /*key:*/ RPSPROGOPT_BINARY_STORE, ///
+    /*arg:*/ nullptr, ///
+    /*flags:*/ 0, ///
+    /*doc:*/ "Load from fresh persistore/sp*-rps.bin binary snapshots\n"
+    " when available, and write them after dumping JSON space files.\n", //
+    /*group:*/0 ///
+  },
+  {/*name:*/ "convert-store", ///
+    /*key:*/ RPSPROGOPT_CONVERT_STORE, ///
+    /*arg:*/ "DIRECTION", ///
+    /*flags:*/ 0, ///
+    /*doc:*/ "Convert the space files of the load directory, with DIRECTION\n"
+    " being to-binary or to-json, then exit without loading. JSON\n"
+    " space files changed since their snapshot are kept, unless\n"
+    " DIRECTION is force-to-json.\n", //
+    /*group:*/0 ///
+  },
+  /* ======= lazy loading ======= */
+  {/*name:*/ "lazy-load", ///
+    /*key:*/ RPSPROGOPT_LAZY_LOAD, ///
+    /*arg:*/ nullptr, ///
+    /*flags:*/ 0, ///
+    /*doc:*/ "Load eagerly only roots, constants, classes and symbols;\n"
+    " other objects get their contents on first use, or from a\n"
+    " background thread unless in --batch mode. In --batch mode,\n"
+    " the garbage collector keeps every loaded object while some\n"
+    " are pending, usually for the whole process lifetime.\n", //
+    /*group:*/0 ///
+  },
+  /* ======= load profiling ======= */
+  {/*name:*/ "load-profile", ///
+    /*key:*/ RPSPROGOPT_LOAD_PROFILE, ///
+    /*arg:*/ "FILE", ///
+    /*flags:*/ 0, ///
+    /*doc:*/ "Write into FILE the timings of loading per phase, space\n"
+    " and payload type, with the slowest objects; as JSON if FILE\n"
+    " ends with .json, otherwise as text, on stdout for -.\n", //
+    /*group:*/0 ///
+  },
+  /* ======= heap integrity ======= */
+  {/*name:*/ "check-heap", ///
+    /*key:*/ RPSPROGOPT_CHECK_HEAP, ///
+    /*arg:*/ "WHEN", ///
+    /*flags:*/ OPTION_ARG_OPTIONAL, ///
+    /*doc:*/ "Check in parallel the integrity of the heap, with WHEN\n"
+    " being load (the default) after loading, dump before dumping,\n"
+    " or both.\n", //
+    /*group:*/0 ///
+  },
+  /* ======= pull parser check ======= */
+  {/*name:*/ "check-pull-parser", ///
+    /*key:*/ RPSPROGOPT_CHECK_PULL_PARSER, ///
+    /*arg:*/ nullptr, ///
+    /*flags:*/ 0, ///
+    /*doc:*/ "Before loading, decode every stored object with both\n"
+    " jsoncpp and the pull parser of the loader, and fail if they\n"
+    " differ.\n", //
+    /*group:*/0 ///
+  },
+  /* ======= startup timeline ======= */
+  {/*name:*/ "startup-profile", ///
+    /*key:*/ RPSPROGOPT_STARTUP_PROFILE, ///
+    /*arg:*/ "FILE", ///
+    /*flags:*/ OPTION_ARG_OPTIONAL, ///
+    /*doc:*/ "Show the startup timeline, with the real and CPU time of\n"
+    " each startup phase, into FILE (as JSON if it ends with .json)\n"
+    " or on stdout without FILE or for -.\n", //
+    /*group:*/0 ///
+  },
   /* ======= random oids ======= */
   {/*name:*/ "random-oid", ///
     /*key:*/ RPSPROGOPT_RANDOMOID, ///
@@ -546,6 +635,15 @@ bool rps_disable_aslr = false;
 bool rps_without_terminal_escape = false;
 bool rps_daemonized = false;
 bool rps_without_quick_tests = false;
+bool rps_build_referrers_index = false;
+bool rps_binary_store = false;
+const char* rps_convert_store = nullptr;
+bool rps_lazy_load = false;
+const char* rps_load_profile = nullptr;
+bool rps_check_heap_after_load = false;
+bool rps_check_heap_before_dump = false;
+bool rps_check_pull_parser = false;
+const char* rps_startup_profile = nullptr;
 bool rps_test_repl_lexer = false;
 bool rps_syslog_enabled = false;
 bool rps_stdin_istty = false;
@@ -711,6 +809,17 @@ rps_run_loaded_application(int &argc, char **argv)
   // if a command is given run it
   if (rps_run_command_after_load)
     rps_do_run_command_after_load();
+  if (rps_build_referrers_index)
+    Rps_ObjectZone::build_referrers_index(rps_nbjobs);
+  if (rps_check_heap_after_load)
+    {
+      unsigned nbproblems = Rps_ObjectZone::check_heap_integrity(rps_nbjobs);
+      /// so that test targets fail on a damaged heap
+      if (nbproblems > 0 && rps_batch)
+        RPS_FATALOUT("found " << nbproblems
+                     << " heap integrity problems after load in batch mode");
+    }
+  rps_startup_phase("after load checks");
   ////
   if (rps_without_quick_tests)
     {
@@ -726,6 +835,7 @@ rps_run_loaded_application(int &argc, char **argv)
       rps_small_quick_tests_after_load();
       RPS_DEBUG_LOG(LOWREP, "rps_run_loaded_application after running rps_small_quick_tests_after_load");
     };
+  rps_startup_phase("quick tests");
   /// create the fifos if a prefix is given with
   if (!rps_get_fifo_prefix().empty())
     {
@@ -787,6 +897,7 @@ rps_run_loaded_application(int &argc, char **argv)
                       << " got exception " << exc.what()
                      );
         }
+      rps_startup_phase("plugins initialization");
     };
   /////
   ///// testing the REPL lexer with a string
@@ -865,6 +976,7 @@ rps_run_loaded_application(int &argc, char **argv)
               << std::endl
               << RPS_FULL_BACKTRACE(1, "rps_run_loaded_application/exc"));
         };
+      rps_startup_phase("commands");
     };
   ////
   ////
@@ -888,6 +1000,7 @@ rps_run_loaded_application(int &argc, char **argv)
                 << RPS_FULL_BACKTRACE(1, "rps_run_loaded_application/A"));
   RPS_POSSIBLE_BREAKPOINT();
   rps_run_scripts_after_load(&_);
+  rps_startup_phase("scripts after load");
   RPS_DEBUG_LOG(REPL, "rps_run_loaded_application ended in thread "
                 << rps_current_pthread_name()
                 << std::endl
@@ -1327,6 +1440,24 @@ rps_small_quick_tests_after_load(void)
   _f.obfoundnew = Rps_ObjectRef::find_object_or_fail_by_oid(&_, _f.obnew->oid());
   RPS_DEBUG_LOG(CMD, "rps_small_quick_tests_after_load obfoundnew=" << _f.obfoundnew << " obnew=" << _f.obnew);
   RPS_ASSERT(_f.obnew == _f.obfoundnew);
+  {
+    /// the fresh object should be in the extent of its class
+    std::vector<Rps_ObjectRef> extvec
+      = Rps_ObjectZone::class_extent(Rps_ObjectRef::the_object_class());
+    RPS_ASSERT(std::find(extvec.begin(), extvec.end(), _f.obnew) != extvec.end());
+    RPS_ASSERT(Rps_ObjectZone::class_extent_set(Rps_ObjectRef::the_object_class())
+               .as_set()->contains(_f.obnew));
+    bool foundnew = false;
+    Rps_ObjectZone::iterate_class_extent(Rps_ObjectRef::the_object_class(), &foundnew,
+                                         [&](void*data, Rps_ObjectRef obinst)
+    {
+      if (obinst != _f.obnew)
+        return false;
+      *(bool*)data = true;
+      return true;
+    });
+    RPS_ASSERT(foundnew);
+  }
 #warning should add some clever tests on  Rps_Value::is_instance_of and Rps_Value::is_subclass_of
   RPS_DEBUG_LOG(CMD, "end rps_small_quick_tests_after_load");
 } // end rps_small_quick_tests_after_load
@@ -1652,6 +1783,7 @@ main (int argc, char** argv)
   //// the double dash in the main thread name rps--main is temporary
   //// since rps_early_initialization is later setting it to rps-main
   pthread_setname_np(pthread_self(), "rps--main");
+  rps_startup_phase("exec, dynamic linking and static constructors");
   char*mylocale = nullptr;
   char*myuserpref = nullptr;
   rps_helpwanted = false;
@@ -1827,15 +1959,17 @@ main (int argc, char** argv)
   ////
   //// extend the Unix environment if needed
   rps_extend_env();
+  rps_startup_phase("preferences and environment");
   //// test the macro (generating nop instructions in assembler) for possible breakpoints;
   RPS_POSSIBLE_BREAKPOINT();
   ////
   Rps_QuasiZone::initialize();
   rps_check_mtime_files();
+  rps_startup_phase("quasi zones and source files");
 #if RPS_USE_CURL
   rps_initialize_curl();
+  rps_startup_phase("curl initialization");
 #endif /*RPS_USE_CURL*/
-  rps_gccjit_initialize();
   if (rps_my_load_dir.empty())
     {
       const char* rpld = realpath(rps_topdirectory, nullptr);
@@ -1845,7 +1979,29 @@ main (int argc, char** argv)
       rps_my_load_dir = std::string(rpld);
       free ((void*)rpld);
     };
+  if (rps_convert_store)
+    {
+      bool tobinary = !strcmp(rps_convert_store, "to-binary");
+      int nbfail = rps_binstore_convert_directory(rps_my_load_dir + "/persistore",
+                   tobinary, !strcmp(rps_convert_store, "force-to-json"));
+      exit(nbfail?EXIT_FAILURE:EXIT_SUCCESS);
+    }
+  //// the GCCJIT trial compilation and the dlopen of the plugins
+  //// don't need the heap, so they overlap the load
+  std::thread gccjitinitializer([]()
+  {
+    pthread_setname_np(pthread_self(), "rps-gccjitinit");
+    double startmonotime = rps_monotonic_real_time();
+    rps_gccjit_initialize();
+    rps_startup_background_phase("gccjit initialization", startmonotime,
+                                 rps_thread_cpu_time());
+  });
+  rps_start_plugins_loading();
   rps_load_from(rps_my_load_dir);
+  rps_startup_phase("load");
+  gccjitinitializer.join();
+  rps_wait_plugins_loading();
+  rps_startup_phase("waiting for gccjit and plugins");
   RPS_POSSIBLE_BREAKPOINT();
   //// at this point the persistent heap has been completely loaded!
   if (rps_chdir_path_after_load)
@@ -1873,8 +2029,12 @@ main (int argc, char** argv)
   if (!rps_batch)
     {
     }
+  rps_startup_phase("user preferences");
   rps_initialize_event_loop();
+  rps_startup_phase("event loop initialization");
   rps_run_loaded_application(argc, argv);
+  if (rps_startup_profile)
+    rps_show_startup_profile(rps_startup_profile);
   RPS_POSSIBLE_BREAKPOINT();
   if (!rps_batch)
     {
@@ -590,21 +590,101 @@ operator << (std::ostream&out, const Rps_DequVal& dq)
 
 Rps_PayloadObjMap::Rps_PayloadObjMap(Rps_ObjectZone*obz) :
   Rps_Payload(Rps_Type::PaylObjMap, obz),
-  obm_map(), obm_descr(nullptr)
+  obm_slots(), obm_count(0), obm_used(0), obm_descr(nullptr)
 {
 } // end Rps_PayloadObjMap::Rps_PayloadObjMap
 
+void
+Rps_PayloadObjMap::obm_clear(void)
+{
+  obm_slots.clear();
+  obm_count = 0;
+  obm_used = 0;
+} // end Rps_PayloadObjMap::obm_clear
+
+int
+Rps_PayloadObjMap::obm_find_slot(Rps_ObjectRef obkey) const
+{
+  if (obm_count == 0 || obkey.is_empty())
+    return -1;
+  unsigned mask = obm_slots.size() - 1;
+  const Rps_ObjectZone* keyz = obkey.optr();
+  for (unsigned pos = obkey.obhash() & mask; ; pos = (pos+1) & mask)
+    {
+      const Rps_ObjectZone* curkey = obm_slots[pos].os_key;
+      if (curkey == keyz)
+        return (int)pos;
+      if (!curkey)
+        return -1;
+    }
+} // end Rps_PayloadObjMap::obm_find_slot
+
+/// rehash with room for at least MINCOUNT entries, dropping removed slots
+void
+Rps_PayloadObjMap::obm_reorganize(unsigned mincount)
+{
+  if (mincount < obm_count)
+    mincount = obm_count;
+  unsigned newsize = obm_minsize;
+  while (newsize < 2*mincount+1)
+    newsize *= 2;
+  std::vector<obm_slot_st> oldslots(newsize, obm_slot_st{nullptr,nullptr});
+  oldslots.swap(obm_slots);
+  unsigned mask = newsize - 1;
+  for (auto& oldslot: oldslots)
+    {
+      if (!oldslot.os_key || oldslot.os_key == obm_removedkey())
+        continue;
+      unsigned pos = Rps_ObjectRef(oldslot.os_key).obhash() & mask;
+      while (obm_slots[pos].os_key)
+        pos = (pos+1) & mask;
+      obm_slots[pos] = oldslot;
+    };
+  obm_used = obm_count;
+} // end Rps_PayloadObjMap::obm_reorganize
+
+std::vector<Rps_ObjectRef>
+Rps_PayloadObjMap::sorted_obmap_keys(void) const
+{
+  std::vector<Rps_ObjectRef> veckeys;
+  veckeys.reserve(obm_count);
+  for (auto& slot: obm_slots)
+    if (slot.os_key && slot.os_key != obm_removedkey())
+      veckeys.push_back(Rps_ObjectRef(slot.os_key));
+  std::sort(veckeys.begin(), veckeys.end(),
+            [](Rps_ObjectRef leftob, Rps_ObjectRef rightob)
+  {
+    return leftob->oid() < rightob->oid();
+  });
+  return veckeys;
+} // end Rps_PayloadObjMap::sorted_obmap_keys
+
 void
 Rps_PayloadObjMap::gc_mark_objmap(Rps_GarbageCollector&gc) const
 {
-  for (auto it: obm_map)
+  for (auto& slot: obm_slots)
     {
-      gc.mark_obj(it.first);
-      gc.mark_value(it.second);
+      if (!slot.os_key || slot.os_key == obm_removedkey())
+        continue;
+      gc.mark_obj(Rps_ObjectRef(slot.os_key));
+      gc.mark_value(slot.os_val);
     };
   gc.mark_value (obm_descr);
 } // end Rps_PayloadObjMap::gc_mark_objmap
 
+void
+Rps_PayloadObjMap::each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const
+{
+  for (auto& slot: obm_slots)
+    {
+      if (!slot.os_key || slot.os_key == obm_removedkey())
+        continue;
+      f(slot.os_key);
+      rps_each_object_in_value(slot.os_val, f);
+    };
+  rps_each_object_in_value(obm_descr, f);
+} // end Rps_PayloadObjMap::each_referenced_object
+
 void
 Rps_PayloadObjMap::gc_mark(Rps_GarbageCollector&gc) const
 {
@@ -622,10 +702,12 @@ void
 Rps_PayloadObjMap::dump_scan_objmap_internal(Rps_Dumper*du) const
 {
   RPS_ASSERT (du != nullptr);
-  for (auto it: obm_map)
+  for (auto& slot: obm_slots)
     {
-      rps_dump_scan_object(du, it.first);
-      rps_dump_scan_value(du, it.second, 0);
+      if (!slot.os_key || slot.os_key == obm_removedkey())
+        continue;
+      rps_dump_scan_object(du, Rps_ObjectRef(slot.os_key));
+      rps_dump_scan_value(du, slot.os_val, 0);
     };
   rps_dump_scan_value(du, obm_descr, 0);
 } // end Rps_PayloadObjMap::dump_scan_internal
@@ -643,9 +725,9 @@ Rps_PayloadObjMap::dump_json_objmap_internal_content(Rps_Dumper*du, Json::Value&
 {
   RPS_ASSERT (du != nullptr);
   Json::Value jmap(Json::objectValue);
-  for (auto it: obm_map)
+  for (Rps_ObjectRef obkey: sorted_obmap_keys())
     {
-      jmap[it.first.as_string()] = rps_dump_json_value(du, it.second);
+      jmap[obkey.as_string()] = rps_dump_json_value(du, get_obmap(obkey));
     };
   jv["objmap"] = jmap;
   jv["descr"] = rps_dump_json_value(du, obm_descr);
@@ -655,12 +737,12 @@ Rps_Value
 Rps_PayloadObjMap::get_obmap(Rps_ObjectRef obkey, Rps_Value defaultval,
                              bool*pmissing) const
 {
-  auto it = obm_map.find(obkey);
-  if (it != obm_map.end())
+  int pos = obm_find_slot(obkey);
+  if (pos >= 0)
     {
       if (pmissing)
         *pmissing = false;
-      return it->second;
+      return obm_slots[pos].os_val;
     }
   if (pmissing)
     *pmissing = true;
@@ -670,7 +752,7 @@ Rps_PayloadObjMap::get_obmap(Rps_ObjectRef obkey, Rps_Value defaultval,
 bool
 Rps_PayloadObjMap::has_key_obmap(Rps_ObjectRef obkey) const
 {
-  return obm_map.find(obkey) != obm_map.end();
+  return obm_find_slot(obkey) >= 0;
 } // end Rps_PayloadObjMap::has_key_obmap
 
 Rps_ObjectZone*
@@ -691,7 +773,7 @@ Rps_PayloadObjMap::make(Rps_CallFrame*callframe, Rps_ObjectRef classob, Rps_Obje
     {
       _f.mapob = Rps_ObjectRef::make_object(&_, _f.classob, _f.spaceob);
       auto paylobmap = _f.mapob->put_new_plain_payload<Rps_PayloadObjMap>();
-      paylobmap->obm_map.clear();
+      paylobmap->obm_clear();
       paylobmap->obm_descr = nullptr;;
       return _f.mapob;
     }
@@ -705,7 +787,7 @@ Rps_PayloadObjMap::make(Rps_CallFrame*callframe, Rps_ObjectRef classob, Rps_Obje
     {
       _f.mapob = Rps_ObjectRef::make_object(&_, _f.classob, _f.spaceob);
       auto paylobmap = _f.mapob->put_new_plain_payload<Rps_PayloadObjMap>();
-      paylobmap->obm_map.clear();
+      paylobmap->obm_clear();
       paylobmap->obm_descr = nullptr;;
       return _f.mapob;
     }
@@ -716,9 +798,40 @@ void
 Rps_PayloadObjMap::put_obmap(Rps_ObjectRef obkey, Rps_Value val)
 {
   RPS_ASSERT(obkey);
-  obm_map.insert({obkey,val});
+  int pos = obm_find_slot(obkey);
+  if (pos >= 0)
+    {
+      note_payload_references(obm_slots[pos].os_val, val);
+      obm_slots[pos].os_val = val;
+      return;
+    };
+  note_payload_references(nullptr, obkey);
+  note_payload_references(nullptr, val);
+  if (2*(obm_used+1) > obm_slots.size())
+    obm_reorganize(obm_count+1);
+  unsigned mask = obm_slots.size() - 1;
+  unsigned newpos = obkey.obhash() & mask;
+  while (obm_slots[newpos].os_key)
+    newpos = (newpos+1) & mask;
+  obm_slots[newpos] = obm_slot_st{obkey.optr(), val};
+  obm_count++;
+  obm_used++;
 } // end Rps_PayloadObjMap::put_obmap
 
+bool
+Rps_PayloadObjMap::remove_obmap(Rps_ObjectRef obkey)
+{
+  int pos = obm_find_slot(obkey);
+  if (pos < 0)
+    return false;
+  note_payload_references(obkey, nullptr);
+  note_payload_references(obm_slots[pos].os_val, nullptr);
+  obm_slots[pos].os_key = obm_removedkey();
+  obm_slots[pos].os_val = nullptr;
+  obm_count--;
+  return true;
+} // end Rps_PayloadObjMap::remove_obmap
+
 void
 Rps_PayloadObjMap::output_payload(std::ostream&out, unsigned depth, unsigned maxdepth) const
 {
@@ -737,7 +850,7 @@ Rps_PayloadObjMap::output_payload(std::ostream&out, unsigned depth, unsigned max
   const char* BOLD_esc = (ontty?RPS_TERMINAL_BOLD_ESCAPE:"");
   const char* NORM_esc = (ontty?RPS_TERMINAL_NORMAL_ESCAPE:"");
   std::lock_guard<std::recursive_mutex> gudispob(*owner()->objmtxptr());
-  int nbobjmap = (int) obm_map.size();
+  int nbobjmap = (int) obm_count;
   long linpos = out.tellp();
   if (nbobjmap==0)
     out << BOLD_esc << "-empty object map-" << NORM_esc;
@@ -750,9 +863,7 @@ Rps_PayloadObjMap::output_payload(std::ostream&out, unsigned depth, unsigned max
         << Rps_OutputValue(dv, depth, maxdepth) << std::endl;
   else
     out << " plain" << NORM_esc << std::endl;
-  std::vector<Rps_ObjectRef> attrvect(nbobjmap);
-  for (auto it : obm_map)
-    attrvect.push_back(it.first);
+  std::vector<Rps_ObjectRef> attrvect = sorted_obmap_keys();
   rps_sort_object_vector_for_display(attrvect);
   for (int ix=0; ix<(int)nbobjmap; ix++)
     {
@@ -764,7 +875,7 @@ Rps_PayloadObjMap::output_payload(std::ostream&out, unsigned depth, unsigned max
           linpos = out.tellp();
         };
       const Rps_ObjectRef curattr = attrvect[ix];
-      const Rps_Value curval = (obm_map.at(curattr));
+      const Rps_Value curval = get_obmap(curattr);
       out << BOLD_esc << "*"
           << NORM_esc << curattr << ": "
           << Rps_OutputValue(curval, depth, maxdepth)
@@ -785,6 +896,7 @@ rpsldpy_objmap(Rps_ObjectZone*obz, Rps_Loader*ld, const Json::Value& jv, Rps_Id
   if (jobmap.type () == Json::objectValue)
     {
       auto membvec = jobmap.getMemberNames(); // vector of strings
+      paylobjmap->obm_reorganize(membvec.size());
       for (const std::string& keystr : membvec)
         {
           Rps_ObjectRef keyob(keystr, ld);
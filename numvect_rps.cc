@@ -0,0 +1,442 @@
+/****************************************************************
+ * file numvect_rps.cc
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * Description:
+ *      This file is part of the Reflective Persistent System.
+ *
+ *      It has the code of immutable packed numeric vectors, of
+ *      double-s or of 64 bits integers, and of their kernels.
+ *
+ * Author(s):
+ *      Basile Starynkevitch, France    <basile@starynkevitch.net>
+ *      Niklas Rozencrantz, Sweden     <niklasr@protonmail.com>
+ *
+ *      © Copyright (C) 2026 The Reflective Persistent System Team
+ *      team@refpersys.org & http://refpersys.org/
+ *
+ * License:
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#include "refpersys.hh"
+
+
+
+extern "C" const char rps_numvect_gitid[];
+const char rps_numvect_gitid[]= RPS_GITID;
+
+
+extern "C" const char rps_numvect_shortgitid[];
+const char rps_numvect_shortgitid[]= RPS_SHORTGITID;
+
+
+extern "C" const char rps_numvect_basename[];
+const char rps_numvect_basename[]= RPS_BASENAME;
+
+extern "C" const char rps_numvect_baseid[];
+const char rps_numvect_baseid[]= RPS_BASEID;
+
+
+/// the dumped binary encoding is little endian, like our usual hosts
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error numeric vectors dump need some byte swapping on big endian hosts
+#endif
+
+template<> const char*const Rps_DoubleVectZone::json_vtype = "dblvect";
+template<> const char*const Rps_IntVectZone::json_vtype = "intvect";
+
+/// integer kernels compute in unsigned arithmetic, so wrap without
+/// undefined behavior
+template<typename NumT> struct rps_numvect_acc
+{
+  typedef NumT type;
+};
+template<> struct rps_numvect_acc<std::int64_t>
+{
+  typedef std::uint64_t type;
+};
+template<typename NumT>
+using rps_numvect_acc_t = typename rps_numvect_acc<NumT>::type;
+
+template<typename NumT, Rps_Type vecty>
+Rps_NumVectZone<NumT,vecty>*
+Rps_NumVectZone<NumT,vecty>::make_uninit(unsigned len)
+{
+  if (len >= maxsize)
+    throw std::length_error("too big numeric vector");
+  return Rps_QuasiZone::rps_allocate_with_wordgap<Rps_NumVectZone,unsigned>
+         ((len*sizeof(NumT))/sizeof(void*), len);
+} // end Rps_NumVectZone::make_uninit
+
+
+template<typename NumT, Rps_Type vecty>
+void
+Rps_NumVectZone<NumT,vecty>::finish_make(void)
+{
+  _nvsorted = std::is_sorted(_nvdata, _nvdata+_nvlen, elem_less);
+} // end Rps_NumVectZone::finish_make
+
+
+template<typename NumT, Rps_Type vecty>
+const Rps_NumVectZone<NumT,vecty>*
+Rps_NumVectZone<NumT,vecty>::make(const NumT*arr, unsigned len)
+{
+  if (len>0 && !arr)
+    throw std::invalid_argument("Rps_NumVectZone::make with null array");
+  Rps_NumVectZone* nv = make_uninit(len);
+  if (len>0)
+    memcpy((void*)nv->_nvdata, (const void*)arr, len*sizeof(NumT));
+  nv->finish_make();
+  return nv;
+} // end Rps_NumVectZone::make
+
+
+template<typename NumT, Rps_Type vecty>
+Rps_HashInt
+Rps_NumVectZone<NumT,vecty>::compute_hash(void) const
+{
+  std::uint64_t h1 = _nvlen + (std::uint64_t)vecty*31, h2 = 17;
+  for (unsigned ix=0; ix<_nvlen; ix++)
+    {
+      std::uint64_t he;
+      if constexpr (std::is_floating_point_v<NumT>)
+        he = Rps_Double::hash_double(_nvdata[ix]);
+      else
+        he = (std::uint64_t)_nvdata[ix];
+      if (ix % 2)
+        h1 = h1*13151 + he;
+      else
+        h2 = (h2 ^ he)*13291 + (he>>32);
+    };
+  Rps_HashInt h = (h1 * 3371) ^ (h2 * 7741) ^ (h1 >> 32);
+  if (RPS_UNLIKELY(h==0))
+    h = (h1&0xffff) + (h2&0xfffff) + 19;
+  return h;
+} // end Rps_NumVectZone::compute_hash
+
+
+template<typename NumT, Rps_Type vecty>
+Rps_ObjectRef
+Rps_NumVectZone<NumT,vecty>::compute_class(Rps_CallFrame*stkf __attribute__((unused))) const
+{
+  /// no specific root class for numeric vectors yet
+  return RPS_ROOT_OB(_6XLY6QfcDre02922jz); //value∈class
+} // end Rps_NumVectZone::compute_class
+
+
+/// dumped as {"vtype":"dblvect","len":N,"b64":"..."} where b64 is the
+/// base64 encoding of the little endian elements
+template<typename NumT, Rps_Type vecty>
+Json::Value
+Rps_NumVectZone<NumT,vecty>::dump_json(Rps_Dumper*du) const
+{
+  RPS_ASSERT(du != nullptr);
+  Json::Value jv(Json::objectValue);
+  jv["vtype"] = json_vtype;
+  jv["len"] = Json::Value((Json::UInt)_nvlen);
+  jv["b64"] = rps_base64_encode(_nvdata, _nvlen*sizeof(NumT));
+  return jv;
+} // end Rps_NumVectZone::dump_json
+
+
+template<typename NumT, Rps_Type vecty>
+const Rps_NumVectZone<NumT,vecty>*
+Rps_NumVectZone<NumT,vecty>::load_from_json(Rps_Loader*ld, const Json::Value& jv)
+{
+  RPS_ASSERT(ld != nullptr);
+  if (!jv.isObject() || !jv["len"].isUInt() || !jv["b64"].isString())
+    throw RPS_RUNTIME_ERROR_OUT("Rps_NumVectZone::load_from_json bad jv=" << jv);
+  unsigned len = jv["len"].asUInt();
+  std::string bytes;
+  if (!rps_base64_decode(jv["b64"].asString(), bytes)
+      || bytes.size() != len*sizeof(NumT))
+    throw RPS_RUNTIME_ERROR_OUT("Rps_NumVectZone::load_from_json bad b64 of len " << len
+                                << " in jv=" << jv);
+  return make(reinterpret_cast<const NumT*>(bytes.data()), len);
+} // end Rps_NumVectZone::load_from_json
+
+
+template<typename NumT, Rps_Type vecty>
+void
+Rps_NumVectZone<NumT,vecty>::val_output(std::ostream& outs, unsigned depth, unsigned maxdepth) const
+{
+  /// nested vectors are shown abbreviated
+  unsigned maxshown = (depth==0)?_nvlen:8;
+  outs << json_vtype << "[";
+  if (depth > maxdepth)
+    maxshown = 0;
+  for (unsigned ix=0; ix<_nvlen && ix<maxshown; ix++)
+    {
+      if (ix>0)
+        outs << ' ';
+      if constexpr (std::is_floating_point_v<NumT>)
+        Rps_Double::output_double(outs, _nvdata[ix]);
+      else
+        outs << _nvdata[ix];
+    };
+  if (maxshown < _nvlen)
+    outs << "…/" << _nvlen;
+  outs << "]";
+} // end Rps_NumVectZone::val_output
+
+
+template<typename NumT, Rps_Type vecty>
+bool
+Rps_NumVectZone<NumT,vecty>::equal(const Rps_ZoneValue&zv) const
+{
+  if (zv.stored_type() != vecty)
+    return false;
+  auto othv = reinterpret_cast<const Rps_NumVectZone*>(&zv);
+  if (othv->_nvlen != _nvlen)
+    return false;
+  auto lh = lazy_hash();
+  auto othlh = othv->lazy_hash();
+  if (lh != 0 && othlh != 0 && lh != othlh)
+    return false;
+  /// identical bits are equal, even for NaN-s
+  if (!memcmp((const void*)_nvdata, (const void*)othv->_nvdata, _nvlen*sizeof(NumT)))
+    return true;
+  return std::equal(_nvdata, _nvdata+_nvlen, othv->_nvdata);
+} // end Rps_NumVectZone::equal
+
+
+template<typename NumT, Rps_Type vecty>
+bool
+Rps_NumVectZone<NumT,vecty>::less(const Rps_ZoneValue&zv) const
+{
+  if (zv.stored_type() != vecty)
+    return vecty < zv.stored_type();
+  auto othv = reinterpret_cast<const Rps_NumVectZone*>(&zv);
+  return std::lexicographical_compare(_nvdata, _nvdata+_nvlen,
+                                      othv->_nvdata, othv->_nvdata+othv->_nvlen,
+                                      elem_less);
+} // end Rps_NumVectZone::less
+
+
+////////////////////////////////////////////////////////////////
+//// kernels
+
+template<typename NumT, Rps_Type vecty>
+NumT
+Rps_NumVectZone<NumT,vecty>::sum(void) const
+{
+  typedef rps_numvect_acc_t<NumT> acc_t;
+  acc_t acc0=0, acc1=0, acc2=0, acc3=0;
+  unsigned ix = 0;
+  for (; ix+4 <= _nvlen; ix += 4)
+    {
+      acc0 += (acc_t)_nvdata[ix];
+      acc1 += (acc_t)_nvdata[ix+1];
+      acc2 += (acc_t)_nvdata[ix+2];
+      acc3 += (acc_t)_nvdata[ix+3];
+    };
+  for (; ix < _nvlen; ix++)
+    acc0 += (acc_t)_nvdata[ix];
+  return (NumT)((acc0+acc1) + (acc2+acc3));
+} // end Rps_NumVectZone::sum
+
+
+template<typename NumT, Rps_Type vecty>
+NumT
+Rps_NumVectZone<NumT,vecty>::dot(const Rps_NumVectZone*oth) const
+{
+  typedef rps_numvect_acc_t<NumT> acc_t;
+  if (!oth || oth->_nvlen != _nvlen)
+    throw std::invalid_argument("Rps_NumVectZone::dot length mismatch");
+  const NumT* __restrict__ pa = _nvdata;
+  const NumT* __restrict__ pb = oth->_nvdata;
+  acc_t acc0=0, acc1=0, acc2=0, acc3=0;
+  unsigned ix = 0;
+  for (; ix+4 <= _nvlen; ix += 4)
+    {
+      acc0 += (acc_t)pa[ix] * (acc_t)pb[ix];
+      acc1 += (acc_t)pa[ix+1] * (acc_t)pb[ix+1];
+      acc2 += (acc_t)pa[ix+2] * (acc_t)pb[ix+2];
+      acc3 += (acc_t)pa[ix+3] * (acc_t)pb[ix+3];
+    };
+  for (; ix < _nvlen; ix++)
+    acc0 += (acc_t)pa[ix] * (acc_t)pb[ix];
+  return (NumT)((acc0+acc1) + (acc2+acc3));
+} // end Rps_NumVectZone::dot
+
+
+template<typename NumT, Rps_Type vecty>
+NumT
+Rps_NumVectZone<NumT,vecty>::minimum(void) const
+{
+  if (_nvlen == 0)
+    throw std::range_error("Rps_NumVectZone::minimum of empty vector");
+  NumT m0 = _nvdata[0], m1 = m0, m2 = m0, m3 = m0;
+  unsigned ix = 0;
+  for (; ix+4 <= _nvlen; ix += 4)
+    {
+      m0 = (_nvdata[ix] < m0)?_nvdata[ix]:m0;
+      m1 = (_nvdata[ix+1] < m1)?_nvdata[ix+1]:m1;
+      m2 = (_nvdata[ix+2] < m2)?_nvdata[ix+2]:m2;
+      m3 = (_nvdata[ix+3] < m3)?_nvdata[ix+3]:m3;
+    };
+  for (; ix < _nvlen; ix++)
+    m0 = (_nvdata[ix] < m0)?_nvdata[ix]:m0;
+  m0 = (m1 < m0)?m1:m0;
+  m2 = (m3 < m2)?m3:m2;
+  return (m2 < m0)?m2:m0;
+} // end Rps_NumVectZone::minimum
+
+
+template<typename NumT, Rps_Type vecty>
+NumT
+Rps_NumVectZone<NumT,vecty>::maximum(void) const
+{
+  if (_nvlen == 0)
+    throw std::range_error("Rps_NumVectZone::maximum of empty vector");
+  NumT m0 = _nvdata[0], m1 = m0, m2 = m0, m3 = m0;
+  unsigned ix = 0;
+  for (; ix+4 <= _nvlen; ix += 4)
+    {
+      m0 = (_nvdata[ix] > m0)?_nvdata[ix]:m0;
+      m1 = (_nvdata[ix+1] > m1)?_nvdata[ix+1]:m1;
+      m2 = (_nvdata[ix+2] > m2)?_nvdata[ix+2]:m2;
+      m3 = (_nvdata[ix+3] > m3)?_nvdata[ix+3]:m3;
+    };
+  for (; ix < _nvlen; ix++)
+    m0 = (_nvdata[ix] > m0)?_nvdata[ix]:m0;
+  m0 = (m1 > m0)?m1:m0;
+  m2 = (m3 > m2)?m3:m2;
+  return (m2 > m0)?m2:m0;
+} // end Rps_NumVectZone::maximum
+
+
+/// the loop of every elementwise operation; RIGHTSTRIDE is 0 for a
+/// scalar right operand
+template<typename NumT, char op>
+static inline void
+rps_numvect_loop(NumT* __restrict__ pres, const NumT* __restrict__ pl,
+                 const NumT* __restrict__ pr, unsigned rightstride, unsigned len)
+{
+  typedef rps_numvect_acc_t<NumT> acc_t;
+  for (unsigned ix=0; ix<len; ix++)
+    {
+      acc_t l = (acc_t)pl[ix];
+      acc_t r = (acc_t)pr[ix*rightstride];
+      if constexpr (op == '+')
+        pres[ix] = (NumT)(l + r);
+      else if constexpr (op == '-')
+        pres[ix] = (NumT)(l - r);
+      else if constexpr (op == '*')
+        pres[ix] = (NumT)(l * r);
+      else if constexpr (op == '/')
+        pres[ix] = pl[ix] / pr[ix*rightstride];
+    }
+} // end rps_numvect_loop
+
+
+template<typename NumT>
+static void
+rps_numvect_apply(NumT*pres, const NumT*pl, const NumT*pr,
+                  unsigned rightstride, unsigned len, char op)
+{
+  if constexpr (std::is_integral_v<NumT>)
+    if (op == '/')
+      {
+        for (unsigned ix=0; ix<len; ix++)
+          {
+            NumT r = pr[ix*rightstride];
+            if (r == 0)
+              throw std::domain_error("numeric vector integer division by zero");
+            if (r == -1 && pl[ix] == std::numeric_limits<NumT>::min())
+              throw std::domain_error("numeric vector integer division overflow");
+          }
+      };
+  switch (op)
+    {
+    case '+':
+      rps_numvect_loop<NumT,'+'>(pres, pl, pr, rightstride, len);
+      return;
+    case '-':
+      rps_numvect_loop<NumT,'-'>(pres, pl, pr, rightstride, len);
+      return;
+    case '*':
+      rps_numvect_loop<NumT,'*'>(pres, pl, pr, rightstride, len);
+      return;
+    case '/':
+      rps_numvect_loop<NumT,'/'>(pres, pl, pr, rightstride, len);
+      return;
+    default:
+      throw std::invalid_argument(std::string("bad numeric vector operation ") + op);
+    }
+} // end rps_numvect_apply
+
+
+template<typename NumT, Rps_Type vecty>
+const Rps_NumVectZone<NumT,vecty>*
+Rps_NumVectZone<NumT,vecty>::elementwise(const Rps_NumVectZone*left, char op,
+    const Rps_NumVectZone*right)
+{
+  if (!left || !right || left->_nvlen != right->_nvlen)
+    throw std::invalid_argument("Rps_NumVectZone::elementwise length mismatch");
+  Rps_NumVectZone* nv = make_uninit(left->_nvlen);
+  rps_numvect_apply<NumT>(nv->_nvdata, left->_nvdata, right->_nvdata,
+                          1, left->_nvlen, op);
+  nv->finish_make();
+  return nv;
+} // end Rps_NumVectZone::elementwise
+
+
+template<typename NumT, Rps_Type vecty>
+const Rps_NumVectZone<NumT,vecty>*
+Rps_NumVectZone<NumT,vecty>::scalar_op(char op, NumT scal) const
+{
+  Rps_NumVectZone* nv = make_uninit(_nvlen);
+  rps_numvect_apply<NumT>(nv->_nvdata, _nvdata, &scal, 0, _nvlen, op);
+  nv->finish_make();
+  return nv;
+} // end Rps_NumVectZone::scalar_op
+
+
+template<typename NumT, Rps_Type vecty>
+const Rps_NumVectZone<NumT,vecty>*
+Rps_NumVectZone<NumT,vecty>::sorted(void) const
+{
+  if (_nvsorted)
+    return this;
+  Rps_NumVectZone* nv = make_uninit(_nvlen);
+  memcpy((void*)nv->_nvdata, (const void*)_nvdata, _nvlen*sizeof(NumT));
+  std::sort(nv->_nvdata, nv->_nvdata+_nvlen, elem_less);
+  nv->_nvsorted = true;
+  return nv;
+} // end Rps_NumVectZone::sorted
+
+
+template<typename NumT, Rps_Type vecty>
+int
+Rps_NumVectZone<NumT,vecty>::search(NumT x) const
+{
+  if (_nvsorted)
+    {
+      const NumT* pos = std::lower_bound(_nvdata, _nvdata+_nvlen, x, elem_less);
+      if (pos < _nvdata+_nvlen && *pos == x)
+        return (int)(pos - _nvdata);
+      return -1;
+    };
+  for (unsigned ix=0; ix<_nvlen; ix++)
+    if (_nvdata[ix] == x)
+      return (int)ix;
+  return -1;
+} // end Rps_NumVectZone::search
+
+
+template class Rps_NumVectZone<double,Rps_Type::DoubleVect>;
+template class Rps_NumVectZone<std::int64_t,Rps_Type::IntVect>;
+
+//// end of file numvect_rps.cc
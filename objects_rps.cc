@@ -52,9 +52,24 @@ const char rps_objects_baseid[]= RPS_BASEID;
 
 std::unordered_map<Rps_Id,Rps_ObjectZone*,Rps_Id::Hasher> Rps_ObjectZone::ob_idmap_(50777);
 
-std::map<Rps_Id,Rps_ObjectZone*> Rps_ObjectZone::ob_idbucketmap_[Rps_Id::maxbuckets];
+Rps_RadixTrie<Rps_ObjectZone*,Rps_Id::b62_char_rank> Rps_ObjectZone::ob_idtrie_;
 std::recursive_mutex Rps_ObjectZone::ob_idmtx_;
 
+std::unordered_map<Rps_ObjectZone*,std::unordered_set<Rps_ObjectZone*>> Rps_ObjectZone::ob_extentmap_;
+std::recursive_mutex Rps_ObjectZone::ob_extentmtx_;
+
+std::unordered_map<Rps_ObjectZone*,std::unordered_map<Rps_ObjectZone*,unsigned>> Rps_ObjectZone::ob_refsmap_;
+std::unordered_map<Rps_ObjectZone*,std::unordered_set<Rps_ObjectZone*>> Rps_ObjectZone::ob_referrersmap_;
+std::atomic<bool> Rps_ObjectZone::ob_referrersactive_;
+std::atomic<bool> Rps_ObjectZone::ob_referrersbuilding_;
+std::unordered_set<Rps_ObjectZone*> Rps_ObjectZone::ob_referrerspending_;
+std::recursive_mutex Rps_ObjectZone::ob_referrersmtx_;
+std::mutex Rps_ObjectZone::ob_referrersbuildmtx_;
+
+std::unordered_map<Rps_ObjectZone*,Rps_ObjectZone::attrindex_t> Rps_ObjectZone::ob_attrindexmap_;
+std::atomic<unsigned> Rps_ObjectZone::ob_attrindexcount_;
+std::recursive_mutex Rps_ObjectZone::ob_attrindexmtx_;
+
 
 
 // Build an object from its existing string oid, or else fail with C++ exception
@@ -104,14 +119,14 @@ Rps_ObjectRef::compare_for_display(const Rps_ObjectRef leftob,
     Rps_Value leftvalname =
       leftob->get_physical_attr(RPS_ROOT_OB(_1EBVGSfW2m200z18rx)); // /name∈named_attribute
     if (leftvalname.is_string())
-      sleftname = leftvalname.as_string()->cppstring();
+      sleftname = leftvalname.as_cppstring();
   }
   {
     std::lock_guard<std::recursive_mutex> guright(*rightob->objmtxptr());
     Rps_Value rightvalname =
       rightob->get_physical_attr(RPS_ROOT_OB(_1EBVGSfW2m200z18rx)); // /name∈named_attribute
     if (rightvalname.is_string())
-      srightname = rightvalname.as_string()->cppstring();
+      srightname = rightvalname.as_cppstring();
   }
   if (!sleftname.empty() && !srightname.empty())
     {
@@ -164,7 +179,7 @@ Rps_ObjectRef::output(std::ostream&outs, unsigned depth, unsigned maxdepth) cons
         outs << std::flush;
       if (valname.is_string())
         {
-          outs << "/" << valname.as_cstring();
+          outs << "/" << valname.as_cppstring();
           if (depth <= 1)
             outs << std::flush;
         }
@@ -265,6 +280,7 @@ Rps_ObjectZone::val_output(std::ostream&out, unsigned depth, unsigned maxdepth)
   out << oid().to_string();
   if (depth<2)
     {
+      materialize();
       std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
       out << "⟦"; // U+27E6 MATHEMATICAL LEFT WHITE SQUARE BRACKET
       auto namit = ob_attrs.find(RPS_ROOT_OB(_1EBVGSfW2m200z18rx)); //name∈named_attribute);
@@ -274,7 +290,7 @@ Rps_ObjectZone::val_output(std::ostream&out, unsigned depth, unsigned maxdepth)
           if (namv.is_string())
             {
               out << "⏵"; // U+23F5 BLACK MEDIUM RIGHT-POINTING TRIANGLE
-              out << namv.as_cstring();
+              out << namv.as_cppstring();
             }
         }
       auto obcl = ob_class.load();
@@ -304,7 +320,7 @@ Rps_ObjectZone::register_objzone(Rps_ObjectZone*obz)
   if (ob_idmap_.find(oid) != ob_idmap_.end())
     RPS_FATALOUT("Rps_ObjectZone::register_objzone duplicate oid " << oid);
   ob_idmap_.insert({oid,obz});
-  ob_idbucketmap_[oid.bucket_num()].insert({oid,obz});
+  ob_idtrie_.insert(oid.to_string(), obz);
 } // end Rps_ObjectZone::register_objzone
 
 Rps_Id
@@ -332,7 +348,8 @@ Rps_ObjectZone::Rps_ObjectZone(Rps_Id oid, registermode_en regmod)
     ob_space(nullptr), ob_mtime(0.0),
     ob_attrs(), ob_comps(), ob_payload(nullptr),
     ob_magicgetterfun(nullptr),
-    ob_applyingfun(nullptr)
+    ob_applyingfun(nullptr),
+    ob_lazystate(OBLAZY_NONE)
 {
   RPS_DEBUG_LOG(LOWREP, "Rps_ObjectZone oid=" << oid << ' '
                 << (regmod==OBZ_DONT_REGISTER?"non-":"") << "registering"
@@ -351,7 +368,7 @@ Rps_ObjectZone::Rps_ObjectZone(Rps_Id oid, registermode_en regmod)
   // Every object should have a class, initially `object`; the
   // ob_class can later be replaced, but we need something which is
   // not null.... That atomic field could be later overwritten.
-  ob_class.store(RPS_ROOT_OB(_5yhJGgxLwLp00X0xEQ)); //object∈class
+  change_class(RPS_ROOT_OB(_5yhJGgxLwLp00X0xEQ)); //object∈class
 } // end Rps_ObjectZone::Rps_ObjectZone
 
 
@@ -360,15 +377,41 @@ Rps_ObjectZone::~Rps_ObjectZone()
   //  RPS_INFORMOUT("destroying object " << oid());
   Rps_Id curid = oid();
   RPS_POSSIBLE_BREAKPOINT();
+  /// forget the references first, so that clearing the payload does
+  /// not look at them
+  if (referrers_tracked())
+    forget_references();
   clear_payload();
+  if (ob_attrindexcount_.load() > 0)
+    {
+      std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+      for (auto& it : ob_attrindexmap_)
+        {
+          auto atit = ob_attrs.find(Rps_ObjectRef(it.first));
+          if (atit != ob_attrs.end())
+            attr_index_change(this, it.first, atit->second, nullptr);
+        }
+    };
   ob_attrs.clear();
   ob_comps.clear();
-  ob_class.store(nullptr);
+  {
+    /// not thru change_class, which would note the references of the
+    /// class, maybe already freed by the GC
+    std::lock_guard<std::recursive_mutex> guext(ob_extentmtx_);
+    Rps_ObjectZone*oldclass = ob_class.exchange(nullptr);
+    auto it = oldclass?ob_extentmap_.find(oldclass):ob_extentmap_.end();
+    if (it != ob_extentmap_.end())
+      {
+        it->second.erase(this);
+        if (it->second.empty())
+          ob_extentmap_.erase(it);
+      }
+  }
   ob_mtime.store(0.0);
   std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
   RPS_DEBUG_LOG(LOWREP,"~Rps_ObjectZone curid=" << curid << " this=" << this);
   ob_idmap_.erase(curid);
-  ob_idbucketmap_[curid.bucket_num()].erase(curid);
+  ob_idtrie_.remove(curid.to_string());
 } // end Rps_ObjectZone::~Rps_ObjectZone()
 
 
@@ -385,6 +428,7 @@ Rps_ObjectZone::Rps_ObjectZone() :
 void
 Rps_ObjectZone::put_applying_function(rps_applyingfun_t*afun)
 {
+  materialize();
   auto oldappfun = ob_applyingfun.exchange(afun);
   if (oldappfun)
     {
@@ -411,7 +455,7 @@ Rps_ObjectZone::make(void)
   // Every object should have a class, initially `object`; the
   // ob_class can later be replaced, but we need something which is
   // not null.... That atomic field could be later overwritten.
-  obz->ob_class.store(RPS_ROOT_OB(_5yhJGgxLwLp00X0xEQ)); //object∈class
+  obz->change_class(RPS_ROOT_OB(_5yhJGgxLwLp00X0xEQ)); //object∈class
   RPS_DEBUG_LOG(LOWREP, "Rps_ObjectZone::make oid=" << oid << " obz=" << obz
                 << std::endl
                 << RPS_FULL_BACKTRACE(1, "Rps_ObjectZone::make"));
@@ -430,7 +474,7 @@ Rps_ObjectZone::make_loaded(Rps_Id oid, Rps_Loader* ld)
   // Every object should have a class, initially `object`; the
   // ob_class can later be replaced, but we need something which is
   // not null.... The loader could later overwrite that.
-  obz->ob_class.store(RPS_ROOT_OB(_5yhJGgxLwLp00X0xEQ)); //object∈class
+  obz->change_class(RPS_ROOT_OB(_5yhJGgxLwLp00X0xEQ)); //object∈class
   return obz;
 } // end Rps_ObjectZone::make_loaded
 
@@ -492,6 +536,850 @@ Rps_ObjectZone::put_space(Rps_ObjectRef obr)
   ob_mtime.store(rps_wallclock_real_time());
 } // end Rps_ObjectZone::put_space
 
+void
+Rps_ObjectZone::change_class(Rps_ObjectZone*obzclass)
+{
+  Rps_ObjectZone*oldclass = nullptr;
+  {
+    /// the exchange is done under the extent lock, so concurrent
+    /// reclassifications of this object update the extents in the
+    /// same order as ob_class
+    std::lock_guard<std::recursive_mutex> gu(ob_extentmtx_);
+    oldclass = ob_class.exchange(obzclass);
+    if (oldclass == obzclass)
+      return;
+    if (oldclass)
+      {
+        auto it = ob_extentmap_.find(oldclass);
+        if (it != ob_extentmap_.end())
+          {
+            it->second.erase(this);
+            if (it->second.empty())
+              ob_extentmap_.erase(it);
+          }
+      };
+    if (obzclass)
+      ob_extentmap_[obzclass].insert(this);
+  }
+  note_references(Rps_ObjectRef(oldclass), Rps_ObjectRef(obzclass));
+} // end Rps_ObjectZone::change_class
+
+void
+Rps_ObjectZone::put_class(Rps_ObjectRef obclass)
+{
+  if (!obclass || !obclass->is_class())
+    throw std::runtime_error("invalid class object");
+  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  change_class(obclass.optr());
+  ob_mtime.store(rps_wallclock_real_time());
+} // end Rps_ObjectZone::put_class
+
+unsigned
+Rps_ObjectZone::class_extent_size(Rps_ObjectRef obclass)
+{
+  if (!obclass)
+    return 0;
+  std::lock_guard<std::recursive_mutex> gu(ob_extentmtx_);
+  auto it = ob_extentmap_.find(obclass.optr());
+  if (it == ob_extentmap_.end())
+    return 0;
+  return it->second.size();
+} // end Rps_ObjectZone::class_extent_size
+
+std::vector<Rps_ObjectRef>
+Rps_ObjectZone::class_extent(Rps_ObjectRef obclass)
+{
+  std::vector<Rps_ObjectRef> vecob;
+  if (!obclass)
+    return vecob;
+  std::lock_guard<std::recursive_mutex> gu(ob_extentmtx_);
+  auto it = ob_extentmap_.find(obclass.optr());
+  if (it == ob_extentmap_.end())
+    return vecob;
+  vecob.reserve(it->second.size());
+  for (Rps_ObjectZone*obz : it->second)
+    vecob.push_back(Rps_ObjectRef(obz));
+  return vecob;
+} // end Rps_ObjectZone::class_extent
+
+Rps_SetValue
+Rps_ObjectZone::class_extent_set(Rps_ObjectRef obclass)
+{
+  return Rps_SetValue(class_extent(obclass));
+} // end Rps_ObjectZone::class_extent_set
+
+void
+Rps_ObjectZone::iterate_class_extent(Rps_ObjectRef obclass, void*data,
+                                     const std::function<bool(void*,Rps_ObjectRef)>&stopfun)
+{
+  RPS_ASSERT(stopfun);
+  for (Rps_ObjectRef obinst : class_extent(obclass))
+    if (stopfun(data, obinst))
+      break;
+} // end Rps_ObjectZone::iterate_class_extent
+
+/// update the index of OBZATTR, when OBZ changes it from OLDVAL to
+/// NEWVAL; ob_attrindexmtx_ should be locked
+void
+Rps_ObjectZone::attr_index_change(Rps_ObjectZone*obz, Rps_ObjectZone*obzattr,
+                                  Rps_Value oldval, Rps_Value newval)
+{
+  auto ixit = ob_attrindexmap_.find(obzattr);
+  if (ixit == ob_attrindexmap_.end())
+    return;
+  attrindex_t& attrindex = ixit->second;
+  if (oldval && Rps_Value::compare_total(oldval, newval) == 0)
+    return;
+  if (oldval)
+    {
+      auto valit = attrindex.find(oldval);
+      if (valit != attrindex.end())
+        {
+          valit->second.erase(obz);
+          if (valit->second.empty())
+            attrindex.erase(valit);
+        }
+    };
+  if (newval)
+    attrindex[newval].insert(obz);
+} // end Rps_ObjectZone::attr_index_change
+
+void
+Rps_ObjectZone::add_attribute_index(Rps_ObjectRef obattr)
+{
+  if (!obattr || has_attribute_index(obattr))
+    return;
+  rps_load_materialize_all();
+  rebuild_attribute_indexes({obattr});
+} // end Rps_ObjectZone::add_attribute_index
+
+void
+Rps_ObjectZone::remove_attribute_index(Rps_ObjectRef obattr)
+{
+  if (!obattr)
+    return;
+  std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+  if (ob_attrindexmap_.erase(obattr.optr()) > 0)
+    ob_attrindexcount_.store(ob_attrindexmap_.size());
+} // end Rps_ObjectZone::remove_attribute_index
+
+bool
+Rps_ObjectZone::has_attribute_index(Rps_ObjectRef obattr)
+{
+  if (!obattr || ob_attrindexcount_.load() == 0)
+    return false;
+  std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+  return ob_attrindexmap_.find(obattr.optr()) != ob_attrindexmap_.end();
+} // end Rps_ObjectZone::has_attribute_index
+
+std::vector<Rps_ObjectRef>
+Rps_ObjectZone::attribute_indexes(void)
+{
+  std::vector<Rps_ObjectRef> vecattr;
+  std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+  vecattr.reserve(ob_attrindexmap_.size());
+  for (auto& it : ob_attrindexmap_)
+    vecattr.push_back(Rps_ObjectRef(it.first));
+  std::sort(vecattr.begin(), vecattr.end(),
+            [](Rps_ObjectRef leftob, Rps_ObjectRef rightob)
+  {
+    return leftob->oid() < rightob->oid();
+  });
+  return vecattr;
+} // end Rps_ObjectZone::attribute_indexes
+
+/// the number of threads of a parallel scan, NBTHREADS or else the
+/// --jobs count, up to RPS_NBJOBS_MAX; rps_parallel_ranges lowers it
+/// for small scans
+static unsigned
+rps_parallel_threads(unsigned nbthreads)
+{
+  if (nbthreads == 0)
+    nbthreads = rps_nbjobs;
+  if (nbthreads > RPS_NBJOBS_MAX)
+    nbthreads = RPS_NBJOBS_MAX;
+  return (nbthreads > 0)?nbthreads:1;
+} // end rps_parallel_threads
+
+/// the fewest objects scanned by each thread of a heap scan
+static constexpr size_t rps_heap_scan_minrange = 8192;
+
+void
+Rps_ObjectZone::rebuild_attribute_indexes(const std::vector<Rps_ObjectRef>&vecattr,
+    unsigned nbthreads)
+{
+  if (vecattr.empty())
+    return;
+  std::vector<Rps_ObjectZone*> vecobz;
+  {
+    std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
+    vecobz.reserve(ob_idmap_.size());
+    for (auto& it : ob_idmap_)
+      if (it.second)
+        vecobz.push_back(it.second);
+  }
+  nbthreads = rps_parallel_threads(nbthreads);
+  /// the indexes are registered empty before the scan, so attr_store
+  /// keeps them up to date meanwhile; every object is added under its
+  /// ob_mtx, taken before ob_attrindexmtx_ like in attr_store, so a
+  /// concurrent change of its attributes comes wholly before or after
+  {
+    std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+    for (Rps_ObjectRef obattr : vecattr)
+      if (obattr)
+        ob_attrindexmap_[obattr.optr()].clear();
+    ob_attrindexcount_.store(ob_attrindexmap_.size());
+  }
+  auto scanrange = [&](size_t from, size_t to)
+  {
+    for (size_t ix=from; ix<to; ix++)
+      {
+        Rps_ObjectZone*obz = vecobz[ix];
+        std::lock_guard<std::recursive_mutex> guob(obz->ob_mtx);
+        if (obz->ob_attrs.empty())
+          continue;
+        for (Rps_ObjectRef obattr : vecattr)
+          {
+            auto atit = obz->ob_attrs.find(obattr);
+            if (atit == obz->ob_attrs.end() || !atit->second)
+              continue;
+            std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+            auto ixit = ob_attrindexmap_.find(obattr.optr());
+            /// the index could have been removed meanwhile
+            if (ixit != ob_attrindexmap_.end())
+              ixit->second[atit->second].insert(obz);
+          }
+      }
+  };
+  try
+    {
+      rps_parallel_ranges(vecobz.size(), nbthreads, rps_heap_scan_minrange, scanrange);
+    }
+  catch (...)
+    {
+      /// an incomplete index would give wrong answers, without it the
+      /// objects are scanned
+      std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+      for (Rps_ObjectRef obattr : vecattr)
+        if (obattr)
+          ob_attrindexmap_.erase(obattr.optr());
+      ob_attrindexcount_.store(ob_attrindexmap_.size());
+      throw;
+    }
+  RPS_DEBUG_LOG(LOWREP, "rebuild_attribute_indexes of " << vecattr.size()
+                << " attributes scanned " << vecobz.size() << " objects in "
+                << nbthreads << " threads");
+} // end Rps_ObjectZone::rebuild_attribute_indexes
+
+std::vector<Rps_ObjectRef>
+Rps_ObjectZone::objects_with_attribute(Rps_ObjectRef obattr, Rps_Value val)
+{
+  std::vector<Rps_ObjectRef> vecob;
+  if (!obattr || !val)
+    return vecob;
+  /// lazily loaded objects get their attributes once materialized
+  rps_load_materialize_all();
+  if (ob_attrindexcount_.load() > 0)
+    {
+      std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+      auto ixit = ob_attrindexmap_.find(obattr.optr());
+      if (ixit != ob_attrindexmap_.end())
+        {
+          auto valit = ixit->second.find(val);
+          if (valit != ixit->second.end())
+            {
+              vecob.reserve(valit->second.size());
+              for (Rps_ObjectZone*obz : valit->second)
+                vecob.push_back(Rps_ObjectRef(obz));
+            }
+          return vecob;
+        }
+    };
+  /// not indexed, so scan every object; they are copied under
+  /// ob_idmtx_ which is released before locking each of them
+  std::vector<Rps_ObjectZone*> vecobz;
+  {
+    std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
+    vecobz.reserve(ob_idmap_.size());
+    for (auto& it : ob_idmap_)
+      if (it.second)
+        vecobz.push_back(it.second);
+  }
+  for (Rps_ObjectZone*obz : vecobz)
+    {
+      std::lock_guard<std::recursive_mutex> guob(obz->ob_mtx);
+      auto atit = obz->ob_attrs.find(obattr);
+      if (atit != obz->ob_attrs.end()
+          && Rps_Value::compare_total(atit->second, val) == 0)
+        vecob.push_back(Rps_ObjectRef(obz));
+    }
+  return vecob;
+} // end Rps_ObjectZone::objects_with_attribute
+
+Rps_SetValue
+Rps_ObjectZone::set_of_objects_with_attribute(Rps_ObjectRef obattr, Rps_Value val)
+{
+  return Rps_SetValue(objects_with_attribute(obattr, val));
+} // end Rps_ObjectZone::set_of_objects_with_attribute
+
+void
+Rps_ObjectZone::gc_mark_attribute_indexes(Rps_GarbageCollector*gc)
+{
+  RPS_ASSERT(gc != nullptr);
+  std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+  for (auto& ixit : ob_attrindexmap_)
+    {
+      gc->mark_obj(Rps_ObjectRef(ixit.first));
+      for (auto& valit : ixit.second)
+        gc->mark_value(valit.first);
+    }
+} // end Rps_ObjectZone::gc_mark_attribute_indexes
+
+
+void
+rps_each_object_in_value(Rps_Value v, const std::function<void(Rps_ObjectZone*)>&f,
+                         unsigned depth)
+{
+  constexpr unsigned maxdepth = 32;
+  if (!v || !v.is_ptr() || depth > maxdepth)
+    return;
+  if (v.is_object())
+    f(v.as_object());
+  else if (v.is_set())
+    {
+      const Rps_SetOb*set = v.as_set();
+      for (unsigned ix=0; ix<set->cnt(); ix++)
+        f(set->at(ix).optr());
+    }
+  else if (v.is_tuple())
+    {
+      const Rps_TupleOb*tup = v.as_tuple();
+      for (unsigned ix=0; ix<tup->cnt(); ix++)
+        if (tup->at(ix))
+          f(tup->at(ix).optr());
+    }
+  else if (v.is_closure() || v.is_instance())
+    {
+      auto each_son = [&](auto tree)
+      {
+        if (tree->conn())
+          f(tree->conn().optr());
+        for (Rps_Value son : *tree)
+          rps_each_object_in_value(son, f, depth+1);
+      };
+      if (v.is_closure())
+        each_son(v.as_closure());
+      else
+        each_son(v.as_instance());
+    }
+  else if (v.is_hamt())
+    {
+      v.as_hamt()->each_entry([&](Rps_Value key, Rps_Value val)
+      {
+        rps_each_object_in_value(key, f, depth+1);
+        rps_each_object_in_value(val, f, depth+1);
+        return false;
+      });
+    }
+} // end rps_each_object_in_value
+
+void
+Rps_ObjectZone::each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const
+{
+  if (Rps_ObjectZone*obcla = ob_class.load())
+    f(obcla);
+  for (auto& atit : ob_attrs)
+    {
+      f(atit.first.optr());
+      rps_each_object_in_value(atit.second, f);
+    }
+  for (Rps_Value compv : ob_comps)
+    rps_each_object_in_value(compv, f);
+  Rps_Payload*payl = ob_payload.load();
+  if (payl && payl->owner() == this)
+    payl->each_referenced_object(f);
+} // end Rps_ObjectZone::each_referenced_object
+
+/// add DELTA to the count of references from OBSRC to OBTARGET;
+/// ob_referrersmtx_ should be locked
+void
+Rps_ObjectZone::referrers_count(Rps_ObjectZone*obsrc, Rps_ObjectZone*obtarget, int delta)
+{
+  if (!obsrc || !obtarget || delta == 0)
+    return;
+  if (delta > 0)
+    {
+      auto& srcrefs = ob_refsmap_[obsrc];
+      auto it = srcrefs.find(obtarget);
+      if (it == srcrefs.end())
+        {
+          srcrefs.insert({obtarget, (unsigned)delta});
+          ob_referrersmap_[obtarget].insert(obsrc);
+        }
+      else
+        it->second += delta;
+      return;
+    };
+  auto srcit = ob_refsmap_.find(obsrc);
+  if (srcit == ob_refsmap_.end())
+    return;
+  auto& srcrefs = srcit->second;
+  auto it = srcrefs.find(obtarget);
+  if (it == srcrefs.end())
+    return;
+  if (it->second > (unsigned)(-delta))
+    {
+      it->second += delta;
+      return;
+    };
+  srcrefs.erase(it);
+  if (srcrefs.empty())
+    ob_refsmap_.erase(srcit);
+  auto refit = ob_referrersmap_.find(obtarget);
+  if (refit != ob_referrersmap_.end())
+    {
+      refit->second.erase(obsrc);
+      if (refit->second.empty())
+        ob_referrersmap_.erase(refit);
+    }
+} // end Rps_ObjectZone::referrers_count
+
+void
+Rps_ObjectZone::update_references(Rps_Value oldval, Rps_Value newval)
+{
+  if (oldval == newval)
+    return;
+  std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+  if (!referrers_tracked())
+    return;
+  /// an object not yet scanned by build_referrers_index gets its
+  /// references counted when it is
+  if (RPS_UNLIKELY(ob_referrerspending_.find(this) != ob_referrerspending_.end()))
+    return;
+  rps_each_object_in_value(oldval, [this](Rps_ObjectZone*obz)
+  {
+    referrers_count(this, obz, -1);
+  });
+  rps_each_object_in_value(newval, [this](Rps_ObjectZone*obz)
+  {
+    referrers_count(this, obz, +1);
+  });
+} // end Rps_ObjectZone::update_references
+
+/// called by the destructor before the payload is cleared; it only
+/// uses the referrers maps, never the values of this object, some of
+/// which may already be freed by the GC
+void
+Rps_ObjectZone::forget_references(void)
+{
+  std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+  ob_referrerspending_.erase(this);
+  auto srcit = ob_refsmap_.find(this);
+  if (srcit != ob_refsmap_.end())
+    {
+      for (auto& tgit : srcit->second)
+        {
+          auto refit = ob_referrersmap_.find(tgit.first);
+          if (refit == ob_referrersmap_.end())
+            continue;
+          refit->second.erase(this);
+          if (refit->second.empty())
+            ob_referrersmap_.erase(refit);
+        }
+      ob_refsmap_.erase(srcit);
+    };
+  auto refit = ob_referrersmap_.find(this);
+  if (refit != ob_referrersmap_.end())
+    {
+      for (Rps_ObjectZone*obsrc : refit->second)
+        {
+          auto othsrcit = ob_refsmap_.find(obsrc);
+          if (othsrcit != ob_refsmap_.end())
+            othsrcit->second.erase(this);
+        }
+      ob_referrersmap_.erase(refit);
+    }
+} // end Rps_ObjectZone::forget_references
+
+/// called with ob_mtx locked when OLDPAYL is replaced or cleared
+void
+Rps_ObjectZone::forget_payload_references(Rps_Payload*oldpayl)
+{
+  if (!oldpayl || !referrers_tracked())
+    return;
+  std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+  /// nothing to uncount, notably in the destructor once
+  /// forget_references ran
+  if (ob_refsmap_.find(this) == ob_refsmap_.end()
+      || ob_referrerspending_.find(this) != ob_referrerspending_.end())
+    return;
+  oldpayl->each_referenced_object([this](Rps_ObjectZone*obz)
+  {
+    referrers_count(this, obz, -1);
+  });
+} // end Rps_ObjectZone::forget_payload_references
+
+void
+Rps_ObjectZone::build_referrers_index(unsigned nbthreads)
+{
+  std::lock_guard<std::mutex> gubuild(ob_referrersbuildmtx_);
+  /// references are only known once every object is materialized
+  rps_load_materialize_all();
+  std::vector<Rps_ObjectZone*> vecobz;
+  {
+    std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
+    vecobz.reserve(ob_idmap_.size());
+    for (auto& it : ob_idmap_)
+      if (it.second)
+        vecobz.push_back(it.second);
+  }
+  nbthreads = rps_parallel_threads(nbthreads);
+  double startrealt = rps_elapsed_real_time();
+  /// the maps are filled while scanning, and changes are counted
+  /// meanwhile for objects already scanned. Every object is counted
+  /// with its ob_mtx locked, then ob_referrersmtx_, in the same order
+  /// as update_references, so its changes come wholly before or after
+  {
+    std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+    ob_referrersactive_.store(false);
+    ob_refsmap_.clear();
+    ob_referrersmap_.clear();
+    ob_referrerspending_.clear();
+    ob_referrerspending_.insert(vecobz.begin(), vecobz.end());
+    ob_referrersbuilding_.store(true);
+  }
+  auto scanrange = [&](size_t from, size_t to)
+  {
+    std::vector<Rps_ObjectZone*> targetvec;
+    for (size_t ix=from; ix<to; ix++)
+      {
+        Rps_ObjectZone*obz = vecobz[ix];
+        std::lock_guard<std::recursive_mutex> guob(obz->ob_mtx);
+        targetvec.clear();
+        obz->each_referenced_object([&](Rps_ObjectZone*obtarget)
+        {
+          targetvec.push_back(obtarget);
+        });
+        std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+        ob_referrerspending_.erase(obz);
+        for (Rps_ObjectZone*obtarget : targetvec)
+          referrers_count(obz, obtarget, +1);
+      }
+  };
+  try
+    {
+      rps_parallel_ranges(vecobz.size(), nbthreads, rps_heap_scan_minrange, scanrange);
+    }
+  catch (...)
+    {
+      /// a partial index is dropped, and built again on next use
+      std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+      ob_refsmap_.clear();
+      ob_referrersmap_.clear();
+      ob_referrerspending_.clear();
+      ob_referrersbuilding_.store(false);
+      throw;
+    }
+  std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+  ob_referrerspending_.clear();
+  ob_referrersactive_.store(true);
+  ob_referrersbuilding_.store(false);
+  RPS_DEBUG_LOG(LOWREP, "build_referrers_index scanned " << vecobz.size()
+                << " objects in " << nbthreads << " threads, "
+                << ob_referrersmap_.size() << " referred objects, in "
+                << (rps_elapsed_real_time() - startrealt) << " s");
+} // end Rps_ObjectZone::build_referrers_index
+
+void
+Rps_ObjectZone::drop_referrers_index(void)
+{
+  std::lock_guard<std::mutex> gubuild(ob_referrersbuildmtx_);
+  std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+  ob_referrersactive_.store(false);
+  ob_refsmap_.clear();
+  ob_referrersmap_.clear();
+} // end Rps_ObjectZone::drop_referrers_index
+
+/// a problem found by check_heap_integrity in the object of oid
+/// HP_OID in the space HP_SPACE
+struct rps_heap_problem_st
+{
+  Rps_Id hp_oid;
+  Rps_Id hp_space;
+  std::string hp_message;
+};
+
+unsigned
+Rps_ObjectZone::check_heap_integrity(unsigned nbthreads)
+{
+  double startrealt = rps_elapsed_real_time();
+  std::vector<Rps_ObjectZone*> vecobz;
+  {
+    std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
+    vecobz.reserve(ob_idmap_.size());
+    for (auto& it : ob_idmap_)
+      if (it.second)
+        vecobz.push_back(it.second);
+  }
+  /// the known objects sorted by address, so a dangling reference is
+  /// detected without being dereferenced
+  std::vector<const Rps_ObjectZone*> sortedobz(vecobz.begin(), vecobz.end());
+  std::sort(sortedobz.begin(), sortedobz.end());
+  auto known = [&](const Rps_ObjectZone*obz)
+  {
+    return std::binary_search(sortedobz.begin(), sortedobz.end(), obz);
+  };
+  /// likewise every live zone, so that a freed value is never
+  /// classified nor scanned
+  std::vector<const Rps_QuasiZone*> livezones = Rps_QuasiZone::sorted_live_zones();
+  auto live = [&](const Rps_ZoneValue*zv)
+  {
+    return std::binary_search(livezones.begin(), livezones.end(),
+                              static_cast<const Rps_QuasiZone*>(zv));
+  };
+  nbthreads = rps_parallel_threads(nbthreads);
+  const Rps_ObjectZone*obtopclass = RPS_ROOT_OB(_6XLY6QfcDre02922jz).optr(); //value∈class
+  /// the problems of each range, keyed by its start to report them in
+  /// order, and the lazy objects skipped
+  std::mutex problemtx;
+  std::map<size_t,std::vector<rps_heap_problem_st>> problemap;
+  std::atomic<unsigned> nblazy(0);
+  auto scanrange = [&](size_t from, size_t to)
+  {
+    std::vector<rps_heap_problem_st> problemvec;
+    std::vector<std::pair<Rps_ObjectZone*,Rps_Value>> attrvec;
+    std::vector<Rps_Value> compvec;
+    Rps_ObjectZone*curobz = nullptr;
+    Rps_ObjectZone*curspace = nullptr;
+    auto problem = [&](const std::string&msg)
+    {
+      problemvec.push_back(rps_heap_problem_st{curobz->oid(),
+                           curspace?curspace->oid():Rps_Id(), msg});
+    };
+    /// the raw pointers are checked before being dereferenced
+    std::function<void(Rps_Value,const char*,int,unsigned)> check_references
+      = [&](Rps_Value v, const char*where, int ix, unsigned depth)
+    {
+      constexpr unsigned maxdepth = 32;
+      if (!v || !v.is_ptr() || depth > maxdepth)
+        return;
+      auto dangling = [&](const char*what)
+      {
+        problem(std::string("dangling ") + what + " in " + where
+                + (ix>=0?(" #" + std::to_string(ix)):std::string()));
+      };
+      if (!live(v.as_ptr()))
+        {
+          dangling("value");
+          return;
+        }
+      if (v.is_object())
+        {
+          if (!known(v.as_object()))
+            dangling("object reference");
+        }
+      else if (v.is_set() || v.is_tuple())
+        {
+          auto each_elem = [&](auto seqob)
+          {
+            for (unsigned eix=0; eix<seqob->cnt(); eix++)
+              if (Rps_ObjectZone*obelem = seqob->at(eix).optr())
+                if (!known(obelem))
+                  dangling("object reference");
+          };
+          if (v.is_set())
+            each_elem(v.as_set());
+          else
+            each_elem(v.as_tuple());
+        }
+      else if (v.is_closure() || v.is_instance())
+        {
+          auto each_son = [&](auto tree)
+          {
+            if (Rps_ObjectZone*obconn = tree->conn().optr())
+              if (!known(obconn))
+                {
+                  dangling("connective");
+                  return false;
+                }
+            for (Rps_Value son : *tree)
+              check_references(son, where, ix, depth+1);
+            return true;
+          };
+          if (v.is_closure())
+            (void) each_son(v.as_closure());
+          else if (each_son(v.as_instance()))
+            {
+              /// the connective of an instance is its class
+              Rps_ObjectZone*obinstclass = v.as_instance()->get_class().optr();
+              if (!obinstclass)
+                problem(std::string("instance without class in ") + where);
+              else if (!obinstclass->get_classinfo_payload())
+                problem(std::string("instance in ") + where + " of class "
+                        + obinstclass->oid().to_string() + " without class information");
+            }
+        }
+      else if (v.is_hamt())
+        {
+          v.as_hamt()->each_entry([&](Rps_Value key, Rps_Value val)
+          {
+            check_references(key, where, ix, depth+1);
+            check_references(val, where, ix, depth+1);
+            return false;
+          });
+        }
+    };
+    for (size_t ix=from; ix<to; ix++)
+      {
+        curobz = vecobz[ix];
+        /// the lazily loaded objects not yet materialized have no
+        /// content to check
+        if (curobz->is_lazy())
+          {
+            nblazy++;
+            continue;
+          }
+        Rps_ObjectZone*obclass = nullptr;
+        Rps_ObjectZone*obsuper = nullptr;
+        Rps_PayloadClassInfo*pclassinfo = nullptr;
+        Rps_PayloadSymbol*psymbol = nullptr;
+        attrvec.clear();
+        compvec.clear();
+        /// copy the content, to check it without holding the lock of
+        /// this object while locking other ones
+        {
+          std::lock_guard<std::recursive_mutex> guob(curobz->ob_mtx);
+          obclass = curobz->ob_class.load();
+          curspace = curobz->ob_space.load();
+          for (auto& atit : curobz->ob_attrs)
+            attrvec.push_back({atit.first.optr(), atit.second});
+          compvec = curobz->ob_comps;
+          pclassinfo = curobz->get_dynamic_payload<Rps_PayloadClassInfo>();
+          if (pclassinfo)
+            obsuper = pclassinfo->superclass().optr();
+          psymbol = curobz->get_dynamic_payload<Rps_PayloadSymbol>();
+        }
+        if (curspace && !known(curspace))
+          {
+            curspace = nullptr;
+            problem("dangling space");
+          }
+        if (!obclass)
+          problem("without class");
+        else if (!known(obclass))
+          problem("dangling class");
+        else if (!obclass->get_classinfo_payload())
+          problem("its class " + obclass->oid().to_string() + " has no class information");
+        for (auto& atit : attrvec)
+          {
+            if (!known(atit.first))
+              {
+                problem("dangling attribute");
+                continue;
+              }
+            check_references(atit.second, "value of attribute", -1, 0);
+          }
+        for (int cix=0; cix<(int)compvec.size(); cix++)
+          check_references(compvec[cix], "component", cix, 0);
+        /// follow the superclasses up to the top class value
+        if (pclassinfo)
+          {
+            constexpr unsigned maxdepth = 256;
+            unsigned depth = 0;
+            const Rps_ObjectZone*obcurclass = curobz;
+            while (obcurclass != obtopclass && obsuper != obcurclass)
+              {
+                if (!obsuper || !known(obsuper))
+                  {
+                    problem("missing or dangling superclass above "
+                            + obcurclass->oid().to_string());
+                    break;
+                  }
+                auto psuperinfo = obsuper->get_dynamic_payload<Rps_PayloadClassInfo>();
+                if (!psuperinfo)
+                  {
+                    problem("superclass " + obsuper->oid().to_string()
+                            + " without class information");
+                    break;
+                  }
+                if (++depth > maxdepth || obsuper == curobz)
+                  {
+                    problem("cycle of superclasses thru " + obsuper->oid().to_string());
+                    break;
+                  }
+                obcurclass = obsuper;
+                std::lock_guard<std::recursive_mutex> gusuper(obsuper->ob_mtx);
+                obsuper = psuperinfo->superclass().optr();
+              }
+            if (obcurclass != obtopclass && obsuper == obcurclass)
+              problem("superclass loop on " + obcurclass->oid().to_string()
+                      + " not being the top class value");
+          }
+        if (psymbol
+            && Rps_PayloadSymbol::find_named_payload(psymbol->symbol_name()) != psymbol)
+          problem("symbol " + psymbol->symbol_name() + " missing from symb_table");
+      }
+    std::lock_guard<std::mutex> gupb(problemtx);
+    problemap[from] = std::move(problemvec);
+  };
+  constexpr unsigned maxshown = 64;
+  unsigned nbproblems = 0;
+  /// the check should survive the heap it diagnoses, so a failed scan
+  /// is one more problem
+  try
+    {
+      rps_parallel_ranges(vecobz.size(), nbthreads, rps_heap_scan_minrange, scanrange);
+    }
+  catch (const std::exception&exc)
+    {
+      RPS_WARNOUT("heap integrity: check failed: " << exc.what());
+      nbproblems++;
+    }
+  for (auto& pbit : problemap)
+    {
+      for (auto& prob : pbit.second)
+        {
+          if (nbproblems++ < maxshown)
+            RPS_WARNOUT("heap integrity: object " << prob.hp_oid
+                        << " in space " << prob.hp_space
+                        << ": " << prob.hp_message);
+        }
+    }
+  if (nbproblems > maxshown)
+    RPS_WARNOUT("heap integrity: " << (nbproblems - maxshown)
+                << " more problems not shown");
+  RPS_INFORMOUT("checked the integrity of " << (vecobz.size() - nblazy.load()) << " objects"
+                << (nblazy.load()?(" (" + std::to_string(nblazy.load()) + " lazy ones skipped)"):std::string(""))
+                << " in " << nbthreads << " threads, found " << nbproblems
+                << " problems in " << (rps_elapsed_real_time() - startrealt) << " s");
+  return nbproblems;
+} // end Rps_ObjectZone::check_heap_integrity
+
+std::vector<Rps_ObjectRef>
+Rps_ObjectZone::referrers(Rps_ObjectRef obtarget)
+{
+  std::vector<Rps_ObjectRef> vecob;
+  if (!obtarget)
+    return vecob;
+  /// the build locks objects, so not with ob_referrersmtx_ locked
+  if (!ob_referrersactive_.load())
+    build_referrers_index();
+  std::lock_guard<std::recursive_mutex> guref(ob_referrersmtx_);
+  auto refit = ob_referrersmap_.find(obtarget.optr());
+  if (refit == ob_referrersmap_.end())
+    return vecob;
+  vecob.reserve(refit->second.size());
+  for (Rps_ObjectZone*obsrc : refit->second)
+    vecob.push_back(Rps_ObjectRef(obsrc));
+  return vecob;
+} // end Rps_ObjectZone::referrers
+
+Rps_SetValue
+Rps_ObjectZone::set_of_referrers(Rps_ObjectRef obtarget)
+{
+  return Rps_SetValue(referrers(obtarget));
+} // end Rps_ObjectZone::set_of_referrers
+
 
 
 void
@@ -506,17 +1394,47 @@ Rps_ObjectZone::remove_attr(const Rps_ObjectRef obattr)
       throw RPS_RUNTIME_ERROR_OUT("cannot remove magic attribute " << obattr
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
-  ob_attrs.erase(obattr);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
+  attr_store(obattr, nullptr);
   ob_mtime.store(rps_wallclock_real_time());
 } // end Rps_ObjectZone::remove_attr
 
+void
+Rps_ObjectZone::attr_store(Rps_ObjectRef obattr, Rps_Value val)
+{
+  bool withattrindex = ob_attrindexcount_.load() > 0;
+  bool withreferrers = referrers_tracked();
+  if (RPS_UNLIKELY(withattrindex || withreferrers))
+    {
+      Rps_Value oldval;
+      auto it = ob_attrs.find(obattr);
+      if (it != ob_attrs.end())
+        oldval = it->second;
+      if (withattrindex)
+        {
+          std::lock_guard<std::recursive_mutex> guix(ob_attrindexmtx_);
+          if (ob_attrindexmap_.find(obattr.optr()) != ob_attrindexmap_.end())
+            attr_index_change(this, obattr.optr(), oldval, val);
+        };
+      if (withreferrers)
+        {
+          update_references(oldval?Rps_Value(obattr):Rps_Value(nullptr),
+                            val?Rps_Value(obattr):Rps_Value(nullptr));
+          update_references(oldval, val);
+        };
+    };
+  if (val.is_empty())
+    ob_attrs.erase(obattr);
+  else
+    ob_attrs.insert_or_assign(obattr, val);
+} // end Rps_ObjectZone::attr_store
+
 
 Rps_Value
 Rps_ObjectZone::set_of_physical_attributes(void) const
 {
   RPS_ASSERT(stored_type() == Rps_Type::Object);
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   unsigned nbat = ob_attrs.size();
   std::vector<Rps_ObjectRef> vecat;
   vecat.reserve(nbat);
@@ -539,7 +1457,7 @@ unsigned
 Rps_ObjectZone::nb_physical_attributes(void) const
 {
   RPS_ASSERT(stored_type() == Rps_Type::Object);
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   return ob_attrs.size();
 } // end Rps_ObjectZone::nb_physical_attributes
 
@@ -547,7 +1465,7 @@ unsigned
 Rps_ObjectZone::nb_attributes([[maybe_unused]] Rps_CallFrame*stkf) const
 {
   RPS_ASSERT(!stkf || stkf->is_good_call_frame());
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   return ob_attrs.size();
 } // end Rps_ObjectZone::nb_attributes
 
@@ -558,7 +1476,7 @@ Rps_ObjectZone::get_attr1(Rps_CallFrame*stkf,const Rps_ObjectRef obattr0) const
   if (obattr0.is_empty() || obattr0->stored_type() != Rps_Type::Object)
     return nullptr;
   Rps_Value val0;
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   {
     rps_magicgetterfun_t*getfun0 = obattr0->ob_magicgetterfun.load();
     if (RPS_UNLIKELY(getfun0))
@@ -581,7 +1499,7 @@ Rps_ObjectZone::get_physical_attr(const Rps_ObjectRef obattr0) const
   if (obattr0.is_empty() || obattr0->stored_type() != Rps_Type::Object)
     return nullptr;
   Rps_Value val0;
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   auto it0 = ob_attrs.find(obattr0);
   if (it0 != ob_attrs.end())
     val0 = it0->second;
@@ -600,7 +1518,7 @@ Rps_ObjectZone::get_attr2(Rps_CallFrame*stkf, const Rps_ObjectRef obattr0, const
     return Rps_TwoValues(nullptr,nullptr);
   Rps_Value val0;
   Rps_Value val1;
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   {
     rps_magicgetterfun_t*getfun0 = obattr0->ob_magicgetterfun.load();
     if (RPS_UNLIKELY(getfun0))
@@ -639,7 +1557,7 @@ Rps_ObjectZone::put_attr(const Rps_ObjectRef obattr, const Rps_Value valattr)
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
+  std::lock_guard gu(*objmtxptr());
 #warning debug stuff in ObjectZone::put_attr is temporary in end of jan 2025
   RPS_POSSIBLE_BREAKPOINT();
   RPS_DEBUG_LOG(REPL, "Rps_ObjectZone::put_attr/start *this="
@@ -649,10 +1567,7 @@ Rps_ObjectZone::put_attr(const Rps_ObjectRef obattr, const Rps_Value valattr)
                 << RPS_FULL_BACKTRACE(1, "Rps_ObjectZone::put_attr")
                 << RPS_OBJECT_DISPLAY(this));
   RPS_POSSIBLE_BREAKPOINT();
-  if (valattr.is_empty())
-    ob_attrs.erase(obattr);
-  else
-    ob_attrs.insert_or_assign(obattr, valattr);
+  attr_store(obattr, valattr);
   ob_mtime.store(rps_wallclock_real_time());
   RPS_DEBUG_LOG(REPL, "Rps_ObjectZone::put_attr/end"
                 << RPS_OBJECT_DISPLAY(this));
@@ -680,15 +1595,9 @@ Rps_ObjectZone::put_attr2(const Rps_ObjectRef obattr0, const Rps_Value valattr0,
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr1
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
-  if (valattr0.is_empty())
-    ob_attrs.erase(obattr0);
-  else
-    ob_attrs.insert_or_assign(obattr0, valattr0);
-  if (valattr1.is_empty())
-    ob_attrs.erase(obattr1);
-  else
-    ob_attrs.insert_or_assign(obattr1, valattr1);
+  std::lock_guard gu(*objmtxptr());
+  attr_store(obattr0, valattr0);
+  attr_store(obattr1, valattr1);
   ob_mtime.store(rps_wallclock_real_time());
 } // end Rps_ObjectZone::put_attr2
 
@@ -722,19 +1631,10 @@ Rps_ObjectZone::put_attr3(const Rps_ObjectRef obattr0, const Rps_Value valattr0,
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr2
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
-  if (valattr0.is_empty())
-    ob_attrs.erase(obattr0);
-  else
-    ob_attrs.insert_or_assign(obattr0, valattr0);
-  if (valattr1.is_empty())
-    ob_attrs.erase(obattr1);
-  else
-    ob_attrs.insert_or_assign(obattr1, valattr1);
-  if (valattr2.is_empty())
-    ob_attrs.erase(obattr2);
-  else
-    ob_attrs.insert_or_assign(obattr2, valattr2);
+  std::lock_guard gu(*objmtxptr());
+  attr_store(obattr0, valattr0);
+  attr_store(obattr1, valattr1);
+  attr_store(obattr2, valattr2);
   ob_mtime.store(rps_wallclock_real_time());
 } // end Rps_ObjectZone::put_attr3
 
@@ -778,23 +1678,11 @@ Rps_ObjectZone::put_attr4(const Rps_ObjectRef obattr0, const Rps_Value valattr0,
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr3
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
-  if (valattr0.is_empty())
-    ob_attrs.erase(obattr0);
-  else
-    ob_attrs.insert_or_assign(obattr0, valattr0);
-  if (valattr1.is_empty())
-    ob_attrs.erase(obattr1);
-  else
-    ob_attrs.insert_or_assign(obattr1, valattr1);
-  if (valattr2.is_empty())
-    ob_attrs.erase(obattr2);
-  else
-    ob_attrs.insert_or_assign(obattr2, valattr2);
-  if (valattr3.is_empty())
-    ob_attrs.erase(obattr3);
-  else
-    ob_attrs.insert_or_assign(obattr3, valattr3);
+  std::lock_guard gu(*objmtxptr());
+  attr_store(obattr0, valattr0);
+  attr_store(obattr1, valattr1);
+  attr_store(obattr2, valattr2);
+  attr_store(obattr3, valattr3);
   ob_mtime.store(rps_wallclock_real_time());
 } // end Rps_ObjectZone::put_attr4
 
@@ -811,7 +1699,7 @@ Rps_ObjectZone::exchange_attr(const Rps_ObjectRef obattr, const Rps_Value valatt
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
+  std::lock_guard gu(*objmtxptr());
   Rps_Value oldval;
   if (poldval)
     {
@@ -819,10 +1707,7 @@ Rps_ObjectZone::exchange_attr(const Rps_ObjectRef obattr, const Rps_Value valatt
       if (it != ob_attrs.end())
         oldval = it->second;
     }
-  if (valattr.is_empty())
-    ob_attrs.erase(obattr);
-  else
-    ob_attrs.insert_or_assign(obattr, valattr);
+  attr_store(obattr, valattr);
   if (poldval)
     *poldval = oldval;
   ob_mtime.store(rps_wallclock_real_time());
@@ -850,7 +1735,7 @@ Rps_ObjectZone::exchange_attr2(const Rps_ObjectRef obattr0, const Rps_Value vala
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr1
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
+  std::lock_guard gu(*objmtxptr());
   Rps_Value oldval0;
   Rps_Value oldval1;
   if (poldval0)
@@ -865,14 +1750,8 @@ Rps_ObjectZone::exchange_attr2(const Rps_ObjectRef obattr0, const Rps_Value vala
       if (it != ob_attrs.end())
         oldval1 = it->second;
     }
-  if (valattr0.is_empty())
-    ob_attrs.erase(obattr0);
-  else
-    ob_attrs.insert_or_assign(obattr0, valattr0);
-  if (valattr1.is_empty())
-    ob_attrs.erase(obattr1);
-  else
-    ob_attrs.insert_or_assign(obattr1, valattr1);
+  attr_store(obattr0, valattr0);
+  attr_store(obattr1, valattr1);
   if (poldval0)
     *poldval0 = oldval0;
   if (poldval1)
@@ -910,7 +1789,7 @@ Rps_ObjectZone::exchange_attr3(const Rps_ObjectRef obattr0, const Rps_Value vala
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr2
                                   << " in " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
+  std::lock_guard gu(*objmtxptr());
   Rps_Value oldval0;
   Rps_Value oldval1;
   Rps_Value oldval2;
@@ -932,18 +1811,9 @@ Rps_ObjectZone::exchange_attr3(const Rps_ObjectRef obattr0, const Rps_Value vala
       if (it != ob_attrs.end())
         oldval2 = it->second;
     }
-  if (valattr0.is_empty())
-    ob_attrs.erase(obattr0);
-  else
-    ob_attrs.insert_or_assign(obattr0, valattr0);
-  if (valattr1.is_empty())
-    ob_attrs.erase(obattr1);
-  else
-    ob_attrs.insert_or_assign(obattr1, valattr1);
-  if (valattr2.is_empty())
-    ob_attrs.erase(obattr2);
-  else
-    ob_attrs.insert_or_assign(obattr2, valattr2);
+  attr_store(obattr0, valattr0);
+  attr_store(obattr1, valattr1);
+  attr_store(obattr2, valattr2);
   if (poldval0)
     *poldval0 = oldval0;
   if (poldval1)
@@ -993,7 +1863,7 @@ Rps_ObjectZone::exchange_attr4(const Rps_ObjectRef obattr0, const Rps_Value vala
       throw RPS_RUNTIME_ERROR_OUT("cannot put magic attribute " << obattr3
                                   << " from " << Rps_ObjectRef(this));
   }
-  std::lock_guard gu(ob_mtx);
+  std::lock_guard gu(*objmtxptr());
   Rps_Value oldval0;
   Rps_Value oldval1;
   Rps_Value oldval2;
@@ -1022,22 +1892,10 @@ Rps_ObjectZone::exchange_attr4(const Rps_ObjectRef obattr0, const Rps_Value vala
       if (it != ob_attrs.end())
         oldval3 = it->second;
     }
-  if (valattr0.is_empty())
-    ob_attrs.erase(obattr0);
-  else
-    ob_attrs.insert_or_assign(obattr0, valattr0);
-  if (valattr1.is_empty())
-    ob_attrs.erase(obattr1);
-  else
-    ob_attrs.insert_or_assign(obattr1, valattr1);
-  if (valattr2.is_empty())
-    ob_attrs.erase(obattr2);
-  else
-    ob_attrs.insert_or_assign(obattr2, valattr2);
-  if (valattr3.is_empty())
-    ob_attrs.erase(obattr3);
-  else
-    ob_attrs.insert_or_assign(obattr3, valattr3);
+  attr_store(obattr0, valattr0);
+  attr_store(obattr1, valattr1);
+  attr_store(obattr2, valattr2);
+  attr_store(obattr3, valattr3);
   if (poldval0)
     *poldval0 = oldval0;
   if (poldval1)
@@ -1055,21 +1913,21 @@ Rps_ObjectZone::exchange_attr4(const Rps_ObjectRef obattr0, const Rps_Value vala
 unsigned
 Rps_ObjectZone::nb_physical_components(void) const
 {
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   return ob_comps.size();
 } // end Rps_ObjectZone::nb_physical_components
 
 const std::vector<Rps_Value>
 Rps_ObjectZone::vector_physical_components(void) const
 {
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   return ob_comps;
 } // end Rps_ObjectZone::vector_physical_components
 
 unsigned
 Rps_ObjectZone::nb_components([[maybe_unused]] Rps_CallFrame*stkf) const
 {
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   unsigned nbcomp = ob_comps.size();
   return nbcomp;
 } // end Rps_ObjectZone::nb_components
@@ -1077,7 +1935,7 @@ Rps_ObjectZone::nb_components([[maybe_unused]] Rps_CallFrame*stkf) const
 Rps_Value
 Rps_ObjectZone::component_at ([[maybe_unused]] Rps_CallFrame*stkf, int rk, bool dontfail) const
 {
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   unsigned nbcomp = ob_comps.size();
   if (rk<0) rk += nbcomp;
   if (rk>=0 && rk<(int)nbcomp)
@@ -1090,12 +1948,13 @@ Rps_ObjectZone::component_at ([[maybe_unused]] Rps_CallFrame*stkf, int rk, bool
 Rps_Value
 Rps_ObjectZone::replace_component_at ([[maybe_unused]] Rps_CallFrame*stkf, int rk,  Rps_Value comp0, bool dontfail)
 {
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   unsigned nbcomp = ob_comps.size();
   if (rk<0) rk += nbcomp;
   if (rk>=0 && rk<(int)nbcomp)
     {
       Rps_Value oldv =  ob_comps[rk];
+      note_references(oldv, comp0);
       ob_comps[rk] = comp0;
       touch_now();
       return oldv;
@@ -1111,7 +1970,8 @@ Rps_ObjectZone::append_comp1(Rps_Value comp0)
   RPS_ASSERT(stored_type() == Rps_Type::Object);
   if (RPS_UNLIKELY(comp0.is_empty()))
     comp0.clear();
-  std::lock_guard gu(ob_mtx);
+  std::lock_guard gu(*objmtxptr());
+  note_references(nullptr, comp0);
   ob_comps.push_back(comp0);
 } // end Rps_ObjectZone::append_comp1
 
@@ -1125,13 +1985,15 @@ Rps_ObjectZone::append_comp2(Rps_Value comp0, Rps_Value comp1)
     comp0.clear();
   if (RPS_UNLIKELY(comp1.is_empty()))
     comp1.clear();
-  std::lock_guard gu(ob_mtx);
+  std::lock_guard gu(*objmtxptr());
   // we want to avoid too frequent resizes, so....
   if (RPS_UNLIKELY(ob_comps.capacity() < ob_comps.size() + 2))
     {
       auto newsiz = rps_prime_above(9*ob_comps.size()/8 + 2);
       ob_comps.reserve(newsiz);
     };
+  note_references(nullptr, comp0);
+  note_references(nullptr, comp1);
   ob_comps.push_back(comp0);
   ob_comps.push_back(comp1);
 } // end Rps_ObjectZone::append_comp2
@@ -1148,13 +2010,16 @@ Rps_ObjectZone::append_comp3(Rps_Value comp0, Rps_Value comp1, Rps_Value comp2)
     comp1.clear();
   if (RPS_UNLIKELY(comp2.is_empty()))
     comp2.clear();
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   // we want to avoid too frequent resizes, so....
   if (RPS_UNLIKELY(ob_comps.capacity() < ob_comps.size() + 3))
     {
       auto newsiz = rps_prime_above(9*ob_comps.size()/8 + 3);
       ob_comps.reserve(newsiz);
     };
+  note_references(nullptr, comp0);
+  note_references(nullptr, comp1);
+  note_references(nullptr, comp2);
   ob_comps.push_back(comp0);
   ob_comps.push_back(comp1);
   ob_comps.push_back(comp2);
@@ -1172,13 +2037,17 @@ Rps_ObjectZone::append_comp4(Rps_Value comp0, Rps_Value comp1, Rps_Value comp2,
     comp2.clear();
   if (RPS_UNLIKELY(comp3.is_empty()))
     comp3.clear();
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   // we want to avoid too frequent resizes, so....
   if (RPS_UNLIKELY(ob_comps.capacity() < ob_comps.size() + 4))
     {
       auto newsiz = rps_prime_above(9*ob_comps.size()/8 + 4);
       ob_comps.reserve(newsiz);
     };
+  note_references(nullptr, comp0);
+  note_references(nullptr, comp1);
+  note_references(nullptr, comp2);
+  note_references(nullptr, comp3);
   ob_comps.push_back(comp0);
   ob_comps.push_back(comp1);
   ob_comps.push_back(comp2);
@@ -1191,7 +2060,7 @@ Rps_ObjectZone::append_components(const std::initializer_list<Rps_Value>&compil)
 {
   RPS_ASSERT(stored_type() == Rps_Type::Object);
   unsigned nbv = compil.size();
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   // we want to avoid too frequent resizes, so....
   if (RPS_UNLIKELY(ob_comps.capacity() < ob_comps.size() + nbv))
     {
@@ -1202,6 +2071,7 @@ Rps_ObjectZone::append_components(const std::initializer_list<Rps_Value>&compil)
     {
       if (RPS_UNLIKELY(v.is_empty()))
         v.clear();
+      note_references(nullptr, v);
       ob_comps.push_back(v);
     }
 } // end Rps_ObjectZone::append_components
@@ -1211,7 +2081,7 @@ void
 Rps_ObjectZone::append_components(const std::vector<Rps_Value>&compvec)
 {
   RPS_ASSERT(stored_type() == Rps_Type::Object);
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   RPS_ASSERT(stored_type() == Rps_Type::Object);
   unsigned nbv = compvec.size();
   // we want to avoid too frequent resizes, so....
@@ -1224,6 +2094,7 @@ Rps_ObjectZone::append_components(const std::vector<Rps_Value>&compvec)
     {
       if (RPS_UNLIKELY(v.is_empty()))
         v.clear();
+      note_references(nullptr, v);
       ob_comps.push_back(v);
     }
 } // end Rps_ObjectZone::append_components
@@ -1235,7 +2106,7 @@ void
 Rps_ObjectZone::dump_scan_contents(Rps_Dumper*du) const
 {
   RPS_ASSERT(du != nullptr);
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   Rps_ObjectZone* obcla = ob_class.load();
   RPS_ASSERT(obcla != nullptr);
   rps_dump_scan_object(du, obcla);
@@ -1280,7 +2151,7 @@ Rps_ObjectZone::dump_json_content(Rps_Dumper*du, Json::Value&json) const
 {
   RPS_ASSERT(du != nullptr);
   RPS_ASSERT(json.type() == Json::objectValue);
-  std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+  std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
   Rps_ObjectRef thisob(this);
   Rps_ObjectZone* obcla = ob_class.load();
   RPS_ASSERT(obcla != nullptr);
@@ -1483,56 +2354,35 @@ Rps_ObjectZone::autocomplete_oid(const char*prefix,
                 << (prefix?"='":" ")
                 << (prefix?:"*none*")
                 << (prefix?"'":"."));
-  if (!prefix || prefix[0] != '_'
-      || !isdigit(prefix[1]) || !isalnum(prefix[2]) || !isalnum(prefix[3]))
+  if (!prefix || prefix[0] != '_' || !isdigit(prefix[1]))
     return 0;
-  int prefixlen = (int) strlen(prefix);
-  char bufid[24];
-  memset(bufid, 0, sizeof(bufid));
-  int lastix=0;
-  {
-    int ix=0;
-    bufid[0] = '_';
-    for (ix=1; ix<prefixlen && prefix[ix] != (char)0; ix++)
-      {
-        if (!strchr(Rps_Id::b62digits, prefix[ix]))
-          break;
-        bufid[ix] = prefix[ix];
-      }
-    lastix = ix;
-    for (ix=lastix; ix<(int)Rps_Id::nbchars; ix++)
-      {
-        bufid[ix] = '0';
-      };
-  }
-  Rps_Id idpref(bufid);
-  RPS_DEBUG_LOG(COMPL, "autocomplete_oid bufid='" << bufid << "' idpref=" << idpref);
-  constexpr char lastdigit = Rps_Id::b62digits[sizeof(Rps_Id::b62digits)-2];
-  RPS_DEBUG_LOG(COMPL, "autocomplete_oid lastdigit=" << (lastdigit?:'?') << " of code " << (int)lastdigit);
-  for (int ix=lastix; ix<(int)Rps_Id::nbchars; ix++)
-    {
-      bufid[ix] = lastdigit;
-    }
-  Rps_Id idlast(bufid);
-  RPS_DEBUG_LOG(COMPL, "autocomplete_oid bufid='" << bufid
-                << "', prefixlen=" << prefixlen
-                << ", idpref=" << idpref << ", idlast=" << idlast);
-  int count = 0;
-  std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
-  auto& curobuck = ob_idbucketmap_[idpref.bucket_num()];
-  for (auto it = curobuck.lower_bound(idpref); it != curobuck.end(); it++)
+  std::string prefstr("_");
+  for (int ix=1; prefix[ix] && ix<(int)Rps_Id::nbchars; ix++)
     {
-      Rps_Id curid = it->first;
-      if (curid > idlast)
-        break;
-      count++;
-      Rps_ObjectRef curobr = it->second;
-      if (stopfun(curobr))
+      if (!strchr(Rps_Id::b62digits, prefix[ix]))
         break;
+      prefstr.push_back(prefix[ix]);
     }
+  std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
+  int count = ob_idtrie_.each_with_prefix(prefstr,
+                                          [&](const std::string&, Rps_ObjectZone*const&obz)
+  {
+    return stopfun(obz);
+  });
+  RPS_DEBUG_LOG(COMPL, "autocomplete_oid prefstr='" << prefstr
+                << "' count=" << count);
   return count;
 } // end Rps_ObjectZone::autocomplete_oid
 
+size_t
+Rps_ObjectZone::count_oid_prefix(const char*prefix)
+{
+  if (!prefix || prefix[0] != '_')
+    return 0;
+  std::lock_guard<std::recursive_mutex> gu(ob_idmtx_);
+  return ob_idtrie_.count_prefix(prefix);
+} // end Rps_ObjectZone::count_oid_prefix
+
 
 
 ////////////////////////////////////////////////////////////////
@@ -1553,6 +2403,22 @@ Rps_PayloadClassInfo::gc_mark(Rps_GarbageCollector&gc) const
     gc.mark_value(atset);
 } // end Rps_PayloadClassInfo::gc_mark
 
+void
+Rps_PayloadClassInfo::each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const
+{
+  if (pclass_super)
+    f(pclass_super.optr());
+  if (pclass_symbname)
+    f(pclass_symbname.optr());
+  for (auto& it: pclass_methdict)
+    {
+      f(it.first.optr());
+      rps_each_object_in_value(it.second, f);
+    }
+  if (auto atset = attributes_set())
+    rps_each_object_in_value(Rps_Value(atset), f);
+} // end Rps_PayloadClassInfo::each_referenced_object
+
 void
 Rps_PayloadClassInfo::dump_scan(Rps_Dumper*du) const
 {
@@ -1627,6 +2493,7 @@ Rps_PayloadClassInfo::put_symbname(Rps_ObjectRef obr)
   if (symb && symb->owner() == obr)
     {
       symb->symbol_put_value(owner());
+      note_payload_references(pclass_symbname, obr);
       pclass_symbname = obr;
     }
 } // end Rps_PayloadClassInfo::put_symbname
@@ -1921,16 +2788,20 @@ Rps_PayloadSetOb::output_payload(std::ostream&out, unsigned depth, unsigned maxd
 void
 Rps_PayloadVectOb::gc_mark(Rps_GarbageCollector&gc) const
 {
-  for (auto obr: pvectob)
+  pvectob.each([&](Rps_ObjectRef obr)
+  {
     gc.mark_obj(obr);
+  });
 } // end Rps_PayloadVectOb::gc_mark
 
 void
 Rps_PayloadVectOb::dump_scan(Rps_Dumper*du) const
 {
   RPS_ASSERT(du != nullptr);
-  for (auto obr: pvectob)
+  pvectob.each([&](Rps_ObjectRef obr)
+  {
     rps_dump_scan_object(du, obr);
+  });
 } // end Rps_PayloadVectOb::dump_scan
 
 
@@ -1941,11 +2812,13 @@ Rps_PayloadVectOb::dump_json_content(Rps_Dumper*du, Json::Value&jv) const
   RPS_ASSERT(du != nullptr);
   RPS_ASSERT(jv.type() == Json::objectValue);
   Json::Value jarr(Json::arrayValue);
-  for (auto obr: pvectob)
+  pvectob.each([&](Rps_ObjectRef obr)
+  {
     if (rps_is_dumpable_objref(du,obr))
       jarr.append(rps_dump_json_objectref(du,obr));
     else
       jarr.append(Json::Value(Json::nullValue));
+  });
   jv["vectob"] = jarr;
 } // end Rps_PayloadVectOb::dump_json_content
 
@@ -1967,13 +2840,7 @@ Rps_PayloadVectOb::output_payload(std::ostream&out, unsigned depth, unsigned max
       out << BOLD_esc << "* empty object vector payload *" << NORM_esc << std::endl;
       return;
     }
-  std::vector<Rps_ObjectRef> vectcomp(vectsiz);
-  for (auto vectit: pvectob)
-    {
-      Rps_ObjectRef curob = *vectit;
-      RPS_ASSERT(curob);
-      vectcomp.push_back(curob);
-    };
+  std::vector<Rps_ObjectRef> vectcomp = pvectob.to_vector();
   if (vectsiz == 1)
     {
       out << BOLD_esc << "* singleton object vector payload *"
@@ -1996,23 +2863,135 @@ Rps_PayloadVectOb::output_payload(std::ostream&out, unsigned depth, unsigned max
 } // end of Rps_PayloadVectOb::output_payload
 
 
+//// common code for the bulk operations of vector payloads
+static constexpr size_t rps_vector_parallel_minrange = 4096;
+
+/// convert FROM and TO, possibly negative, to a range in [0,SIZ]
+static void
+rps_vector_slice_bounds(int&from, int&to, size_t siz)
+{
+  if (from < 0)
+    from += (int)siz;
+  if (to < 0)
+    to += (int)siz;
+  from = std::max(0, std::min(from, (int)siz));
+  to = std::max(from, std::min(to, (int)siz));
+} // end rps_vector_slice_bounds
+
+/// the map and filter run on a copy of the components, taken by the
+/// caller under the owner's lock, and released before any call of
+/// the function: so it may use or change the owner
+template <typename Elem>
+static std::vector<Rps_Value>
+rps_vector_parallel_map(const std::vector<Elem>&compvec,
+                        const std::function<Rps_Value(Elem)>&fun,
+                        unsigned nbthreads)
+{
+  std::vector<Rps_Value> resvec(compvec.size());
+  rps_parallel_ranges(compvec.size(), rps_parallel_threads(nbthreads),
+                      rps_vector_parallel_minrange,
+                      [&](size_t from, size_t to)
+  {
+    for (size_t ix=from; ix<to; ix++)
+      resvec[ix] = fun(compvec[ix]);
+  });
+  return resvec;
+} // end rps_vector_parallel_map
+
+template <typename Elem>
+static std::vector<Elem>
+rps_vector_parallel_filter(const std::vector<Elem>&compvec,
+                           const std::function<bool(Elem)>&pred,
+                           unsigned nbthreads)
+{
+  std::vector<char> keepvec(compvec.size());
+  rps_parallel_ranges(compvec.size(), rps_parallel_threads(nbthreads),
+                      rps_vector_parallel_minrange,
+                      [&](size_t from, size_t to)
+  {
+    for (size_t ix=from; ix<to; ix++)
+      keepvec[ix] = pred(compvec[ix]);
+  });
+  std::vector<Elem> resvec;
+  for (size_t ix=0; ix<compvec.size(); ix++)
+    if (keepvec[ix])
+      resvec.push_back(compvec[ix]);
+  return resvec;
+} // end rps_vector_parallel_filter
+
+void
+Rps_PayloadVectOb::append_objects(const std::vector<Rps_ObjectRef>&vecob)
+{
+  std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+  if (std::find(vecob.begin(), vecob.end(), Rps_ObjectRef(nullptr))
+      == vecob.end())
+    {
+      pvectob.append(vecob);
+      for (Rps_ObjectRef obr : vecob)
+        note_payload_references(nullptr, obr);
+      return;
+    };
+  pvectob.reserve(pvectob.size() + vecob.size());
+  for (Rps_ObjectRef obr : vecob)
+    push_back(obr);
+} // end Rps_PayloadVectOb::append_objects
+
+std::vector<Rps_ObjectRef>
+Rps_PayloadVectOb::slice(int from, int to) const
+{
+  std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+  rps_vector_slice_bounds(from, to, pvectob.size());
+  return pvectob.to_vector(from, to);
+} // end Rps_PayloadVectOb::slice
+
+std::vector<Rps_Value>
+Rps_PayloadVectOb::parallel_map(const std::function<Rps_Value(Rps_ObjectRef)>&fun,
+                                unsigned nbthreads) const
+{
+  RPS_ASSERT(fun);
+  std::vector<Rps_ObjectRef> compvec;
+  {
+    std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+    compvec = pvectob.to_vector();
+  }
+  return rps_vector_parallel_map<Rps_ObjectRef>(compvec, fun, nbthreads);
+} // end Rps_PayloadVectOb::parallel_map
+
+std::vector<Rps_ObjectRef>
+Rps_PayloadVectOb::parallel_filter(const std::function<bool(Rps_ObjectRef)>&pred,
+                                   unsigned nbthreads) const
+{
+  RPS_ASSERT(pred);
+  std::vector<Rps_ObjectRef> compvec;
+  {
+    std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+    compvec = pvectob.to_vector();
+  }
+  return rps_vector_parallel_filter<Rps_ObjectRef>(compvec, pred, nbthreads);
+} // end Rps_PayloadVectOb::parallel_filter
+
+
 /***************** mutable vector of values payload **********/
 
 void
 Rps_PayloadVectVal::gc_mark(Rps_GarbageCollector&gc) const
 {
-  for (auto compv: pvectval)
+  pvectval.each([&](Rps_Value compv)
+  {
     if (compv)
       gc.mark_value(compv);
+  });
 } // end Rps_PayloadVectVal::gc_mark
 
 void
 Rps_PayloadVectVal::dump_scan(Rps_Dumper*du) const
 {
   RPS_ASSERT(du != nullptr);
-  for (auto compv: pvectval)
+  pvectval.each([&](Rps_Value compv)
+  {
     if (compv)
       rps_dump_scan_value(du, compv, 0);
+  });
 } // end Rps_PayloadVectVal::dump_scan
 
 
@@ -2023,11 +3002,13 @@ Rps_PayloadVectVal::dump_json_content(Rps_Dumper*du, Json::Value&jv) const
   RPS_ASSERT(du != nullptr);
   RPS_ASSERT(jv.type() == Json::objectValue);
   Json::Value jarr(Json::arrayValue);
-  for (auto compv: pvectval)
+  pvectval.each([&](Rps_Value compv)
+  {
     if (rps_is_dumpable_value(du, compv))
       jarr.append(rps_dump_json_value(du,compv));
     else
       jarr.append(Json::Value(Json::nullValue));
+  });
   jv["vectval"] = jarr;
 } // end Rps_PayloadVectVal::dump_json_content
 
@@ -2039,7 +3020,7 @@ Rps_PayloadVectVal::make_closure_zone_from_vector(Rps_ObjectRef connob)
   if (!connob)
     return nullptr;
   std::lock_guard<std::recursive_mutex> gu(*(connob->objmtxptr()));
-  return Rps_ClosureZone::make(connob, pvectval);
+  return Rps_ClosureZone::make(connob, pvectval.to_vector());
 } // end Rps_PayloadVectVal::make_closure_zone_from_vector
 
 
@@ -2051,9 +3032,63 @@ Rps_PayloadVectVal::make_instance_zone_from_vector(Rps_ObjectRef classob)
   std::lock_guard<std::recursive_mutex> gu(*(classob->objmtxptr()));
   if (!classob->is_class())
     return nullptr;
-  return Rps_InstanceZone::make_from_components(classob, pvectval);
+  return Rps_InstanceZone::make_from_components(classob, pvectval.to_vector());
 } // end Rps_PayloadVectVal::make_instance_zone_from_vector
 
+void
+Rps_PayloadVectVal::append_values(const std::vector<Rps_Value>&vecval)
+{
+  std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+  if (std::none_of(vecval.begin(), vecval.end(),
+                   [](Rps_Value v)
+{
+  return v.is_empty();
+  }))
+  {
+    pvectval.append(vecval);
+    for (Rps_Value v : vecval)
+      note_payload_references(nullptr, v);
+    return;
+  };
+  pvectval.reserve(pvectval.size() + vecval.size());
+  for (Rps_Value v : vecval)
+    push_back(v);
+} // end Rps_PayloadVectVal::append_values
+
+std::vector<Rps_Value>
+Rps_PayloadVectVal::slice(int from, int to) const
+{
+  std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+  rps_vector_slice_bounds(from, to, pvectval.size());
+  return pvectval.to_vector(from, to);
+} // end Rps_PayloadVectVal::slice
+
+std::vector<Rps_Value>
+Rps_PayloadVectVal::parallel_map(const std::function<Rps_Value(Rps_Value)>&fun,
+                                 unsigned nbthreads) const
+{
+  RPS_ASSERT(fun);
+  std::vector<Rps_Value> compvec;
+  {
+    std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+    compvec = pvectval.to_vector();
+  }
+  return rps_vector_parallel_map<Rps_Value>(compvec, fun, nbthreads);
+} // end Rps_PayloadVectVal::parallel_map
+
+std::vector<Rps_Value>
+Rps_PayloadVectVal::parallel_filter(const std::function<bool(Rps_Value)>&pred,
+                                    unsigned nbthreads) const
+{
+  RPS_ASSERT(pred);
+  std::vector<Rps_Value> compvec;
+  {
+    std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+    compvec = pvectval.to_vector();
+  }
+  return rps_vector_parallel_filter<Rps_Value>(compvec, pred, nbthreads);
+} // end Rps_PayloadVectVal::parallel_filter
+
 void
 Rps_PayloadVectVal::output_payload(std::ostream&out,
                                    unsigned depth, unsigned maxdepth)
@@ -2129,6 +3164,7 @@ Rps_PayloadSpace::output_payload(std::ostream&out, unsigned depth, unsigned maxd
 
 std::recursive_mutex Rps_PayloadSymbol::symb_tablemtx;
 std::map<std::string,Rps_PayloadSymbol*> Rps_PayloadSymbol::symb_table;
+Rps_RadixTrie<Rps_PayloadSymbol*> Rps_PayloadSymbol::symb_trie;
 std::unordered_map<std::string,Rps_ObjectRef*> Rps_PayloadSymbol::symb_hardcoded_hashtable;
 
 bool
@@ -2168,7 +3204,10 @@ Rps_PayloadSymbol::~Rps_PayloadSymbol()
                 << std::endl
                 << RPS_FULL_BACKTRACE(1, "~Rps_PayloadSymbol"));
   if (!symb_name.empty())
-    symb_table.erase(symb_name);
+    {
+      symb_table.erase(symb_name);
+      symb_trie.remove(symb_name);
+    }
 } // end Rps_PayloadSymbol::~Rps_PayloadSymbol()
 
 
@@ -2187,6 +3226,7 @@ Rps_PayloadSymbol::load_register_name(const char*name, Rps_Loader*ld, bool weak)
     throw std::runtime_error(std::string("duplicate loaded symbol name:") + name + " for "
                              + owner()->oid().to_string());
   symb_table.insert({symb_name, this});
+  symb_trie.insert(symb_name, this);
   symb_is_weak.store(weak);
   RPS_DEBUG_LOG(LOAD,
                 "Rps_PayloadSymbol::load_register_name symb_name:" << symb_name
@@ -2266,6 +3306,7 @@ Rps_PayloadSymbol::register_name(std::string name, Rps_ObjectRef obj, bool weak)
     obj->put_new_plain_payload<Rps_PayloadSymbol>();
   paylsymb->symb_name = name;
   symb_table.insert({paylsymb->symb_name, paylsymb});
+  symb_trie.insert(paylsymb->symb_name, paylsymb);
   paylsymb->symb_is_weak.store(weak);
   {
     auto symbit = symb_hardcoded_hashtable.find(name);
@@ -2295,6 +3336,7 @@ bool Rps_PayloadSymbol::forget_name(std::string name)
   Rps_ObjectRef obj = sy->owner();
   if (!obj)
     return false;
+  symb_trie.remove(it->first);
   obj->clear_payload();
   symb_table.erase(it);
   {
@@ -2321,6 +3363,7 @@ Rps_PayloadSymbol::forget_object(Rps_ObjectRef obj)
   auto it = symb_table.find(paylsymb->symb_name);
   if (it == symb_table.end())
     return false;
+  symb_trie.remove(it->first);
   obj->clear_payload();
   symb_table.erase(it);
   return true;
@@ -2331,23 +3374,15 @@ Rps_PayloadSymbol::autocomplete_name(const char*prefix, const std::function<bool
 {
   if (!valid_name(prefix))
     return 0;
-  int count = 0;
-  std::string prefixstr(prefix);
-  int prefixlen = strlen(prefix);
   std::lock_guard<std::recursive_mutex> gusy(symb_tablemtx);
-  for (auto it = symb_table.lower_bound(prefixstr); it != symb_table.end(); it++)
-    {
-      if (!it->second)
-        continue;
-      std::string curname = it->first;
-      if (strncmp(prefix,curname.c_str(),prefixlen))
-        break;
-      count++;
-      Rps_ObjectRef curobr = it->second->owner();
-      if (stopfun(curobr,curname))
-        break;
-    }
-  return count;
+  return symb_trie.each_with_prefix(prefix,
+                                    [&](const std::string&curname, Rps_PayloadSymbol*const&paylsymb)
+  {
+    if (!paylsymb)
+      return false;
+    Rps_ObjectRef curobr = paylsymb->owner();
+    return stopfun(curobr,curname);
+  });
 } // end Rps_PayloadSymbol::autocomplete_name
 
 const Rps_SetValue
@@ -2412,6 +3447,16 @@ Rps_ObjectRef::find_object_by_string(Rps_CallFrame*callerframe, const std::strin
       _f.obsymb = Rps_PayloadSymbol::find_named_object(str);
       RPS_DEBUG_LOG(LOWREP, "find_object_by_string for str='"
                     << str << "'  obsymb=" << _f.obsymb);
+      if (!_f.obsymb
+          && Rps_ObjectZone::has_attribute_index(RPS_ROOT_OB(_1EBVGSfW2m200z18rx))) //name∈named_attribute
+        {
+          /// an object with that unique name
+          std::vector<Rps_ObjectRef> vecnamed =
+            Rps_ObjectZone::objects_with_attribute(RPS_ROOT_OB(_1EBVGSfW2m200z18rx),
+                Rps_StringValue(str));
+          if (vecnamed.size() == 1)
+            return vecnamed[0];
+        };
       if (!_f.obsymb)
         {
           RPS_DEBUG_LOG(LOWREP, "find_object_by_string for str='"
@@ -2549,7 +3594,7 @@ Rps_ObjectRef::make_named_class(Rps_CallFrame*callerframe, Rps_ObjectRef supercl
   RPS_INFORMOUT("Rps_ObjectRef::make_named_class name=" << name << ", paylsymbol=" << paylsymbol
                 << ", obclass=" << _f.obclass);
   /// the class is class `class`
-  _f.obclass->ob_class.store(RPS_ROOT_OB(_41OFI3r0S1t03qdB2E));
+  _f.obclass->change_class(RPS_ROOT_OB(_41OFI3r0S1t03qdB2E));
   auto paylclainf = _f.obclass->put_new_plain_payload<Rps_PayloadClassInfo>();
   paylclainf->put_superclass(_f.obsuperclass);
   paylclainf->put_symbname(_f.obsymbol);
@@ -2588,7 +3633,7 @@ Rps_ObjectRef::make_new_symbol(Rps_CallFrame*callerframe, std::string name, bool
       throw std::runtime_error(std::string("make_new_symbol with existing name"));
     }
   _f.obsymbol = Rps_ObjectZone::make();
-  _f.obsymbol->ob_class.store(RPS_ROOT_OB(_36I1BY2NetN03WjrOv)); // the `symbol` class
+  _f.obsymbol->change_class(RPS_ROOT_OB(_36I1BY2NetN03WjrOv)); // the `symbol` class
   Rps_PayloadSymbol::register_name(name, _f.obsymbol, isweak);
   RPS_NOPRINTOUT("Rps_ObjectRef::make_new_symbol name=" << name
                  << " gives obsymbol=" << _f.obsymbol);
@@ -2623,7 +3668,7 @@ Rps_ObjectRef::make_object(Rps_CallFrame*callerframe, Rps_ObjectRef classobarg,
         }
     };
   _f.resultob = Rps_ObjectZone::make();
-  _f.resultob->ob_class.store(_f.classob);
+  _f.resultob->change_class(_f.classob);
   RPS_DEBUG_LOG(LOWREP, "make_object classob=" << _f.classob << " -> resultob=" << _f.resultob);
   _f.resultob->put_space(_f.spaceob);
   /// FIXME: perhaps we should send some `initialize_object` message?
@@ -2805,6 +3850,7 @@ rps_delete_payload(Rps_Payload*payl)
     {
       std::lock_guard<std::recursive_mutex> guown(*ownob->objmtxptr());
       RPS_POSSIBLE_BREAKPOINT();
+      ownob->forget_payload_references(payl);
       payl->payl_owner = nullptr;
       if (ownob->get_payload() == payl)
         ownob->ob_payload.store(nullptr);
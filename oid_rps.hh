@@ -63,6 +63,21 @@ public:
   static constexpr unsigned nbdigits_lo = 7;
   static constexpr unsigned nbchars = nbdigits_hi + nbdigits_lo + 1;
   static constexpr unsigned maxbuckets = 10*62;
+  /// the rank of a b62 digit, so that oid strings, which have a fixed
+  /// width, sort like oids; other characters come after digits
+  struct b62_char_rank
+  {
+    unsigned operator() (char c) const
+    {
+      if (c >= '0' && c <= '9')
+        return c - '0';
+      if (c >= 'a' && c <= 'z')
+        return 10 + (c - 'a');
+      if (c >= 'A' && c <= 'Z')
+        return 36 + (c - 'A');
+      return base + (unsigned char)c;
+    };
+  };
   static Rps_HashInt hash(uint64_t hi, uint64_t lo)
   {
     return (hi % 2147473837) + ((hi >> 32) ^ (lo * 17 + 201151));
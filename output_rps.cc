@@ -62,6 +62,11 @@ Rps_OutputValue::do_output(std::ostream& out) const
     {
       out << _out_val.as_int();
       return;
+    }
+  else if (_out_val.is_immediate_double() || _out_val.is_immediate_string())
+    {
+      _out_val.output(out, _out_depth, _out_maxdepth);
+      return;
     };
   const Rps_ZoneValue* outzv = _out_val.as_ptr();
   RPS_ASSERT(outzv);
@@ -284,6 +289,22 @@ Rps_Object_Display::output_display(std::ostream&out) const
           << NORM_esc << std::endl;
       payl->output_payload(out, _dispdepth, disp_max_depth);
     };
+  //// °°°°°°°°°°° display referrers, when they are indexed
+  if (Rps_ObjectZone::has_referrers_index())
+    {
+      std::vector<Rps_ObjectRef> refvect
+        = Rps_ObjectZone::referrers(_dispobref);
+      if (refvect.empty())
+        out << BOLD_esc << "* no referrers *" << NORM_esc << std::endl;
+      else
+        {
+          rps_sort_object_vector_for_display(refvect);
+          out << BOLD_esc << "* " << refvect.size() << " referrers *"
+              << NORM_esc << std::endl;
+          for (Rps_ObjectRef obref : refvect)
+            out << " " << BOLD_esc << "<-" << NORM_esc << obref << std::endl;
+        }
+    };
   char oidpref[16];
   memset (oidpref, 0, sizeof(oidpref));
   memcpy (oidpref, obidbuf, sizeof(oidpref)/2);
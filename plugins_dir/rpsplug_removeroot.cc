@@ -53,6 +53,21 @@ rps_do_plugin(const Rps_Plugin* plugin)
                 << RPS_OBJECT_DISPLAY(_f.obroot)
                 << std::endl << "❇ symbol:" /*U+2747 SPARKLE */
                 << RPS_OBJECT_DISPLAY(_f.obsymb));
+  /// impact analysis: list the objects still referring to the root
+  {
+    std::vector<Rps_ObjectRef> refvect = Rps_ObjectZone::referrers(_f.obroot);
+    if (refvect.empty())
+      RPS_INFORMOUT("no object refers to tentative root " << _f.obroot);
+    else
+      {
+        rps_sort_object_vector_for_display(refvect);
+        std::ostringstream outs;
+        for (Rps_ObjectRef obref : refvect)
+          outs << ' ' << obref;
+        RPS_WARNOUT("removing root " << _f.obroot << " still referred by "
+                    << refvect.size() << " objects:" << outs.str());
+      }
+  }
   Rps_PayloadSymbol* paylsymb = nullptr;
   if (_f.obsymb)
     {
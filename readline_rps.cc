@@ -98,26 +98,58 @@ rps_readline_initialize(void)
 #warning incomplete rps_readline_initialize
 } // end rps_readline_initialize
 
+/// the maximal number of completions offered on one TAB
+static constexpr unsigned rps_readline_max_completions = 64;
+
+/// readline calls this generator with STATE 0 for the first match,
+/// then with increasing STATE; we compute the first matches of the
+/// oid or symbol tries once and return them one by one
 static char *
-readline_completion_rps (const char *str, int key)
+readline_completion_rps (const char *str, int state)
 {
-  RPS_UNIQUE_BREAKPOINT();
-  RPS_FATALOUT("unimplemented readline competion str="
-               << Rps_QuotedC_String(str)
-               << " rl.buf=" << Rps_QuotedC_String(rl_line_buffer)
-               << " key=" << (int)key << ":" << (char)key);
-#warning unimplemented readline_completion_rps
+  static std::vector<std::string> complvec;
+  static unsigned complix;
+  RPS_ASSERT(str != nullptr);
+  if (state == 0)
+    {
+      complvec.clear();
+      complix = 0;
+      if (str[0] == '_' && isdigit(str[1]))
+        Rps_ObjectZone::autocomplete_oid(str, [&](const Rps_ObjectZone*obz)
+        {
+          RPS_ASSERT(obz != nullptr);
+          complvec.push_back(obz->oid().to_string());
+          return complvec.size() >= rps_readline_max_completions;
+        });
+      else if (isalpha(str[0]))
+        Rps_PayloadSymbol::autocomplete_name(str, [&](const Rps_ObjectZone*,
+                                             const std::string&name)
+        {
+          complvec.push_back(name);
+          return complvec.size() >= rps_readline_max_completions;
+        });
+      RPS_DEBUG_LOG(COMPL, "readline_completion_rps str="
+                    << Rps_QuotedC_String(str)
+                    << " gave " << complvec.size() << " completions");
+    };
+  if (complix >= complvec.size())
+    return nullptr;
+  return strdup(complvec[complix++].c_str());
 } // end readline_completion_rps
 
 static char **
 readline_attempted_completion_rps (const char *text, int start, int end)
 {
-  RPS_UNIQUE_BREAKPOINT();
-  RPS_FATALOUT("unimplemented readline attempted completion text="
-               << Rps_QuotedC_String(text)
-               << " rl.buf=" << Rps_QuotedC_String(rl_line_buffer)
-               << " start=" << start
-               << " end=" << end);
+  RPS_DEBUG_LOG(COMPL, "readline attempted completion text="
+                << Rps_QuotedC_String(text)
+                << " rl.buf=" << Rps_QuotedC_String(rl_line_buffer)
+                << " start=" << start
+                << " end=" << end);
+  /// never fallback to file name completion
+  rl_attempted_completion_over = 1;
+  if (!text || !text[0])
+    return nullptr;
+  return rl_completion_matches(text, readline_completion_rps);
 } // end readline_attempted_completion_rps
 
 int
@@ -133,9 +165,9 @@ rps_readline_tab(int cnt, int key)
     rl_delete_text(rl_point, strlen("\euro"));
     rl_insert_text("€");
     rl_forced_update_display();
+    return 0;
   }
-#warning incomplete rps_readline_tab
-  return 0;
+  return rl_complete(cnt, key);
 } // end rps_readline_tab
 
 int
@@ -70,6 +70,8 @@
 #include <set>
 #include <map>
 #include <deque>
+#include <list>
+#include <string_view>
 #include <variant>
 #include <unordered_map>
 #include <unordered_set>
@@ -106,6 +108,7 @@
 #include <argp.h>
 #include <ctype.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
 #include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -238,6 +241,7 @@ class Rps_ObjectZone; // memory for objects
 class Rps_JsonZone; // memory for Json values
 class Rps_LexTokenZone; /// memory for reified lexical tokens,
 //… mostly in repl_rps.cc
+class Rps_HamtZone; /// persistent immutable maps, in hamt_rps.cc
 
 class Rps_DequVal;
 class Rps_GarbageCollector;
@@ -283,6 +287,13 @@ extern "C" std::string rps_test_repl_string;
 extern "C" std::string rps_file_repl_string;
 extern "C" std::string rps_publisher_url_str;
 extern "C" bool rps_without_quick_tests;
+extern "C" bool rps_build_referrers_index; /// --referrers-index option
+extern "C" bool rps_lazy_load; /// --lazy-load option
+extern "C" const char* rps_load_profile; /// --load-profile=FILE option
+extern "C" bool rps_check_heap_after_load; /// --check-heap option
+extern "C" bool rps_check_heap_before_dump; /// --check-heap=dump option
+extern "C" bool rps_check_pull_parser; /// --check-pull-parser option
+extern "C" const char* rps_startup_profile; /// --startup-profile option
 
 /// Given some SHORTPATH like "foo123.xyz" return a temporary unique
 /// full path in the dump directory which would be renamed at end of
@@ -759,6 +770,14 @@ extern "C" const char*rps_get_plugin_cstr_argument(const Rps_Plugin*plugin);
 
 extern "C" std::vector<Rps_Plugin> rps_plugins_vector;
 
+/// The --plugin-after-load plugins are only named while parsing the
+/// program arguments; they are dlopen-ed in a thread started by
+/// rps_start_plugins_loading just before the load, which overlaps
+/// it. The load waits for them only when a symbol is not found in
+/// the program, and main waits for them after the load.
+extern "C" void rps_start_plugins_loading(void);
+extern "C" void rps_wait_plugins_loading(void);
+
 ////////////////////////////////////////////////////////////////
 
 struct Rps_Status
@@ -871,6 +890,15 @@ enum rps_progoption_en
   RPSPROGOPT_SCRIPT,
   RPSPROGOPT_DEBUG_EXIT,
   RPSPROGOPT_PUBLISH_ME,
+  RPSPROGOPT_INTERN_VALUES,
+  RPSPROGOPT_REFERRERS_INDEX,
+  RPSPROGOPT_BINARY_STORE,
+  RPSPROGOPT_CONVERT_STORE,
+  RPSPROGOPT_LAZY_LOAD,
+  RPSPROGOPT_LOAD_PROFILE,
+  RPSPROGOPT_CHECK_HEAP,
+  RPSPROGOPT_CHECK_PULL_PARSER,
+  RPSPROGOPT_STARTUP_PROFILE,
 };
 
 extern "C" std::string rps_user_preferences_path(void);
@@ -1208,6 +1236,19 @@ static inline double rps_thread_cpu_time(void);
 char *rps_strftime_centiseconds(char *bfr, size_t len, const char *fmt,
                                 double m);
 
+/// The startup timeline, shown with --startup-profile. Each call to
+/// rps_startup_phase ends the startup phase of the main thread named
+/// NAME, which began at the previous call (or at process start for
+/// the first one). Phases running concurrently in another thread are
+/// recorded with rps_startup_background_phase, given their monotonic
+/// start time and the CPU time of their thread.
+extern "C" void rps_startup_phase(const char*name);
+extern "C" void rps_startup_background_phase(const char*name, double startmonotime,
+    double threadcputime);
+/// write the startup timeline into PATH, as JSON if it ends with
+/// .json, or on stdout for "-"
+extern "C" void rps_show_startup_profile(const char*path);
+
 #define rps_now_strftime_centiseconds(Bfr, Len, Fmt) \
   rps_strftime_centiseconds((Bfr), (Len), (Fmt), rps_wallclock_real_time())
 
@@ -1734,7 +1775,8 @@ enum class Rps_Type : std::int16_t
   CallFrame = std::numeric_limits<std::int16_t>::min(),
   ////////////////
   /// payloads are negative, below -1
-  _FirstPayloadType= -25,
+  _FirstPayloadType= -26,
+  PaylValMap = -26,       // for mutable hash maps keyed by any value
   PaylCurlReq = -25,
   PaylLightCodeGen = -24,
   PaylMachlearn = -23,
@@ -1784,7 +1826,10 @@ enum class Rps_Type : std::int16_t
   Instance,
   Json,
   LexToken,
-  _LastValueType= (int)LexToken
+  Hamt,
+  DoubleVect,
+  IntVect,
+  _LastValueType= (int)IntVect
 };
 
 extern "C" // gives nullptr when bad type number
@@ -1811,6 +1856,7 @@ class Rps_InstanceValue;
 class Rps_TupleValue;
 class Rps_LexTokenValue; // mostly in repl_rps.cc
 class Rps_OutputValue;
+template<typename NumT, Rps_Type vecty> class Rps_NumVectZone; // in numvect_rps.cc
 struct Rps_TwoValues;
 
 //////////////// our value, a single word
@@ -1866,9 +1912,33 @@ public:
   inline bool operator != (const Rps_Value v) const;
   inline bool operator >= (const Rps_Value v) const;
   inline bool operator > (const Rps_Value v) const;
+  /// a total order, unlike operator < which leaves e.g. integers and
+  /// pointers unordered: by kind (empty, integer, double, string,
+  /// then zones by type), then by value, with objects by oid and
+  /// other zones by hash then by their less; negative, zero or
+  /// positive like strcmp. Used for sorted iterations and dumps.
+  static inline int compare_total(const Rps_Value v1, const Rps_Value v2);
+  struct total_less
+  {
+    bool operator() (const Rps_Value v1, const Rps_Value v2) const
+    {
+      return compare_total(v1, v2) < 0;
+    };
+  };
+  /// equality for hashed containers keyed by values, where a NaN
+  /// double equals itself, unlike operator ==
+  struct total_equal
+  {
+    bool operator() (const Rps_Value v1, const Rps_Value v2) const
+    {
+      return compare_total(v1, v2) == 0;
+    };
+  };
   inline Rps_Type type() const;
   inline bool is_int() const;
   inline bool is_ptr() const;
+  inline bool is_immediate_double() const;
+  inline bool is_immediate_string() const;
   inline bool is_object() const;
   inline bool is_instance() const;
   inline bool is_set() const;
@@ -1880,6 +1950,9 @@ public:
   inline bool is_empty() const;
   inline bool is_json() const;
   inline bool is_lextoken() const;
+  inline bool is_hamt() const;
+  inline bool is_doublevect() const;
+  inline bool is_intvect() const;
   operator bool () const
   {
     return !is_empty();
@@ -1900,6 +1973,9 @@ public:
   inline const Rps_Double* as_boxed_double() const;
   inline const Rps_JsonZone* as_json() const;
   inline const Rps_LexTokenZone* as_lextoken() const;
+  inline const Rps_HamtZone* as_hamt() const;
+  inline const Rps_NumVectZone<double,Rps_Type::DoubleVect>* as_doublevect() const;
+  inline const Rps_NumVectZone<std::int64_t,Rps_Type::IntVect>* as_intvect() const;
   inline double as_double() const;
   inline const std::string as_cppstring() const;
   inline const char* as_cstring() const;
@@ -1921,6 +1997,9 @@ public:
   inline const Rps_String* to_string( const Rps_String*defstr
                                       = nullptr) const;
   inline const Rps_LexTokenZone* to_lextoken(void) const;
+  inline const Rps_HamtZone* to_hamt(const Rps_HamtZone*defhamt= nullptr) const;
+  inline const Rps_NumVectZone<double,Rps_Type::DoubleVect>* to_doublevect(void) const;
+  inline const Rps_NumVectZone<std::int64_t,Rps_Type::IntVect>* to_intvect(void) const;
   inline const std::string to_cppstring(std::string defstr= "") const;
   inline Rps_HashInt valhash() const noexcept;
   static constexpr unsigned max_output_depth = 5;
@@ -1979,6 +2058,29 @@ public:
   {
     return _wptr;
   };
+  /* Most doubles are immediate, not boxed in a Rps_Double zone.
+     Their word has the low tag bits 0b010 (never set for aligned
+     pointers, and bit 0 is for tagged integers); the sign bit is
+     rotated down and the exponent rebased so that finite doubles
+     whose magnitude is between about 1e-38 and 1e38 (and zeros) fit
+     losslessly in the remaining 61 bits.  Other doubles stay boxed. */
+  static constexpr intptr_t immediate_tag_mask = 7;
+  static constexpr intptr_t immediate_double_tag = 2;
+  static inline bool encode_immediate_double(double d, intptr_t&enc);
+  static inline double decode_immediate_double(intptr_t enc);
+  /* Short strings, of at most 7 bytes of valid UTF-8 without any NUL,
+     are also immediate.  Their low tag bits are 0b100, bits 3 to 5
+     give the byte length, and the bytes sit in the seven upper bytes
+     of the word.  They are never interned, and Rps_String::make still
+     gives boxed strings. */
+  static constexpr intptr_t immediate_string_tag = 4;
+  static constexpr unsigned immediate_string_maxlen = 7;
+  static inline bool encode_immediate_string(const char*cstr, int len, intptr_t&enc);
+  /// make a string value, immediate when short enough
+  static inline Rps_Value make_string(const char*cstr, int len= -1);
+  /// for a string value, give its NUL terminated bytes, decoding an
+  /// immediate string into BUF; otherwise return nullptr
+  inline const char* string_cstr(char buf[immediate_string_maxlen+1]) const;
 private:
   union
   {
@@ -2616,7 +2718,20 @@ protected:
   inline void* operator new (std::size_t siz, std::nullptr_t);
   inline void* operator new (std::size_t siz, unsigned wordgap);
   static constexpr uint16_t qz_gcmark_bit = 1;
+  static constexpr uint16_t qz_interned_bit = 2; // see Rps_InternTable
+  friend class Rps_InternTable;
+  void set_interned(bool on) const
+  {
+    if (on)
+      qz_gcinfo.fetch_or(qz_interned_bit);
+    else
+      qz_gcinfo.fetch_and(~qz_interned_bit);
+  };
 public:
+  bool is_interned(void) const
+  {
+    return qz_gcinfo.load() & qz_interned_bit;
+  };
   /// gives the number of machine words (8 bytes) allocated since
   /// start of process...
   static uint64_t cumulative_allocated_wordcount()
@@ -2704,6 +2819,9 @@ public:
   };
   void register_in_zonevec(void);
   void unregister_in_zonevec(void);
+  /// the addresses of every live zone, sorted, to check a pointer
+  /// without dereferencing it
+  static std::vector<const Rps_QuasiZone*> sorted_live_zones(void);
 protected:
   inline Rps_QuasiZone(Rps_Type typ);
   virtual ~Rps_QuasiZone();
@@ -2792,6 +2910,48 @@ public:
 };                              // end of Rps_LazyHashedZoneValue
 
 
+/////////////////////////////////////////////////// weak intern table
+/* When enabled (by the --intern-values program option), the makers
+   of immutable lazily hashed values (Rps_String::make,
+   Rps_SetOb::make, Rps_TupleOb::make) return an already existing
+   equal value, so structurally equal copies are shared. Instances
+   and closures are never interned: their metadata can be changed,
+   e.g. by put_persistent_metadata, so equal ones stay distinct.
+   The table is weak: the garbage collector removes entries whose
+   value is not marked, just before deleting them. Two distinct
+   interned values are never equal. Code in values_rps.cc */
+class Rps_InternTable
+{
+  static std::mutex intern_mtx;
+  static std::unordered_multimap<Rps_HashInt,const Rps_LazyHashedZoneValue*> intern_map;
+  static std::atomic<bool> intern_enabled;
+  static std::atomic<uint64_t> intern_hits;
+public:
+  static bool enabled(void)
+  {
+    return intern_enabled.load();
+  };
+  static void set_enabled(bool on);
+  /// return an existing value equal to ZV, or register and return ZV
+  static const Rps_LazyHashedZoneValue*intern(const Rps_LazyHashedZoneValue*zv);
+  template <typename ZoneClass> static const ZoneClass*
+  intern_value(const ZoneClass*zv)
+  {
+    if (!zv || !enabled())
+      return zv;
+    return static_cast<const ZoneClass*>(intern(zv));
+  };
+  /// find an already interned string of LEN bytes, without allocating
+  static const Rps_String*find_string(const char*cstr, int len);
+  static void gc_remove_unmarked(Rps_GarbageCollector&gc);
+  static size_t size(void);
+  static uint64_t nb_hits(void)
+  {
+    return intern_hits.load();
+  };
+};                              // end of Rps_InternTable
+
+
 
 
 ////////////////////////////////////////////////// file path utilities
@@ -2812,6 +2972,10 @@ std::string rps_glob_plain_file_path(const char*shellpat, const char*dirpath);
 extern "C"
 int rps_compute_cstr_two_64bits_hash(int64_t ht[2], const char*cstr, int len= -1);
 
+// faster equivalent of u8_check: return nullptr if the LEN bytes of S
+// are valid UTF-8, otherwise the first invalid position
+extern "C" const char*rps_utf8_check(const char*s, size_t len);
+
 static inline Rps_HashInt rps_hash_cstr(const char*cstr, int len= -1);
 
 class Rps_String : public Rps_LazyHashedZoneValue
@@ -2852,6 +3016,8 @@ public:
   virtual void val_output(std::ostream& outs, unsigned depth, unsigned maxdepth) const;
   virtual void dump_scan(Rps_Dumper*, unsigned) const {};
   virtual Json::Value dump_json(Rps_Dumper*) const;
+  /// the JSON dump of a string, also used for immediate strings
+  static Json::Value dump_json_cstr(const char*cstr);
   static const Rps_String* make(const char*cstr, int len= -1);
   static inline const Rps_String* make(const std::string&s);
   const char*cstr() const
@@ -2895,11 +3061,7 @@ protected:
 protected:
   virtual Rps_HashInt compute_hash(void) const
   {
-    auto rh = std::hash<double> {}((double)_dval);
-    Rps_HashInt h = static_cast<Rps_HashInt> (rh);
-    if (RPS_UNLIKELY(h == 0))
-      h = 987383;
-    return h;
+    return hash_double(_dval);
   };
   virtual Rps_ObjectRef compute_class(Rps_CallFrame*stkf) const;
   virtual void gc_mark(Rps_GarbageCollector&, unsigned) const { };
@@ -2909,6 +3071,16 @@ protected:
     return Json::Value(_dval);
   };
 public:
+  /// also used for immediate doubles in Rps_Value
+  static Rps_HashInt hash_double(double d)
+  {
+    auto rh = std::hash<double> {}(d);
+    Rps_HashInt h = static_cast<Rps_HashInt> (rh);
+    if (RPS_UNLIKELY(h == 0))
+      h = 987383;
+    return h;
+  };
+  static void output_double(std::ostream& outs, double d);
   virtual void val_output(std::ostream& outs, unsigned depth, unsigned maxdepth) const;
   double dval() const
   {
@@ -3681,8 +3853,267 @@ typedef Rps_TwoValues rps_applyingfun_t (Rps_CallFrame*callerframe,
 #define RPS_APPLYINGFUN_PREFIX "rpsapply"
 // by convention, the extern "C" applying function inside the fictuous connective _45vHaB3kVHiDzT42h0
 // would be named rpsapply_45vHaB3kVHiDzT42h0
+////////////////////////////////////////////////////////////////
+////// compact radix tries, mapping strings to small values, used for
+////// autocompletion of oids and of symbol names. Every node keeps
+////// the number of keys below it, so a prefix is counted in time
+////// proportional to its length, and enumerating the first matches
+////// in key order is proportional to the prefix and to their
+////// number. Keys are ordered character by character on CharRank,
+////// by default on bytes. Callers are responsible for locking.
+struct Rps_RadixTrie_ByteRank
+{
+  unsigned operator() (char c) const
+  {
+    return (unsigned char)c;
+  };
+};
+template <typename T, typename CharRank = Rps_RadixTrie_ByteRank> class Rps_RadixTrie
+{
+  struct trie_node
+  {
+    std::string tn_label;     // the edge label from the parent
+    std::vector<std::unique_ptr<trie_node>> tn_sons; // sorted by rank of first char
+    size_t tn_count;          // number of keys in this subtree
+    T tn_val;
+    bool tn_hasval;
+    trie_node() : tn_label(), tn_sons(), tn_count(0), tn_val(), tn_hasval(false) {};
+  };
+  trie_node rtrie_root;
+  /// the rank of the son whose label starts with C, or of its insertion point
+  static size_t son_rank(const trie_node*nd, char c)
+  {
+    CharRank chrank;
+    unsigned crk = chrank(c);
+    size_t lo = 0, hi = nd->tn_sons.size();
+    while (lo < hi)
+      {
+        size_t md = (lo + hi) / 2;
+        if (chrank(nd->tn_sons[md]->tn_label[0]) < crk)
+          lo = md+1;
+        else
+          hi = md;
+      }
+    return lo;
+  };
+  static trie_node* son_at(const trie_node*nd, char c)
+  {
+    size_t rk = son_rank(nd, c);
+    if (rk < nd->tn_sons.size() && nd->tn_sons[rk]->tn_label[0] == c)
+      return nd->tn_sons[rk].get();
+    return nullptr;
+  };
+  /// merge a valueless node with its only son
+  static void merge_single_son(trie_node*nd)
+  {
+    if (nd->tn_hasval || nd->tn_sons.size() != 1)
+      return;
+    std::unique_ptr<trie_node> son = std::move(nd->tn_sons[0]);
+    nd->tn_label += son->tn_label;
+    nd->tn_sons = std::move(son->tn_sons);
+    nd->tn_val = son->tn_val;
+    nd->tn_hasval = son->tn_hasval;
+  };
+  /// find the node covering PREFIX; its full key is put in STEM
+  const trie_node* locate(const std::string&prefix, std::string&stem) const
+  {
+    const trie_node*nd = &rtrie_root;
+    size_t pos = 0;
+    stem.clear();
+    while (pos < prefix.size())
+      {
+        const trie_node*son = son_at(nd, prefix[pos]);
+        if (!son)
+          return nullptr;
+        const std::string& lab = son->tn_label;
+        size_t l = 0;
+        while (l < lab.size() && pos+l < prefix.size() && lab[l] == prefix[pos+l])
+          l++;
+        if (l < lab.size() && pos+l < prefix.size())
+          return nullptr;
+        stem += lab;
+        pos += l;
+        nd = son;
+      }
+    return nd;
+  };
+  /// depth first walk in key order, till F returns true
+  static bool walk(const trie_node*nd, std::string&key, int&count,
+                   const std::function<bool(const std::string&,const T&)>&f)
+  {
+    size_t oldlen = key.size();
+    key += nd->tn_label;
+    if (nd->tn_hasval)
+      {
+        count++;
+        if (f(key, nd->tn_val))
+          return true;
+      }
+    for (auto& son : nd->tn_sons)
+      if (walk(son.get(), key, count, f))
+        return true;
+    key.resize(oldlen);
+    return false;
+  };
+public:
+  Rps_RadixTrie() : rtrie_root() {};
+  Rps_RadixTrie(const Rps_RadixTrie&) = delete;
+  Rps_RadixTrie& operator = (const Rps_RadixTrie&) = delete;
+  size_t size(void) const
+  {
+    return rtrie_root.tn_count;
+  };
+  bool empty(void) const
+  {
+    return rtrie_root.tn_count == 0;
+  };
+  void clear(void)
+  {
+    rtrie_root.tn_sons.clear();
+    rtrie_root.tn_count = 0;
+    rtrie_root.tn_val = T();
+    rtrie_root.tn_hasval = false;
+  };
+  const T* find(const std::string&key) const
+  {
+    std::string stem;
+    const trie_node*nd = locate(key, stem);
+    if (!nd || !nd->tn_hasval || stem.size() != key.size())
+      return nullptr;
+    return &nd->tn_val;
+  };
+  /// insert or replace the value of KEY; return true if it was a new key
+  bool insert(const std::string&key, const T&val)
+  {
+    std::vector<trie_node*> path;
+    trie_node*nd = &rtrie_root;
+    size_t pos = 0;
+    while (pos < key.size())
+      {
+        size_t rk = son_rank(nd, key[pos]);
+        if (rk == nd->tn_sons.size() || nd->tn_sons[rk]->tn_label[0] != key[pos])
+          {
+            std::unique_ptr<trie_node> leaf(new trie_node);
+            leaf->tn_label = key.substr(pos);
+            nd->tn_sons.insert(nd->tn_sons.begin()+rk, std::move(leaf));
+            path.push_back(nd);
+            nd = nd->tn_sons[rk].get();
+            pos = key.size();
+            break;
+          }
+        trie_node*son = nd->tn_sons[rk].get();
+        const std::string& lab = son->tn_label;
+        size_t l = 0;
+        while (l < lab.size() && pos+l < key.size() && lab[l] == key[pos+l])
+          l++;
+        if (l < lab.size())
+          {
+            /// split the edge at the end of the common part
+            std::unique_ptr<trie_node> mid(new trie_node);
+            mid->tn_label = lab.substr(0, l);
+            mid->tn_count = son->tn_count;
+            son->tn_label.erase(0, l);
+            mid->tn_sons.push_back(std::move(nd->tn_sons[rk]));
+            nd->tn_sons[rk] = std::move(mid);
+            son = nd->tn_sons[rk].get();
+          }
+        path.push_back(nd);
+        nd = son;
+        pos += l;
+      }
+    if (nd->tn_hasval)
+      {
+        nd->tn_val = val;
+        return false;
+      }
+    nd->tn_val = val;
+    nd->tn_hasval = true;
+    nd->tn_count++;
+    for (trie_node*anc : path)
+      anc->tn_count++;
+    return true;
+  };
+  /// remove KEY, keeping the trie compact; return true if it was there
+  bool remove(const std::string&key)
+  {
+    std::vector<trie_node*> path;
+    trie_node*nd = &rtrie_root;
+    size_t pos = 0;
+    while (pos < key.size())
+      {
+        trie_node*son = son_at(nd, key[pos]);
+        if (!son || key.compare(pos, son->tn_label.size(), son->tn_label) != 0)
+          return false;
+        path.push_back(nd);
+        pos += son->tn_label.size();
+        nd = son;
+      }
+    if (!nd->tn_hasval)
+      return false;
+    nd->tn_hasval = false;
+    nd->tn_val = T();
+    nd->tn_count--;
+    for (trie_node*anc : path)
+      anc->tn_count--;
+    if (path.empty())
+      return true;
+    trie_node*parent = path.back();
+    if (nd->tn_count == 0)
+      {
+        size_t rk = son_rank(parent, nd->tn_label[0]);
+        parent->tn_sons.erase(parent->tn_sons.begin()+rk);
+        if (parent != &rtrie_root)
+          merge_single_son(parent);
+      }
+    else
+      merge_single_son(nd);
+    return true;
+  };
+  /// the number of keys starting with PREFIX
+  size_t count_prefix(const std::string&prefix) const
+  {
+    std::string stem;
+    const trie_node*nd = locate(prefix, stem);
+    return nd?nd->tn_count:0;
+  };
+  /// call F in key order on keys starting with PREFIX, till
+  /// it returns true; give the number of calls
+  int each_with_prefix(const std::string&prefix,
+                       const std::function<bool(const std::string&,const T&)>&f) const
+  {
+    std::string stem;
+    const trie_node*nd = locate(prefix, stem);
+    int count = 0;
+    if (!nd)
+      return 0;
+    std::string key = stem.substr(0, stem.size() - nd->tn_label.size());
+    walk(nd, key, count, f);
+    return count;
+  };
+  /// the first MAXNB keys, in key order, starting with PREFIX
+  std::vector<std::pair<std::string,T>> first_with_prefix(const std::string&prefix,
+                                     size_t maxnb) const
+  {
+    std::vector<std::pair<std::string,T>> res;
+    if (maxnb == 0)
+      return res;
+    res.reserve(std::min(maxnb, count_prefix(prefix)));
+    each_with_prefix(prefix, [&](const std::string&key, const T&val)
+    {
+      res.push_back({key, val});
+      return res.size() >= maxnb;
+    });
+    return res;
+  };
+};                              // end class Rps_RadixTrie
+
+
 class Rps_Payload;
 extern "C" void rps_delete_payload(Rps_Payload*); // in object_rps.cc
+/// apply F to the objects inside the value V, going thru sequences,
+/// trees and hash tries; in objects_rps.cc
+extern void rps_each_object_in_value(Rps_Value v, const std::function<void(Rps_ObjectZone*)>&f,
+                                     unsigned depth=0);
 
 class Rps_ObjectZone : public Rps_ZoneValue
 {
@@ -3714,21 +4145,84 @@ private:
   std::atomic<Rps_Payload*> ob_payload;
   std::atomic<rps_magicgetterfun_t*> ob_magicgetterfun;
   std::atomic<rps_applyingfun_t*> ob_applyingfun;
+  /// with --lazy-load, most loaded objects get their attributes,
+  /// components, payload and functions on first use, see load_rps.cc
+  enum lazystate_en : uint8_t
+  {
+    OBLAZY_NONE,
+    OBLAZY_PENDING,
+    OBLAZY_LOADING,
+  };
+  mutable std::atomic<uint8_t> ob_lazystate;
+  void materialize_lazy(void) const; // in load_rps.cc
   /// constructors
   Rps_ObjectZone(Rps_Id oid, registermode_en regmod);
   Rps_ObjectZone(void);
   ~Rps_ObjectZone();
   static std::unordered_map<Rps_Id,Rps_ObjectZone*,Rps_Id::Hasher> ob_idmap_;
-  static std::map<Rps_Id,Rps_ObjectZone*> ob_idbucketmap_[Rps_Id::maxbuckets];
+  /// the radix trie of all oid strings, in oid order, for autocompletion
+  static Rps_RadixTrie<Rps_ObjectZone*,Rps_Id::b62_char_rank> ob_idtrie_;
   static std::recursive_mutex ob_idmtx_;
   static void register_objzone(Rps_ObjectZone*);
   static Rps_Id fresh_random_oid(Rps_ObjectZone*ob =nullptr);
+  /// the class extent index, giving the direct instances of every
+  /// class; it is updated by change_class and does not keep objects
+  /// alive, since destroyed objects are removed from it.
+  static std::unordered_map<Rps_ObjectZone*,std::unordered_set<Rps_ObjectZone*>> ob_extentmap_;
+  static std::recursive_mutex ob_extentmtx_;
+  /// every change of ob_class should go thru this
+  void change_class(Rps_ObjectZone*obzclass);
+  /// the optional secondary indexes on some attributes, mapping every
+  /// value of an indexed attribute to the objects having it. Their
+  /// values are marked by the GC, but not the objects, which are
+  /// removed when destroyed.
+  typedef std::unordered_map<Rps_Value,std::unordered_set<Rps_ObjectZone*>,
+          std::hash<Rps_Value>,Rps_Value::total_equal> attrindex_t;
+  static std::unordered_map<Rps_ObjectZone*,attrindex_t> ob_attrindexmap_;
+  static std::atomic<unsigned> ob_attrindexcount_;
+  static std::recursive_mutex ob_attrindexmtx_;
+  static void attr_index_change(Rps_ObjectZone*obz, Rps_ObjectZone*obzattr,
+                                Rps_Value oldval, Rps_Value newval);
+  /// every change of ob_attrs, with ob_mtx locked, should go thru this;
+  /// an empty VAL removes the attribute
+  void attr_store(Rps_ObjectRef obattr, Rps_Value val);
+  /// the optional referrers index, built by a full scan then updated
+  /// when classes, attributes and components change. ob_refsmap_
+  /// maps every source object to the count of its references to
+  /// each target, ob_referrersmap_ every target to its sources. Both
+  /// are weak; destroyed objects remove themselves.
+  static std::unordered_map<Rps_ObjectZone*,std::unordered_map<Rps_ObjectZone*,unsigned>> ob_refsmap_;
+  static std::unordered_map<Rps_ObjectZone*,std::unordered_set<Rps_ObjectZone*>> ob_referrersmap_;
+  static std::atomic<bool> ob_referrersactive_;
+  /// while build_referrers_index runs, changes are counted except
+  /// for the objects still pending, which are counted when scanned
+  static std::atomic<bool> ob_referrersbuilding_;
+  static std::unordered_set<Rps_ObjectZone*> ob_referrerspending_;
+  static std::recursive_mutex ob_referrersmtx_;
+  /// serialize builds; never taken with ob_mtx or ob_referrersmtx_ locked
+  static std::mutex ob_referrersbuildmtx_;
+  static bool referrers_tracked(void)
+  {
+    return ob_referrersactive_.load() || ob_referrersbuilding_.load();
+  };
+  static void referrers_count(Rps_ObjectZone*obsrc, Rps_ObjectZone*obtarget, int delta);
+  void update_references(Rps_Value oldval, Rps_Value newval);
+  void note_references(Rps_Value oldval, Rps_Value newval)
+  {
+    if (RPS_UNLIKELY(referrers_tracked()))
+      update_references(oldval, newval);
+  };
+  void forget_references(void);
+  /// uncount the references of OLDPAYL, removed from this object
+  void forget_payload_references(Rps_Payload*oldpayl);
+  /// apply F to the objects directly referenced by this one, with ob_mtx locked
+  void each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const;
 protected:
   void loader_set_class (Rps_Loader*ld, Rps_ObjectZone*obzclass)
   {
     RPS_ASSERT(ld != nullptr);
     RPS_ASSERT(obzclass != nullptr);
-    ob_class.store(obzclass);
+    change_class(obzclass);
   };
   void loader_set_mtime (Rps_Loader*ld, double mtim)
   {
@@ -3779,16 +4273,30 @@ protected:
     ob_comps.push_back(compval);
   };
 public:
+  /// decode the contents of a lazily loaded object, if still pending
+  void materialize(void) const
+  {
+    if (RPS_UNLIKELY(ob_lazystate.load(std::memory_order_acquire) != OBLAZY_NONE))
+      materialize_lazy();
+  };
+  bool is_lazy(void) const
+  {
+    return ob_lazystate.load() != OBLAZY_NONE;
+  };
+  /// the mutex guarding the contents, once materialized
   std::recursive_mutex* objmtxptr(void) const
   {
+    materialize();
     return &ob_mtx;
   };
   rps_magicgetterfun_t*magic_getter_function(void) const
   {
+    materialize();
     return ob_magicgetterfun.load();
   };
   rps_applyingfun_t*applying_function(void) const
   {
+    materialize();
     return ob_applyingfun.load();
   };
   void put_applying_function(rps_applyingfun_t*afun);
@@ -3812,6 +4320,47 @@ public:
   virtual Rps_ObjectRef compute_class(Rps_CallFrame*stkf) const;
   inline Rps_ObjectRef get_space(void) const;
   void put_space(Rps_ObjectRef obspace);
+  /// reclassify this object, throwing an exception if OBCLASS is not a class
+  void put_class(Rps_ObjectRef obclass);
+  //////////////// class extents, without subclasses, in O(result) time
+  static unsigned class_extent_size(Rps_ObjectRef obclass);
+  static std::vector<Rps_ObjectRef> class_extent(Rps_ObjectRef obclass);
+  static Rps_SetValue class_extent_set(Rps_ObjectRef obclass);
+  /// iterate on a snapshot of the extent; stops when STOPFUN returns true
+  static void iterate_class_extent(Rps_ObjectRef obclass, void*data,
+                                   const std::function<bool(void*,Rps_ObjectRef)>&stopfun);
+  //////////////// secondary attribute indexes, persisted in the manifest
+  static void add_attribute_index(Rps_ObjectRef obattr);
+  static void remove_attribute_index(Rps_ObjectRef obattr);
+  static bool has_attribute_index(Rps_ObjectRef obattr);
+  static std::vector<Rps_ObjectRef> attribute_indexes(void);
+  /// (re-)build the indexes of the given attributes by scanning every
+  /// object in up to NBTHREADS threads (by default rps_nbjobs)
+  static void rebuild_attribute_indexes(const std::vector<Rps_ObjectRef>&vecattr,
+                                        unsigned nbthreads=0);
+  /// the objects whose OBATTR is VAL; in O(result) time if OBATTR is
+  /// indexed, otherwise scanning every object
+  static std::vector<Rps_ObjectRef> objects_with_attribute(Rps_ObjectRef obattr, Rps_Value val);
+  static Rps_SetValue set_of_objects_with_attribute(Rps_ObjectRef obattr, Rps_Value val);
+  static void gc_mark_attribute_indexes(Rps_GarbageCollector*gc);
+  //////////////// referrers, i.e. objects referencing a given one
+  //////////////// thru their class, attributes or components
+  /// scan every object, in up to NBTHREADS threads, to build the index
+  static void build_referrers_index(unsigned nbthreads=0);
+  static void drop_referrers_index(void);
+  static bool has_referrers_index(void)
+  {
+    return ob_referrersactive_.load();
+  };
+  /// the referrers of OBTARGET, building the index on the first call
+  static std::vector<Rps_ObjectRef> referrers(Rps_ObjectRef obtarget);
+  static Rps_SetValue set_of_referrers(Rps_ObjectRef obtarget);
+  //////////////// heap integrity
+  /// check every object, in up to NBTHREADS threads, for dangling
+  /// references, classes without class information, instances of
+  /// classes without it, broken superclass chains and unregistered
+  /// symbols; warn about them and give their number
+  static unsigned check_heap_integrity(unsigned nbthreads=0);
   //////////////// attributes
   Rps_Value set_of_attributes(Rps_CallFrame*stkf) const;
   Rps_Value set_of_physical_attributes() const;
@@ -3866,17 +4415,19 @@ public:
   inline double get_mtime(void) const;
   inline rps_applyingfun_t*get_applyingfun(const Rps_ClosureValue&) const
   {
+    materialize();
     return ob_applyingfun.load();
   };
   inline rps_applyingfun_t* get_applying_ptrfun() const
   {
+    materialize();
     return ob_applyingfun.load();
   };
   inline void clear_payload(void);
   template<class PaylClass>
   PaylClass* put_new_plain_payload(void)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl = Rps_QuasiZone::rps_allocate1<PaylClass>(this);
     Rps_Payload*oldpayl = ob_payload.exchange(newpayl);
     if (oldpayl)
@@ -3886,7 +4437,7 @@ public:
   template<class PaylClass, typename Arg1Class>
   PaylClass* put_new_arg1_payload(Arg1Class arg1)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl =
       Rps_QuasiZone::rps_allocate2<PaylClass,Arg1Class>(this,arg1);
     Rps_Payload*oldpayl = ob_payload.exchange(newpayl);
@@ -3897,7 +4448,7 @@ public:
   template<class PaylClass, typename Arg1Class, typename Arg2Class>
   PaylClass* put_new_arg2_payload(Arg1Class arg1, Arg2Class arg2)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl =
       Rps_QuasiZone::rps_allocate3<PaylClass,Arg1Class,Arg2Class>(this,arg1,arg2);
     Rps_Payload*oldpayl = ob_payload.exchange(newpayl);
@@ -3908,7 +4459,7 @@ public:
   template<class PaylClass, typename Arg1Class, typename Arg2Class, typename Arg3Class>
   PaylClass* put_new_arg3_payload(Arg1Class arg1, Arg2Class arg2, Arg3Class arg3)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl =
       Rps_QuasiZone::rps_allocate4<PaylClass,Arg1Class,Arg2Class,Arg3Class>
       (this,arg1,arg2,arg3);
@@ -3920,7 +4471,7 @@ public:
   template<class PaylClass, typename Arg1Class, typename Arg2Class, typename Arg3Class, typename Arg4Class>
   PaylClass* put_new_arg4_payload(Arg1Class arg1, Arg2Class arg2, Arg3Class arg3, Arg4Class arg4)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl =
       Rps_QuasiZone::rps_allocate5<PaylClass,Arg1Class,Arg2Class,Arg3Class,Arg4Class>(this,arg1,arg2,arg3,arg4);
     Rps_Payload*oldpayl = ob_payload.exchange(newpayl);
@@ -3931,7 +4482,7 @@ public:
   template<class PaylClass>
   PaylClass* put_new_plain_payload_with_wordgap(unsigned wordgap)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl =
       Rps_QuasiZone::rps_allocate_with_wordgap<PaylClass>(wordgap,this);
     Rps_Payload*oldpayl = ob_payload.exchange(newpayl);
@@ -3942,7 +4493,7 @@ public:
   template<class PaylClass, typename Arg1Class>
   PaylClass* put_new_arg1_payload_with_wordgap(unsigned wordgap, Arg1Class arg1)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl =
       Rps_QuasiZone::rps_allocate_with_wordgap<PaylClass,Arg1Class>(wordgap,this,arg1);
     Rps_Payload*oldpayl = ob_payload.exchange(newpayl);
@@ -3953,7 +4504,7 @@ public:
   template<class PaylClass, typename Arg1Class, typename Arg2Class>
   PaylClass* put_new_arg2_payload_with_wordgap(unsigned wordgap, Arg1Class arg1, Arg2Class arg2)
   {
-    std::lock_guard<std::recursive_mutex> gu(ob_mtx);
+    std::lock_guard<std::recursive_mutex> gu(*objmtxptr());
     PaylClass*newpayl =
       Rps_QuasiZone::rps_allocate_with_wordgap<PaylClass,Arg1Class,Arg2Class>(wordgap,this,arg1,arg2);
     Rps_Payload*oldpayl = ob_payload.exchange(newpayl);
@@ -3998,10 +4549,13 @@ public:
   virtual bool less(const Rps_ZoneValue&zv) const;
   virtual void mark_gc_inside(Rps_GarbageCollector&gc);
   // given a C string which looks like an oid prefix, so starts with
-  // an underscore, a digit, and two alphanums, autocomplete that and
-  // call a given C++ closure on every possible object ref, till that
-  // closure returns true. Return the number of matches, or else 0
+  // an underscore and a digit, autocomplete that and call a given C++
+  // closure on every possible object ref, in increasing oid order,
+  // till that closure returns true. Return the number of matches, or
+  // else 0
   static int autocomplete_oid(const char*prefix, const std::function<bool(const Rps_ObjectZone*)>&stopfun);
+  // the number of objects whose oid starts with the given prefix
+  static size_t count_oid_prefix(const char*prefix);
 };                              // end class Rps_ObjectZone
 
 //////////////////////////////////////////////////////////// object payloads
@@ -4055,6 +4609,15 @@ public:
   {
     RPS_ASSERT(depth <= maxdepth);
   };
+  /// apply F to the objects referenced by this payload, with the
+  /// owner locked; used by the referrers index
+  virtual void each_referenced_object([[maybe_unused]] const std::function<void(Rps_ObjectZone*)>&f) const
+  {
+  };
+protected:
+  /// mutators of payloads with references tell the referrers index
+  /// that OLDVAL was replaced by NEWVAL, either being empty
+  inline void note_payload_references(Rps_Value oldval, Rps_Value newval);
 };                              // end Rps_Payload
 
 
@@ -4738,6 +5301,249 @@ public:
 };                              // end class Rps_JsonZone
 
 
+//////////////////////////////////////////////////////////////// hamt
+
+/// A persistent hash array mapped trie, an immutable map from
+/// non-empty Rps_Value keys to non-empty values. Each node has a
+/// bitmap of its inlined entries and another one of its subnodes
+/// (as in the CHAMP variant), indexed by five bits of the key
+/// hash. Adding or removing an entry gives a new root sharing every
+/// untouched subnode with the old one, so costs O(log32 n)
+/// allocations. Keys with the same 32 bits hash go into a collision
+/// node. Only root nodes (of shift 0) are visible as values. See
+/// hamt_rps.cc
+class Rps_HamtZone : public Rps_LazyHashedZoneValue
+{
+  friend Rps_HamtZone*
+  Rps_QuasiZone::rps_allocate_with_wordgap<Rps_HamtZone,unsigned,std::uint32_t,std::uint32_t,unsigned,unsigned,unsigned>(unsigned,unsigned,std::uint32_t,std::uint32_t,unsigned,unsigned,unsigned);
+public:
+  static constexpr unsigned hamt_bits = 5;
+  static constexpr unsigned hamt_width = 1U << hamt_bits;
+  static constexpr unsigned hamt_collision_shift = 8*sizeof(Rps_HashInt);
+  static unsigned constexpr maxsize
+    = std::numeric_limits<unsigned>::max() / 4;
+private:
+  const unsigned _hamt_shift;   // hamt_collision_shift for collision nodes
+  const std::uint32_t _hamt_datamap;
+  const std::uint32_t _hamt_nodemap;
+  const unsigned _hamt_nbdata;
+  const unsigned _hamt_nbnodes;
+  const unsigned _hamt_count;   // number of entries in the whole subtrie
+  /// the _hamt_nbdata key and value pairs, then the _hamt_nbnodes subnodes
+  Rps_Value _hamt_slots[RPS_FLEXIBLE_DIM+1];
+  virtual bool is_flexible() const
+  {
+    return true;
+  };
+  Rps_HamtZone(unsigned shift, std::uint32_t datamap, std::uint32_t nodemap,
+               unsigned nbdata, unsigned nbnodes, unsigned count)
+    : Rps_LazyHashedZoneValue(Rps_Type::Hamt),
+      _hamt_shift(shift), _hamt_datamap(datamap), _hamt_nodemap(nodemap),
+      _hamt_nbdata(nbdata), _hamt_nbnodes(nbnodes), _hamt_count(count)
+  {
+    memset ((void*)_hamt_slots, 0, sizeof(Rps_Value)*(2*nbdata+nbnodes));
+  };
+  static Rps_HamtZone* allocate_node(unsigned shift,
+                                     std::uint32_t datamap, std::uint32_t nodemap,
+                                     unsigned nbdata, unsigned nbnodes,
+                                     unsigned count);
+  static unsigned fragment(Rps_HashInt h, unsigned shift)
+  {
+    return (h >> shift) & (hamt_width-1);
+  };
+  static unsigned bitindex(std::uint32_t bitmap, std::uint32_t bit)
+  {
+    return __builtin_popcount(bitmap & (bit-1));
+  };
+  bool is_collision_node(void) const
+  {
+    return _hamt_shift >= hamt_collision_shift;
+  };
+  Rps_Value data_key(unsigned ix) const
+  {
+    return _hamt_slots[2*ix];
+  };
+  Rps_Value data_val(unsigned ix) const
+  {
+    return _hamt_slots[2*ix+1];
+  };
+  const Rps_HamtZone* subnode(unsigned ix) const
+  {
+    return reinterpret_cast<const Rps_HamtZone*>
+           (_hamt_slots[2*_hamt_nbdata+ix].to_ptr());
+  };
+  static const Rps_HamtZone* make_pair_node(unsigned shift,
+      Rps_Value key1, Rps_Value val1, Rps_HashInt h1,
+      Rps_Value key2, Rps_Value val2, Rps_HashInt h2);
+  Rps_Value find_hashed(Rps_Value key, Rps_HashInt h) const;
+  const Rps_HamtZone* put_hashed(Rps_Value key, Rps_Value val, Rps_HashInt h) const;
+  const Rps_HamtZone* remove_hashed(Rps_Value key, Rps_HashInt h) const;
+protected:
+  virtual Rps_HashInt compute_hash(void) const;
+  virtual Rps_ObjectRef compute_class(Rps_CallFrame*stkf) const;
+  virtual void gc_mark(Rps_GarbageCollector&gc, unsigned depth) const;
+  virtual void dump_scan(Rps_Dumper*du, unsigned depth) const;
+  virtual Json::Value dump_json(Rps_Dumper*du) const;
+public:
+  virtual uint32_t wordsize() const
+  {
+    return (sizeof(*this)
+            + (2*_hamt_nbdata+_hamt_nbnodes) * sizeof(_hamt_slots[0]))
+           / sizeof(void*);
+  };
+  virtual void val_output(std::ostream& outs, unsigned depth, unsigned maxdepth) const;
+  virtual bool equal(const Rps_ZoneValue&zv) const;
+  virtual bool less(const Rps_ZoneValue&zv) const;
+  unsigned count(void) const
+  {
+    return _hamt_count;
+  };
+  bool is_empty_map(void) const
+  {
+    return _hamt_count == 0;
+  };
+  /// the value associated to a key, or an empty value
+  Rps_Value find(Rps_Value key) const;
+  bool contains(Rps_Value key) const
+  {
+    return !find(key).is_empty();
+  };
+  /// give a new version with KEY associated to VAL, or this same map
+  /// if nothing changed; an empty VAL removes the KEY
+  const Rps_HamtZone* put(Rps_Value key, Rps_Value val) const;
+  /// give a new version without KEY, or this same map if KEY is absent
+  const Rps_HamtZone* remove(Rps_Value key) const;
+  /// apply a function to every entry in hash order, stopping as soon
+  /// as it returns true; gives true if stopped
+  bool each_entry(const std::function<bool(Rps_Value/*key*/,Rps_Value/*val*/)>&fun) const;
+  /// the entries sorted by keys, e.g. for dumping or output
+  std::vector<std::pair<Rps_Value,Rps_Value>> sorted_entries(void) const;
+  static const Rps_HamtZone* make_empty(void);
+  static const Rps_HamtZone* make(const std::map<Rps_Value,Rps_Value>& mapv);
+  static const Rps_HamtZone* make(const std::initializer_list<std::pair<Rps_Value,Rps_Value>>& il);
+  static const Rps_HamtZone* load_from_json(Rps_Loader*ld, const Json::Value& jv);
+};                              // end class Rps_HamtZone
+
+
+//////////////////////////////////////////////////////////////// numvect
+
+/// An immutable packed vector of numbers (double-s or int64-s), stored
+/// inline, without any per-element boxing. The kernels below are
+/// written as plain loops, with several accumulators for reductions,
+/// so that GCC vectorizes them on every target. Integer arithmetic
+/// wraps modulo 2**64. See numvect_rps.cc
+template<typename NumT, Rps_Type vecty>
+class Rps_NumVectZone : public Rps_LazyHashedZoneValue
+{
+  friend Rps_NumVectZone*
+  Rps_QuasiZone::rps_allocate_with_wordgap<Rps_NumVectZone,unsigned>(unsigned,unsigned);
+  static_assert(sizeof(NumT) == sizeof(std::uint64_t));
+  const unsigned _nvlen;
+  bool _nvsorted;
+  NumT _nvdata[RPS_FLEXIBLE_DIM+1];
+  virtual bool is_flexible() const
+  {
+    return true;
+  };
+  Rps_NumVectZone(unsigned len)
+    : Rps_LazyHashedZoneValue(vecty), _nvlen(len), _nvsorted(false)
+  {
+    memset ((void*)_nvdata, 0, sizeof(NumT)*len);
+  };
+  static Rps_NumVectZone* make_uninit(unsigned len);
+  void finish_make(void);
+  /// the comparison used for sorting, with NaN-s last
+  static bool elem_less(NumT x, NumT y)
+  {
+    if constexpr (std::is_floating_point_v<NumT>)
+      return x < y || (!std::isnan(x) && std::isnan(y));
+    else
+      return x < y;
+  };
+protected:
+  virtual Rps_HashInt compute_hash(void) const;
+  virtual Rps_ObjectRef compute_class(Rps_CallFrame*stkf) const;
+  virtual void gc_mark(Rps_GarbageCollector&, unsigned) const { };
+  virtual void dump_scan(Rps_Dumper*, unsigned) const {};
+  virtual Json::Value dump_json(Rps_Dumper*du) const;
+public:
+  typedef NumT elem_t;
+  static unsigned constexpr maxsize
+    = std::numeric_limits<unsigned>::max() / 2;
+  /// the vtype in dumped JSON
+  static const char*const json_vtype;
+  unsigned cnt() const
+  {
+    return _nvlen;
+  };
+  bool is_sorted() const
+  {
+    return _nvsorted;
+  };
+  NumT at(int ix) const
+  {
+    if (ix<0)
+      ix += cnt();
+    if (ix>=0 && ix <(int)cnt())
+      return _nvdata[ix];
+    else
+      throw std::range_error("index out of range in numeric vector");
+  };
+  const NumT* data() const
+  {
+    return _nvdata;
+  };
+  typedef const NumT*iterator_t;
+  iterator_t begin() const
+  {
+    return _nvdata;
+  };
+  iterator_t end() const
+  {
+    return _nvdata + _nvlen;
+  };
+  virtual uint32_t wordsize() const
+  {
+    return (sizeof(*this) + _nvlen * sizeof(NumT)) / sizeof(void*);
+  };
+  virtual void val_output(std::ostream& outs, unsigned depth, unsigned maxdepth) const;
+  virtual bool equal(const Rps_ZoneValue&zv) const;
+  virtual bool less(const Rps_ZoneValue&zv) const;
+  static const Rps_NumVectZone* make(const NumT*arr, unsigned len);
+  static const Rps_NumVectZone* make(const std::vector<NumT>& vec)
+  {
+    return make(vec.data(), vec.size());
+  };
+  static const Rps_NumVectZone* make(const std::initializer_list<NumT>& il)
+  {
+    return make(il.begin(), il.size());
+  };
+  static const Rps_NumVectZone* load_from_json(Rps_Loader*ld, const Json::Value& jv);
+  //// kernels
+  NumT sum(void) const;
+  /// throw std::invalid_argument on length mismatch
+  NumT dot(const Rps_NumVectZone*oth) const;
+  /// throw std::range_error when empty
+  NumT minimum(void) const;
+  NumT maximum(void) const;
+  /// elementwise arithmetic, OP is one of + - * /
+  /// throw std::invalid_argument on length mismatch or bad OP, and
+  /// std::domain_error on integer division by zero
+  static const Rps_NumVectZone* elementwise(const Rps_NumVectZone*left, char op,
+      const Rps_NumVectZone*right);
+  /// apply OP with a scalar right operand to every element
+  const Rps_NumVectZone* scalar_op(char op, NumT scal) const;
+  const Rps_NumVectZone* sorted(void) const;
+  /// give the index of some element equal to X or -1, using binary
+  /// search in sorted vectors
+  int search(NumT x) const;
+};                              // end class Rps_NumVectZone
+
+typedef Rps_NumVectZone<double,Rps_Type::DoubleVect> Rps_DoubleVectZone;
+typedef Rps_NumVectZone<std::int64_t,Rps_Type::IntVect> Rps_IntVectZone;
+
+
+
 ////////////////////////////////////////////////////////////////
 
 
@@ -5087,10 +5893,12 @@ public:
   };
   void put_superclass(Rps_ObjectRef obr)
   {
+    note_payload_references(pclass_super, obr);
     pclass_super = obr;
   };
   inline void clear_symbname(void)
   {
+    note_payload_references(pclass_symbname, nullptr);
     pclass_symbname = nullptr;
   };
   std::string class_name_str(void) const;
@@ -5114,15 +5922,26 @@ public:
   };
   void put_own_method(Rps_ObjectRef obsel, Rps_ClosureValue clov)
   {
-    if (obsel && clov && clov.is_closure())
-      pclass_methdict.insert({obsel,clov});
+    if (obsel && clov && clov.is_closure()
+        && pclass_methdict.insert({obsel,clov}).second)
+      {
+        note_payload_references(nullptr, obsel);
+        note_payload_references(nullptr, clov);
+      }
   };
   void remove_own_method(Rps_ObjectRef obsel)
   {
-    if (obsel)
-      pclass_methdict.erase(obsel);
+    if (!obsel)
+      return;
+    auto it = pclass_methdict.find(obsel);
+    if (it == pclass_methdict.end())
+      return;
+    note_payload_references(obsel, nullptr);
+    note_payload_references(it->second, nullptr);
+    pclass_methdict.erase(it);
   };
   virtual void output_payload(std::ostream&out, unsigned depth, unsigned maxdepth) const;
+  virtual void each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const;
 };                              // end Rps_PayloadClassInfo
 
 
@@ -5179,20 +5998,26 @@ public:
   void add(const Rps_ObjectZone* obelem)
   {
     if (obelem)
-      psetob.insert(Rps_ObjectRef(obelem));
+      add(Rps_ObjectRef(obelem));
   };
   void add (const Rps_ObjectRef obrelem)
   {
-    if (!obrelem.is_empty())
-      psetob.insert(obrelem);
+    if (!obrelem.is_empty() && psetob.insert(obrelem).second)
+      note_payload_references(nullptr, obrelem);
   };
   void remove(const Rps_ObjectZone* obelem)
   {
-    if (obelem) psetob.erase(Rps_ObjectRef(obelem));
+    if (obelem) remove(Rps_ObjectRef(obelem));
   };
   void remove (const Rps_ObjectRef obrelem)
   {
-    if (obrelem) psetob.erase(obrelem);
+    if (obrelem && psetob.erase(obrelem) > 0)
+      note_payload_references(obrelem, nullptr);
+  };
+  virtual void each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const
+  {
+    for (Rps_ObjectRef obelem : psetob)
+      f(obelem.optr());
   };
   Rps_SetValue to_set() const
   {
@@ -5214,6 +6039,211 @@ public:
 };                              // end Rps_PayloadSetOb
 
 
+/// run F(from,to) on consecutive ranges covering [0,SIZE), in at most
+/// NBTHREADS threads each given at least MINRANGE indexes; the first
+/// exception thrown by F is rethrown once every thread is joined
+template <typename Fun> void
+rps_parallel_ranges(size_t size, unsigned nbthreads, size_t minrange, Fun f)
+{
+  if (minrange == 0)
+    minrange = 1;
+  if (nbthreads > size/minrange)
+    nbthreads = size/minrange;
+  if (nbthreads <= 1)
+    {
+      f((size_t)0, size);
+      return;
+    };
+  size_t rangelen = (size + nbthreads - 1) / nbthreads;
+  std::vector<std::exception_ptr> excvec(nbthreads);
+  std::vector<std::thread> thrvec;
+  thrvec.reserve(nbthreads-1);
+  for (unsigned tix=1; tix<nbthreads; tix++)
+    {
+      size_t from = tix*rangelen;
+      size_t to = std::min(from+rangelen, size);
+      if (from < to)
+        thrvec.emplace_back([=,&f,&excvec]()
+      {
+        try
+          {
+            f(from, to);
+          }
+        catch (...)
+          {
+            excvec[tix] = std::current_exception();
+          }
+      });
+    };
+  try
+    {
+      f((size_t)0, std::min(rangelen, size));
+    }
+  catch (...)
+    {
+      excvec[0] = std::current_exception();
+    }
+  for (std::thread&thr : thrvec)
+    thr.join();
+  for (std::exception_ptr&exc : excvec)
+    if (exc)
+      std::rethrow_exception(exc);
+} // end rps_parallel_ranges
+
+////////////////////////////////////////////////////////////////
+////// segmented vectors, used inside mutable vector payloads. The
+////// chunk of rank k has 2**(k+segv_firstlog) elements, so an index
+////// is found by a count of leading zeros and appending never moves
+////// any element; only the small directory of chunks is reallocated.
+template <typename T> class Rps_SegmentedVector
+{
+  static constexpr unsigned segv_firstlog = 3;
+  std::vector<T*> segv_chunks;
+  size_t segv_size;
+  static unsigned chunk_rank(size_t ix)
+  {
+    std::uint64_t j = (std::uint64_t)ix + (1ULL<<segv_firstlog);
+    return (63 - __builtin_clzll(j)) - segv_firstlog;
+  };
+  static size_t chunk_start(unsigned rk)
+  {
+    return (1ULL<<(rk+segv_firstlog)) - (1ULL<<segv_firstlog);
+  };
+  static size_t chunk_length(unsigned rk)
+  {
+    return 1ULL<<(rk+segv_firstlog);
+  };
+public:
+  Rps_SegmentedVector() : segv_chunks(), segv_size(0) {};
+  Rps_SegmentedVector(const Rps_SegmentedVector&) = delete;
+  Rps_SegmentedVector& operator = (const Rps_SegmentedVector&) = delete;
+  ~Rps_SegmentedVector()
+  {
+    clear();
+  };
+  size_t size(void) const
+  {
+    return segv_size;
+  };
+  bool empty(void) const
+  {
+    return segv_size == 0;
+  };
+  size_t capacity(void) const
+  {
+    return chunk_start(segv_chunks.size());
+  };
+  const T& operator [] (size_t ix) const
+  {
+    RPS_ASSERT(ix < segv_size);
+    unsigned rk = chunk_rank(ix);
+    return segv_chunks[rk][ix - chunk_start(rk)];
+  };
+  T& operator [] (size_t ix)
+  {
+    RPS_ASSERT(ix < segv_size);
+    unsigned rk = chunk_rank(ix);
+    return segv_chunks[rk][ix - chunk_start(rk)];
+  };
+  /// allocate chunks for at least SIZ elements, never moving existing ones
+  void reserve(size_t siz)
+  {
+    while (capacity() < siz)
+      segv_chunks.push_back(new T[chunk_length(segv_chunks.size())]);
+  };
+  void push_back(const T&x)
+  {
+    reserve(segv_size+1);
+    size_t ix = segv_size++;
+    (*this)[ix] = x;
+  };
+  void append(const T*arr, size_t nb)
+  {
+    if (!arr || nb==0)
+      return;
+    reserve(segv_size+nb);
+    size_t done = 0;
+    while (done < nb)
+      {
+        size_t ix = segv_size;
+        unsigned rk = chunk_rank(ix);
+        size_t off = ix - chunk_start(rk);
+        size_t cnt = std::min(nb - done, chunk_length(rk) - off);
+        std::copy(arr+done, arr+done+cnt, segv_chunks[rk]+off);
+        segv_size += cnt;
+        done += cnt;
+      }
+  };
+  void append(const std::vector<T>&vec)
+  {
+    append(vec.data(), vec.size());
+  };
+  /// shrink to the NEWSIZE first elements, keeping the chunks
+  void truncate(size_t newsize)
+  {
+    while (segv_size > newsize)
+      {
+        (*this)[segv_size-1] = T();
+        segv_size--;
+      }
+  };
+  void clear(void)
+  {
+    for (T*chk : segv_chunks)
+      delete[] chk;
+    segv_chunks.clear();
+    segv_size = 0;
+  };
+  /// apply F(ix,elem) to the elements of index in [FROM, TO[, chunk by chunk
+  template <typename Fun> void each_in_range(size_t from, size_t to, Fun f) const
+  {
+    if (to > segv_size)
+      to = segv_size;
+    size_t ix = from;
+    while (ix < to)
+      {
+        unsigned rk = chunk_rank(ix);
+        size_t off = ix - chunk_start(rk);
+        size_t cnt = std::min(to - ix, chunk_length(rk) - off);
+        const T*chk = segv_chunks[rk];
+        for (size_t i=0; i<cnt; i++)
+          f(ix+i, chk[off+i]);
+        ix += cnt;
+      }
+  };
+  template <typename Fun> void each(Fun f) const
+  {
+    each_in_range(0, segv_size, [&](size_t, const T&x)
+    {
+      f(x);
+    });
+  };
+  std::vector<T> to_vector(size_t from=0, size_t to=SIZE_MAX) const
+  {
+    std::vector<T> vec;
+    if (to > segv_size)
+      to = segv_size;
+    if (from < to)
+      vec.reserve(to - from);
+    each_in_range(from, to, [&](size_t, const T&x)
+    {
+      vec.push_back(x);
+    });
+    return vec;
+  };
+  /// split [0,size) into at most NBTHREADS contiguous ranges of at
+  /// least MINRANGE elements, and run F(from,to) on each range in its
+  /// own thread, the first range running in the calling thread. F
+  /// should not allocate GC-ed values unless the caller is an agenda
+  /// worker (which the garbage collector waits for).
+  template <typename Fun> void parallel_ranges(unsigned nbthreads,
+      size_t minrange, Fun f) const
+  {
+    rps_parallel_ranges(segv_size, nbthreads, minrange, f);
+  };
+};                              // end Rps_SegmentedVector
+
+
 ////////////////////////////////////////////////////////////////
 ////// mutable vector of objects payload - for PaylVectOb and objects
 ////// of class `mutable_object_vector _8YknAApDQiF04BDe3W
@@ -5224,7 +6254,7 @@ class Rps_PayloadVectOb : public Rps_Payload
   friend class Rps_ObjectZone;
   friend Rps_PayloadVectOb*
   Rps_QuasiZone::rps_allocate1<Rps_PayloadVectOb,Rps_ObjectZone*>(Rps_ObjectZone*);
-  std::vector<Rps_ObjectRef> pvectob;
+  Rps_SegmentedVector<Rps_ObjectRef> pvectob;
   inline Rps_PayloadVectOb(Rps_ObjectZone*owner);
   Rps_PayloadVectOb(Rps_ObjectRef obr) :
     Rps_PayloadVectOb(obr?obr.optr():nullptr) {};
@@ -5269,17 +6299,39 @@ public:
   void push_back(const Rps_ObjectZone* obcomp)
   {
     if (obcomp)
-      pvectob.push_back(Rps_ObjectRef(obcomp));
+      push_back(Rps_ObjectRef(obcomp));
   };
   void push_back (const Rps_ObjectRef obrcomp)
   {
-    if (obrcomp)
-      pvectob.push_back(obrcomp);
+    if (!obrcomp)
+      return;
+    pvectob.push_back(obrcomp);
+    note_payload_references(nullptr, obrcomp);
   };
-  Rps_TupleValue to_tuple() const
+  virtual void each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const
   {
-    return Rps_TupleValue(pvectob);
+    pvectob.each_in_range(0, pvectob.size(), [&](size_t, const Rps_ObjectRef&obcomp)
+    {
+      f(obcomp.optr());
+    });
   };
+  Rps_TupleValue to_tuple() const
+  {
+    return Rps_TupleValue(pvectob.to_vector());
+  };
+  /// bulk operations lock the owner once; null objects are skipped
+  void append_objects(const std::vector<Rps_ObjectRef>&vecob);
+  /// the components of index in [FROM, TO[, negative indexes counting
+  /// from the end
+  std::vector<Rps_ObjectRef> slice(int from, int to) const;
+  /// apply a C++ function to every component, in several threads for
+  /// big vectors (at most NBTHREADS, by default rps_nbjobs); the
+  /// function runs on a copy of the components without the owner's
+  /// lock, and the first exception it throws is rethrown here
+  std::vector<Rps_Value> parallel_map(const std::function<Rps_Value(Rps_ObjectRef)>&fun,
+                                      unsigned nbthreads=0) const;
+  std::vector<Rps_ObjectRef> parallel_filter(const std::function<bool(Rps_ObjectRef)>&pred,
+      unsigned nbthreads=0) const;
   virtual void output_payload(std::ostream&out,
                               unsigned depth, unsigned maxdepth) const;
 };                              // end Rps_PayloadVectOb
@@ -5298,7 +6350,7 @@ class Rps_PayloadVectVal : public Rps_Payload
   friend  rpsldpysig_t rpsldpy_vectval;
   friend Rps_PayloadVectVal*
   Rps_QuasiZone::rps_allocate1<Rps_PayloadVectVal,Rps_ObjectZone*>(Rps_ObjectZone*);
-  std::vector<Rps_Value> pvectval;
+  Rps_SegmentedVector<Rps_Value> pvectval;
   inline Rps_PayloadVectVal(Rps_ObjectZone*owner);
   Rps_PayloadVectVal(Rps_ObjectRef obr) :
     Rps_PayloadVectVal(obr?obr.optr():nullptr) {};
@@ -5342,14 +6394,36 @@ public:
   };
   void push_back(const Rps_Value val)
   {
-    if (val)
-      pvectval.push_back(val);
+    if (!val)
+      return;
+    pvectval.push_back(val);
+    note_payload_references(nullptr, val);
   };
   void push_back (const Rps_ObjectRef obrcomp)
   {
     if (obrcomp)
-      pvectval.push_back(Rps_ObjectValue(obrcomp));
-  };
+      push_back(Rps_ObjectValue(obrcomp));
+  };
+  virtual void each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const
+  {
+    pvectval.each_in_range(0, pvectval.size(), [&](size_t, const Rps_Value&val)
+    {
+      rps_each_object_in_value(val, f);
+    });
+  };
+  /// bulk operations lock the owner once; empty values are skipped
+  void append_values(const std::vector<Rps_Value>&vecval);
+  /// the components of index in [FROM, TO[, negative indexes counting
+  /// from the end
+  std::vector<Rps_Value> slice(int from, int to) const;
+  /// apply a C++ function to every component, in several threads for
+  /// big vectors (at most NBTHREADS, by default rps_nbjobs); the
+  /// function runs on a copy of the components without the owner's
+  /// lock, and the first exception it throws is rethrown here
+  std::vector<Rps_Value> parallel_map(const std::function<Rps_Value(Rps_Value)>&fun,
+                                      unsigned nbthreads=0) const;
+  std::vector<Rps_Value> parallel_filter(const std::function<bool(Rps_Value)>&pred,
+                                         unsigned nbthreads=0) const;
   /* make a new closure from a given connective and the values inside
      the vector payload: */
   const Rps_ClosureZone* make_closure_zone_from_vector(Rps_ObjectRef connob);
@@ -5376,7 +6450,13 @@ class Rps_PayloadStrBuf : public Rps_Payload
   Rps_PayloadStrBuf(Rps_ObjectRef obr) :
     Rps_PayloadStrBuf(obr?obr.optr():nullptr) {};
   virtual ~Rps_PayloadStrBuf();
-  mutable std::stringbuf strbuf_buffer;
+  /* The buffer content is a rope: the concatenation of the chunks.
+     Small appended or prepended strings are merged into the last or
+     first chunk, others become a new chunk, so prepending or
+     inserting is cheap and output does not need any flattening. */
+  static constexpr size_t strbuf_small_chunk = 4096;
+  std::deque<std::string> strbuf_chunks;
+  size_t strbuf_size;
   int strbuf_indent;
   bool strbuf_transient;
 protected:
@@ -5393,14 +6473,6 @@ public:
   {
     return "string_buffer";
   };
-  std::stringbuf& string_buffer(void)
-  {
-    return strbuf_buffer;
-  };
-  const std::stringbuf& const_string_buffer(void) const
-  {
-    return strbuf_buffer;
-  };
   //std::ostringstream* output_string_stream_ptr(void) { return &strbuf_stream; };
   //const std::ostream& output_stream(void) const { return strbuf_out; };
   //std::ostringstream& output_string_stream(void) { return strbuf_out; };
@@ -5434,18 +6506,27 @@ public:
   };
   inline Rps_PayloadStrBuf(Rps_ObjectZone*obz, Rps_Loader*ld);
   static inline Rps_ObjectRef the_string_buffer_class(void);
-  //- unsigned buffer_length(void) const
-  //- {
-  //-  return strbuf_buffer.size();
-  //- };
-  std::string buffer_cppstring(void) const
+  size_t buffer_length(void) const
+  {
+    return strbuf_size;
+  };
+  unsigned nb_chunks(void) const
   {
-    return strbuf_buffer.str();
+    return strbuf_chunks.size();
   };
+  /// flatten the rope into a fresh string
+  std::string buffer_cppstring(void) const;
   Rps_StringValue buffer_stringval(void);
   void clear_buffer(void);
   void append_string(const std::string&str);
   void prepend_string(const std::string&str);
+  /// insert STR at byte offset OFF, or append if OFF is too big
+  void insert_string(size_t off, const std::string&str);
+  /// output every chunk, without flattening
+  void output_buffer(std::ostream&out) const;
+  /// write every chunk with writev(2) to file descriptor FD; return
+  /// the number of written bytes, or -1 on error (with errno set)
+  ssize_t write_buffer_to_fd(int fd) const;
   virtual void output_payload(std::ostream&out,
                               unsigned depth, unsigned maxdepth) const;
 };                              // end of class Rps_PayloadStrBuf
@@ -5498,14 +6579,192 @@ public:
   /// iterate by applying a closure to the owner, a fresh string value
   /// and associated value till the closure returns nil
   void iterate_apply(Rps_CallFrame*callframe, Rps_Value closv);
+  /// iterate, in sorted order, on the entries whose string starts
+  /// with PREFIX, e.g. for autocompletion
+  void iterate_prefixed(const std::string&prefix, void*data,
+                        const std::function <bool(void*,
+                            const std::string&,const Rps_Value)>& stopfun);
+  /// the sorted strings starting with PREFIX, at most MAXCOUNT of them
+  /// if it is positive
+  std::vector<std::string> prefixed_strings(const std::string&prefix,
+      unsigned maxcount=0) const;
+  unsigned count(void) const
+  {
+    return dict_count;
+  };
   virtual void output_payload(std::ostream&out,
                               unsigned depth, unsigned maxdepth) const;
 private:
-  std::map<std::string, Rps_Value> dict_map;
+  /// The entries are kept in insertion order in dict_entries. The
+  /// open addressing dict_index, of power of two size, contains
+  /// indexes into dict_entries, or dict_emptyslot or dict_removedslot;
+  /// it is at most half full. The sorted order is computed on demand
+  /// for iterations and dumps, then kept till some key is added or
+  /// removed.
+  struct dict_entry_st
+  {
+    std::string de_str;        // short strings stay inline
+    Rps_Value de_val;          // empty for removed entries
+    Rps_HashInt de_hash;
+  };
+  static constexpr int32_t dict_emptyslot = -1;
+  static constexpr int32_t dict_removedslot = -2;
+  static constexpr unsigned dict_minindexsize = 16;
+  std::vector<dict_entry_st> dict_entries;
+  std::vector<int32_t> dict_index;
+  unsigned dict_count;          // number of live entries
+  unsigned dict_iterating;      // nesting of sorted iterations
+  /// counts an iteration in dict_iterating, even when the callback throws
+  struct iterating_guard
+  {
+    Rps_PayloadStringDict* ig_dict;
+    iterating_guard(Rps_PayloadStringDict*dict) : ig_dict(dict)
+    {
+      ig_dict->dict_iterating++;
+    };
+    ~iterating_guard()
+    {
+      ig_dict->dict_iterating--;
+    };
+    iterating_guard(const iterating_guard&) = delete;
+    iterating_guard& operator=(const iterating_guard&) = delete;
+  };
+  /// cache of the entry indexes sorted by string, rebuilt by const
+  /// readers with the owner's lock held
+  mutable std::vector<unsigned> dict_sorted;
+  mutable bool dict_sorted_valid;
   bool dict_is_transient;
+  static Rps_HashInt dict_hash(const std::string&str)
+  {
+    return rps_hash_cstr(str.c_str(), str.size());
+  };
+  int find_index_slot(const std::string&str, Rps_HashInt h) const;
+  void reorganize(unsigned minsize);
+  const std::vector<unsigned>& sorted_entries(void) const;
+  /// first position in the sorted entries whose string is not less
+  /// than STR
+  unsigned sorted_lower_bound(const std::string&str) const;
 }; // end class Rps_PayloadStringDict
 
 
+////////////////////////////////////////////////////////////////
+////// mutable hash map payload  - associate any non-empty value to
+////// values, using their valhash() and equality; e.g. for memoization
+////// tables keyed by argument tuples. Public member functions lock
+////// the owner.
+extern "C" rpsldpysig_t rpsldpy_value_map;
+class Rps_PayloadValMap : public Rps_Payload
+{
+  friend class Rps_ObjectRef;
+  friend class Rps_ObjectZone;
+  friend rpsldpysig_t rpsldpy_value_map;
+  friend Rps_PayloadValMap*
+  Rps_QuasiZone::rps_allocate1<Rps_PayloadValMap,Rps_ObjectZone*>(Rps_ObjectZone*);
+  Rps_PayloadValMap(Rps_ObjectZone*owner);
+  Rps_PayloadValMap(Rps_ObjectRef obr) :
+    Rps_PayloadValMap(obr?obr.optr():nullptr) {};
+  virtual ~Rps_PayloadValMap();
+  virtual uint32_t wordsize(void) const
+  {
+    return (sizeof(*this)+sizeof(void*)-1)/sizeof(void*);
+  };
+protected:
+  virtual void gc_mark(Rps_GarbageCollector&gc) const;
+  virtual void dump_scan(Rps_Dumper*du) const;
+  virtual void dump_json_content(Rps_Dumper*, Json::Value&) const;
+public:
+  virtual void each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const;
+  virtual const std::string payload_type_name(void) const
+  {
+    return "value_map";
+  };
+  /// give the value associated to KEY, or else an empty value
+  Rps_Value find(Rps_Value key, bool*pmissing=nullptr) const;
+  bool contains(Rps_Value key) const;
+  /// add or replace the entry for a non-empty KEY; an empty VAL
+  /// removes it
+  void put(Rps_Value key, Rps_Value val);
+  bool remove(Rps_Value key);
+  void clear(void);
+  void set_transient(bool transient=false);
+  unsigned count(void) const
+  {
+    return vm_count;
+  };
+  /// the entries sorted by key, as dumped
+  std::vector<std::pair<Rps_Value,Rps_Value>> sorted_entries(void) const;
+  /// iterate on a snapshot of the entries, in no particular order, so
+  /// STOPFUN may update this map; the iteration stops when it returns
+  /// true
+  void iterate_with_data(void*data,
+                         const std::function <bool(void*,
+                             const Rps_Value,const Rps_Value)>& stopfun) const;
+  /// iterate by applying a closure to the owner, the key and its
+  /// associated value till the closure returns nil
+  void iterate_apply(Rps_CallFrame*callframe, Rps_Value closv);
+  virtual void output_payload(std::ostream&out,
+                              unsigned depth, unsigned maxdepth) const;
+private:
+  /// Open addressing with linear probing in power of two sized
+  /// tables, at most half full. Growing does not rehash everything at
+  /// once: the previous table is kept in vm_oldslots and every
+  /// mutation migrates a few of its slots into vm_slots, so no single
+  /// put holds the owner's lock for a time proportional to the size.
+  enum vm_state_en : std::uint8_t
+  {
+    vm_state_empty=0, vm_state_used, vm_state_removed
+  };
+  struct vm_slot_st
+  {
+    Rps_Value vs_key;
+    Rps_Value vs_val;
+    Rps_HashInt vs_hash;
+    vm_state_en vs_state;
+  };
+  static constexpr unsigned vm_minsize = 16;
+  static constexpr unsigned vm_migratestep = 8;
+  std::vector<vm_slot_st> vm_slots;
+  std::vector<vm_slot_st> vm_oldslots;
+  unsigned vm_count;            // live entries in both tables
+  unsigned vm_used;             // used or removed slots in vm_slots
+  unsigned vm_oldcount;         // live entries left in vm_oldslots
+  unsigned vm_migrated;         // next slot to migrate in vm_oldslots
+  bool vm_is_transient;
+  /// keys and values being iterated upon, one vector per running
+  /// iteration, kept for the GC; the iterations run their callbacks
+  /// without holding the owner's lock
+  mutable std::list<std::vector<Rps_Value>> vm_snapshots;
+  struct snapshot_st
+  {
+    const Rps_PayloadValMap* sn_valmap;
+    std::list<std::vector<Rps_Value>>::iterator sn_it;
+    snapshot_st(const Rps_PayloadValMap*valmap);
+    ~snapshot_st();
+    snapshot_st(const snapshot_st&) = delete;
+    snapshot_st& operator=(const snapshot_st&) = delete;
+    const std::vector<Rps_Value>& keys_and_values(void) const
+    {
+      return *sn_it;
+    };
+  };
+  static int find_in_slots(const std::vector<vm_slot_st>&slots,
+                           Rps_Value key, Rps_HashInt h);
+  static bool place_in_slots(std::vector<vm_slot_st>&slots,
+                             Rps_Value key, Rps_Value val, Rps_HashInt h);
+  void grow(unsigned mincount);
+  void migrate_some(unsigned nbslots);
+  template <typename Fun> void each_slot(Fun f) const
+  {
+    for (const vm_slot_st& slot : vm_slots)
+      if (slot.vs_state == vm_state_used)
+        f(slot);
+    for (unsigned ix = vm_migrated; ix < vm_oldslots.size(); ix++)
+      if (vm_oldslots[ix].vs_state == vm_state_used)
+        f(vm_oldslots[ix]);
+  };
+}; // end class Rps_PayloadValMap
+
+
 ////////////////////////////////////////////////////////////////
 ////// mutable space payload, objects of class `space`
 ////// _2i66FFjmS7n03HNNBx
@@ -5565,6 +6824,8 @@ class Rps_PayloadSymbol : public Rps_Payload
   std::atomic<bool> symb_is_weak;
   static std::recursive_mutex symb_tablemtx;
   static std::map<std::string,Rps_PayloadSymbol*> symb_table;
+  /// the radix trie of symbol names, kept in sync with symb_table
+  static Rps_RadixTrie<Rps_PayloadSymbol*> symb_trie;
   static std::unordered_map<std::string,Rps_ObjectRef*>
   symb_hardcoded_hashtable;
 protected:
@@ -5671,8 +6932,27 @@ extern "C" rpsldpysig_t rpsldpy_objmap;
 // descriptive value and is subclassed by Rps_PayloadEnvironment
 class Rps_PayloadObjMap : public Rps_Payload
 {
-  std::map<Rps_ObjectRef,Rps_Value> obm_map;
+  /// A flat open addressing table with linear probing on the object
+  /// hash; its size is a power of two, and it is kept at most half
+  /// full, counting removed slots. Iteration order is unspecified.
+  struct obm_slot_st
+  {
+    Rps_ObjectZone* os_key;     // nullptr if empty, obm_removedkey if removed
+    Rps_Value os_val;
+  };
+  std::vector<obm_slot_st> obm_slots;
+  unsigned obm_count;           // number of entries
+  unsigned obm_used;            // entries and removed slots
   Rps_Value obm_descr;
+  static constexpr unsigned obm_minsize = 8;
+  static Rps_ObjectZone* obm_removedkey(void)
+  {
+    return (Rps_ObjectZone*)RPS_EMPTYSLOT;
+  };
+  /// the slot index of OBKEY, or -1 when missing
+  int obm_find_slot(Rps_ObjectRef obkey) const;
+  void obm_reorganize(unsigned mincount);
+  void obm_clear(void);
   friend class Rps_ObjectRef;
   friend class Rps_ObjectZone;
   friend rpsldpysig_t rpsldpy_objmap;
@@ -5685,7 +6965,7 @@ protected:
     Rps_PayloadObjMap(obr?obr.optr():nullptr) {};
   virtual ~Rps_PayloadObjMap()
   {
-    obm_map.clear();
+    obm_clear();
     obm_descr = nullptr;
   };
   virtual uint32_t wordsize(void) const
@@ -5705,7 +6985,7 @@ protected:
 public:
   size_t get_obmap_size() const
   {
-    return obm_map.size();
+    return obm_count;
   };
   virtual const std::string payload_type_name(void) const
   {
@@ -5730,29 +7010,46 @@ public:
   };
   void put_descr(Rps_Value d)
   {
+    note_payload_references(obm_descr, d);
     obm_descr = d;
   };
+  virtual void each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const;
+  /// the live entries, in slot order
+  std::vector<std::pair<Rps_ObjectRef,Rps_Value>> obmap_entries(void) const
+  {
+    std::vector<std::pair<Rps_ObjectRef,Rps_Value>> entvec;
+    entvec.reserve(obm_count);
+    for (unsigned ix=0; ix<obm_slots.size(); ix++)
+      {
+        Rps_ObjectZone* curkey = obm_slots[ix].os_key;
+        if (!curkey || curkey == obm_removedkey())
+          continue;
+        entvec.emplace_back(Rps_ObjectRef(curkey), obm_slots[ix].os_val);
+      }
+    return entvec;
+  };
+  /// the iterations below are in unspecified order, on a copy of the
+  /// entries so the callback may put or remove entries, which it
+  /// won't see
   template <typename Data_t>
   void do_each_obmap_entry(Data_t tpd,
                            std::function<bool(Data_t, Rps_ObjectRef,Rps_Value,void*)>fun,
                            void*clientdata=nullptr) const
   {
-    for (auto it: obm_map)
-      {
-        if (fun(tpd, it.first, it.second, clientdata))
-          break;
-      }
+    for (auto& ent : obmap_entries())
+      if (fun(tpd, ent.first, ent.second, clientdata))
+        break;
   }; ///-end templated do_each_obmap_entry
   void do_each_entry(Rps_CallFrame*cf,
                      std::function<bool(Rps_CallFrame*,Rps_ObjectRef,Rps_Value,void*)> f,
                      void* clientdata=nullptr) const
   {
-    for (auto it: obm_map)
-      {
-        if (f(cf, it.first, it.second, clientdata))
-          break;
-      }
+    for (auto& ent : obmap_entries())
+      if (f(cf, ent.first, ent.second, clientdata))
+        break;
   };
+  /// the keys sorted by oid, e.g. for deterministic dumps
+  std::vector<Rps_ObjectRef> sorted_obmap_keys(void) const;
   virtual void output_payload(std::ostream&out, unsigned depth,
                               unsigned maxdepth) const;
 };                              // end Rps_PayloadObjMap
@@ -5988,8 +7285,16 @@ extern "C" bool rps_generate_cplusplus_code(Rps_CallFrame*callerframe,
 extern "C" Json::Value rps_load_string_to_json(const std::string&str,
     const char*filnam=nullptr,
     int lineno=0);
+/// same, without copying, e.g. for a slice of a memory mapped file
+extern "C" Json::Value rps_load_string_view_to_json(std::string_view strv,
+    const char*filnam=nullptr,
+    int lineno=0);
 extern "C" std::string rps_load_json_to_string(const Json::Value&jv);
 
+/// base64 encoding of binary data inside JSON, in utilities_rps.cc
+extern "C" std::string rps_base64_encode(const void*data, size_t len);
+extern "C" bool rps_base64_decode(const std::string&str, std::string&out);
+
 extern "C" void rps_dump_into (std::string dirpath = ".",
                                Rps_CallFrame* callframe = nullptr); // in store_rps.cc
 extern "C" double rps_dump_start_elapsed_time(Rps_Dumper*);
@@ -6029,6 +7334,230 @@ extern "C" void rps_load_add_todo(Rps_Loader*,
                                   const std::function<void(Rps_Loader*)>&
                                   todofun);
 
+/// with --lazy-load, the number of loaded objects still waiting for
+/// their contents, materializing all of them, and marking every
+/// loaded object for the garbage collector while some are pending,
+/// since their references are not yet known
+extern "C" unsigned rps_load_nb_lazy_objects(void);
+extern "C" void rps_load_materialize_all(void);
+extern "C" void rps_load_gc_mark_lazy(Rps_GarbageCollector*gc);
+/// held by the background materializing thread, and by the
+/// garbage collector, which cannot run concurrently with it
+extern "C" std::mutex rps_load_lazy_mutex;
+
+/// emit the JSON text of a dumped object, from its opening to its
+/// closing brace, with "oid" and "mtime" first; shared by the dumper
+/// and the binary to JSON converter, in dump_rps.cc
+extern "C" void rps_dump_emit_object_json(std::ostream&out,
+    const Json::Value&jobject,
+    double mtime);
+
+////................................................................
+//// compact binary snapshots of space files, in binstore_rps.cc
+////................................................................
+
+/// The JSON space files stay the canonical persistent state. A
+/// persistore/sp*-rps.bin file is a derived snapshot of the JSON
+/// space file of the same space, remembering its size and
+/// modification time to be ignored once stale. It has a fixed header
+/// (magic, version, flags, JSON size and mtime, body size and
+/// checksum) and a body made of a string pool, an oid table, the
+/// prologue and one record per object. Objects of usual shape are
+/// typed records referencing the pools by varint indexes, the other
+/// ones keep their JSON text. Converting JSON to binary then back is
+/// byte for byte identical.
+#define RPS_BINSTORE_MAGIC "RPSBIN\x1a\n"
+#define RPS_BINSTORE_VERSION 1
+#define RPS_BINSTORE_SUFFIX "-rps.bin"
+extern "C" bool rps_binary_store; /// --binary-store option
+
+class Rps_BinStoreReader
+{
+  const unsigned char* bsr_start;
+  const unsigned char* bsr_cur;
+  const unsigned char* bsr_end;
+  [[noreturn]] void overflow(void) const;
+public:
+  Rps_BinStoreReader(std::string_view sv)
+    : bsr_start((const unsigned char*)sv.data()),
+      bsr_cur((const unsigned char*)sv.data()),
+      bsr_end((const unsigned char*)sv.data()+sv.size()) {};
+  bool at_end(void) const
+  {
+    return bsr_cur >= bsr_end;
+  };
+  size_t offset(void) const
+  {
+    return bsr_cur - bsr_start;
+  };
+  unsigned char byte(void)
+  {
+    if (RPS_UNLIKELY(bsr_cur >= bsr_end))
+      overflow();
+    return *bsr_cur++;
+  };
+  uint64_t varint(void)
+  {
+    uint64_t r = 0;
+    for (unsigned sh = 0; sh < 64; sh += 7)
+      {
+        unsigned char b = byte();
+        r |= (uint64_t)(b & 0x7f) << sh;
+        if (!(b & 0x80))
+          return r;
+      }
+    overflow();
+  };
+  int64_t zigzag(void)
+  {
+    uint64_t u = varint();
+    return (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+  };
+  uint64_t fixed64(void)
+  {
+    if (RPS_UNLIKELY(bsr_end - bsr_cur < 8))
+      overflow();
+    uint64_t r = 0;
+    for (int i=7; i>=0; i--)
+      r = (r << 8) | bsr_cur[i];
+    bsr_cur += 8;
+    return r;
+  };
+  double float64(void)
+  {
+    uint64_t u = fixed64();
+    double d = 0.0;
+    memcpy(&d, &u, sizeof(d));
+    return d;
+  };
+  std::string_view bytes(size_t len)
+  {
+    if (RPS_UNLIKELY((size_t)(bsr_end - bsr_cur) < len))
+      overflow();
+    std::string_view sv((const char*)bsr_cur, len);
+    bsr_cur += len;
+    return sv;
+  };
+};                              // end class Rps_BinStoreReader
+
+class Rps_BinStoreSpace
+{
+  std::string bss_path;
+  std::vector<std::string_view> bss_strings;
+  std::vector<Rps_Id> bss_oids;
+  std::string_view bss_prolog;
+  std::vector<std::string_view> bss_records;
+  uint64_t bss_jsonsize;
+  int64_t bss_jsonmtime;
+public:
+  /// value tags in records
+  enum value_tag_en
+  {
+    bstag_null,
+    bstag_int,
+    bstag_real,
+    bstag_string,
+    bstag_objref,
+    bstag_set,
+    bstag_tuple,
+    bstag_closure,
+    bstag_json,
+  };
+  /// tags of generic JSON values, following bstag_json
+  enum json_tag_en
+  {
+    bsjson_null = 16,
+    bsjson_false,
+    bsjson_true,
+    bsjson_int,
+    bsjson_uint,
+    bsjson_real,
+    bsjson_string,
+    bsjson_array,
+    bsjson_object,
+  };
+  /// kinds of object records
+  enum record_kind_en
+  {
+    bsrec_object,
+    bsrec_text,
+  };
+  /// check the header and checksum of the DATA of a binary space
+  /// file and index its pools and records, which stay inside DATA;
+  /// throws on corrupted data
+  Rps_BinStoreSpace(const std::string&path, std::string_view data);
+  /// the size and modification time, in nanoseconds, of the JSON
+  /// space file of the snapshot
+  uint64_t json_size(void) const
+  {
+    return bss_jsonsize;
+  };
+  int64_t json_mtime(void) const
+  {
+    return bss_jsonmtime;
+  };
+  const std::string& path(void) const
+  {
+    return bss_path;
+  };
+  std::string_view prolog(void) const
+  {
+    return bss_prolog;
+  };
+  unsigned nb_records(void) const
+  {
+    return bss_records.size();
+  };
+  std::string_view record(unsigned ix) const
+  {
+    return bss_records.at(ix);
+  };
+  std::string_view string_at(uint64_t ix) const
+  {
+    if (RPS_UNLIKELY(ix >= bss_strings.size()))
+      throw std::runtime_error("bad string index in binary space " + bss_path);
+    return bss_strings[ix];
+  };
+  Rps_Id oid_at(uint64_t ix) const
+  {
+    if (RPS_UNLIKELY(ix >= bss_oids.size()))
+      throw std::runtime_error("bad oid index in binary space " + bss_path);
+    return bss_oids[ix];
+  };
+  /// read the record kind, oid and line number starting a record
+  record_kind_en record_start(Rps_BinStoreReader&rd, Rps_Id&oid, unsigned&lineno) const;
+  /// read a generic JSON value, after its bstag_json
+  Json::Value read_json(Rps_BinStoreReader&rd) const;
+  /// read a tagged value as the JSON it was converted from
+  Json::Value read_value_json(Rps_BinStoreReader&rd) const;
+  /// skip a generic JSON value or a tagged value, e.g. to reach the
+  /// extra members of a record without decoding its contents
+  void skip_json(Rps_BinStoreReader&rd) const;
+  void skip_value(Rps_BinStoreReader&rd) const;
+  /// the JSON text of the object record at index IX
+  std::string object_text(unsigned ix) const;
+  /// is the snapshot up to date with its JSON space file at JSONPATH?
+  bool is_fresh_for(const std::string&jsonpath) const;
+};                              // end class Rps_BinStoreSpace
+
+/// converters between JSON and binary space files, giving false and
+/// an explanation in *PERR on failure; the output is written thru a
+/// temporary file then renamed. An existing JSON space file which
+/// changed since the snapshot is not overwritten unless FORCE.
+extern "C" bool rps_binstore_convert_json_to_binary(const std::string&jsonpath,
+    const std::string&binpath,
+    std::string*perr=nullptr);
+extern "C" bool rps_binstore_convert_binary_to_json(const std::string&binpath,
+    const std::string&jsonpath,
+    std::string*perr=nullptr,
+    bool force=false);
+/// convert every space file of a persistore/ directory, giving the
+/// number of failures
+extern "C" int rps_binstore_convert_directory(const std::string&dirpath,
+    bool tobinary, bool force=false);
+/// the --convert-store=to-binary|to-json|force-to-json option, or null
+extern "C" const char* rps_convert_store;
+
 extern "C" void rps_print_types_info (void);
 
 extern "C" void rps_repl_lexer_test(void);
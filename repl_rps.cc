@@ -648,7 +648,7 @@ Rps_LexTokenZone::val_output(std::ostream&out, unsigned depth, unsigned maxdepth
             }
           else if (vname.is_string())
             {
-              out << "°named" << Rps_QuotedC_String(vname.to_string()->cppstring());
+              out << "°named" << Rps_QuotedC_String(vname.as_cppstring());
             }
         }
     }
@@ -1021,7 +1021,12 @@ rps_repl_builtin_gc_command(Rps_CallFrame*callframe, Rps_ObjectRef obenvarg, con
     for (Rps_CallFrame* cf = &_; cf != nullptr; cf = cf->previous_call_frame())
       cf->gc_mark_frame(gc);
   };
+  double startreal = rps_elapsed_real_time();
+  double startcpu = rps_process_cpu_time();
   rps_garbage_collect(&markall);
+  /// this line is parsed by tools/bench-synthetic-store.py
+  RPS_INFORMOUT("garbage collection pause: " << (rps_elapsed_real_time() - startreal)
+                << " real, " << (rps_process_cpu_time() - startcpu) << " cpu seconds");
 } // end rps_repl_builtin_gc_command
 
 
@@ -1832,7 +1837,7 @@ rps_do_one_repl_command(Rps_CallFrame*callframe, Rps_ObjectRef obenvarg,
                     << " curcptr:" << Rps_QuotedC_String(intoksrc.curcptr())
                     << " token_deq:" << intoksrc.token_dequeue());
       if (_f.lexval.is_string())
-        _f.cmdob = Rps_PayloadSymbol::find_named_object(_f.lexval.as_string()->cppstring());
+        _f.cmdob = Rps_PayloadSymbol::find_named_object(_f.lexval.as_cppstring());
       RPS_POSSIBLE_BREAKPOINT();
 #warning unimplemented symbol token rps_do_one_repl_command
       RPS_WARNOUT("unimplemented symbol token rps_do_one_repl_command"
@@ -67,6 +67,10 @@ const char rps_scalar_baseid[]= RPS_BASEID;
  * This u8_mbtouc function fails if an invalid sequence of units is
  * encountered at the beginning of s, or if additional units (after
  * the n provided units) would be needed to form a character.
+ *
+ * The ASCII fast path inside the loop gives exactly the same hash
+ * values, it just avoids calling u8_mbtouc on plain ASCII bytes; so
+ * the copy in jsonrpsfltk.cc does not need to be updated.
  **/
 int
 rps_compute_cstr_two_64bits_hash(int64_t ht[2], const char*cstr, int len)
@@ -84,6 +88,30 @@ rps_compute_cstr_two_64bits_hash(int64_t ht[2], const char*cstr, int len)
   int utf8cnt = 0;
   for (const char*pc = cstr; pc < end; )
     {
+      /* ASCII fast path: when the next eight bytes are all ASCII and
+         are not the last ones, mix them as two rounds of four
+         characters, exactly like the general loop below would do, but
+         without calling u8_mbtouc. So the hash values are unchanged. */
+      while (end - pc > 8)
+        {
+          uint64_t w8 = 0;
+          memcpy(&w8, pc, sizeof(w8));
+          if (w8 & UINT64_C(0x8080808080808080))
+            break;
+          const uint8_t*pu = (const uint8_t*)pc;
+          for (int r=0; r<2; r++, pu += 4)
+            {
+              utf8cnt ++;
+              h0 = (h0 * 60869) ^ (pu[0] * 5059 + (h1 & 0xff));
+              h1 = (h1 * 53087) ^ (pu[1] * 43063 + utf8cnt + (h0 & 0xff));
+              utf8cnt ++;
+              h1 = (h1 * 73063) ^ (pu[2] * 53089 + (h0 & 0xff));
+              utf8cnt ++;
+              h0 = (h0 * 73019) ^ (pu[3] * 23057 + 11 * (h1 & 0x1ff));
+              utf8cnt ++;
+            };
+          pc += 8;
+        };
       ucs4_t uc1=0, uc2=0, uc3=0, uc4=0;
       int l1 = u8_mbtouc(&uc1, (const uint8_t*)pc, end - pc);
       if (l1<0)
@@ -124,16 +152,84 @@ rps_compute_cstr_two_64bits_hash(int64_t ht[2], const char*cstr, int len)
 } // end of rps_compute_cstr_two_64bits_hash
 
 
+/* A faster replacement of u8_check from GNU libunistring: return
+   nullptr if the LEN bytes starting at S are valid UTF-8, or else the
+   pointer to the first invalid byte sequence.  ASCII bytes are
+   skipped eight at a time.  Like u8_check, overlong encodings,
+   surrogates and code points above U+10FFFF are rejected. */
+const char*
+rps_utf8_check(const char*s, size_t len)
+{
+  if (!s)
+    return nullptr;
+  const uint8_t*pu = (const uint8_t*)s;
+  const uint8_t*end = pu + len;
+  while (pu < end)
+    {
+      while (end - pu >= 8)
+        {
+          uint64_t w8 = 0;
+          memcpy(&w8, pu, sizeof(w8));
+          if (w8 & UINT64_C(0x8080808080808080))
+            break;
+          pu += 8;
+        };
+      if (pu >= end)
+        break;
+      uint8_t c = *pu;
+      if (c < 0x80)
+        {
+          pu++;
+          continue;
+        };
+      if (c >= 0xc2 && c <= 0xdf)
+        {
+          if (end - pu < 2 || (pu[1] & 0xc0) != 0x80)
+            return (const char*)pu;
+          pu += 2;
+        }
+      else if (c >= 0xe0 && c <= 0xef)
+        {
+          if (end - pu < 3
+              || (pu[1] & 0xc0) != 0x80 || (pu[2] & 0xc0) != 0x80
+              || (c == 0xe0 && pu[1] < 0xa0)  // overlong
+              || (c == 0xed && pu[1] >= 0xa0)) // surrogate
+            return (const char*)pu;
+          pu += 3;
+        }
+      else if (c >= 0xf0 && c <= 0xf4)
+        {
+          if (end - pu < 4
+              || (pu[1] & 0xc0) != 0x80 || (pu[2] & 0xc0) != 0x80
+              || (pu[3] & 0xc0) != 0x80
+              || (c == 0xf0 && pu[1] < 0x90)  // overlong
+              || (c == 0xf4 && pu[1] >= 0x90)) // above U+10FFFF
+            return (const char*)pu;
+          pu += 4;
+        }
+      else
+        return (const char*)pu;
+    };
+  return nullptr;
+} // end rps_utf8_check
+
+
 const Rps_String*
 Rps_String::make(const char*cstr, int len)
 {
   cstr = normalize_cstr(cstr);
   len = normalize_len(cstr, len);
-  if (u8_check(reinterpret_cast<const uint8_t*>(cstr), len))
+  if (rps_utf8_check(cstr, len))
     throw std::domain_error("invalid UTF-8 string");
+  if (Rps_InternTable::enabled())
+    {
+      const Rps_String*oldstr = Rps_InternTable::find_string(cstr, len);
+      if (oldstr)
+        return oldstr;
+    };
   Rps_String* str
     = rps_allocate_with_wordgap<Rps_String> (len/sizeof(void*)+1, cstr, len);
-  return str;
+  return Rps_InternTable::intern_value<Rps_String>(str);
 } // end of Rps_String::make
 
 
@@ -141,15 +237,21 @@ Json::Value
 Rps_String::dump_json(Rps_Dumper*du) const
 {
   RPS_ASSERT(du != nullptr);
-  if (cstr()[0] == '_')
+  return dump_json_cstr(cstr());
+} // end Rps_String::dump_json
+
+Json::Value
+Rps_String::dump_json_cstr(const char*cstr)
+{
+  if (cstr[0] == '_')
     {
       Json::Value vmap(Json::objectValue);
-      vmap["str"] = cstr();
+      vmap["str"] = cstr;
       return vmap;
     }
   else
-    return Json::Value(cstr());
-} // end Rps_String::dump_json
+    return Json::Value(cstr);
+} // end Rps_String::dump_json_cstr
 
 void
 Rps_String::val_output(std::ostream&out, unsigned depth, unsigned maxdepth) const
@@ -178,7 +280,12 @@ Rps_Double::val_output(std::ostream&out, unsigned depth,
       out << "??";
       return;
     }
-  double d = dval();
+  output_double(out, dval());
+} // end Rps_Double::val_output
+
+void
+Rps_Double::output_double(std::ostream&out, double d)
+{
   char buf[40];
   memset(buf, 0, sizeof(buf));
   snprintf(buf, sizeof(buf)-1, "%g", d);
@@ -193,7 +300,7 @@ Rps_Double::val_output(std::ostream&out, unsigned depth,
       RPS_ASSERT(strchr(buf, '.'));
       out << buf;
     }
-} // end Rps_Double::val_output
+} // end Rps_Double::output_double
 
 
 Rps_ObjectRef
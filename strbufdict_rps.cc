@@ -52,7 +52,8 @@ const char rps_strbufdict_baseid[]= RPS_BASEID;
 
 Rps_PayloadStrBuf::Rps_PayloadStrBuf(Rps_ObjectZone*obz)
   : Rps_Payload(Rps_Type::PaylStrBuf, obz),
-    strbuf_buffer(),
+    strbuf_chunks(),
+    strbuf_size(0),
     strbuf_indent(0),
     strbuf_transient(false)
 {
@@ -75,7 +76,12 @@ Rps_PayloadStrBuf::append_string(const std::string&str)
   if (str.empty())
     return;
   std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
-  strbuf_buffer.sputn(str.c_str(), str.size());
+  if (!strbuf_chunks.empty()
+      && strbuf_chunks.back().size() + str.size() < strbuf_small_chunk)
+    strbuf_chunks.back().append(str);
+  else
+    strbuf_chunks.push_back(str);
+  strbuf_size += str.size();
 } // end Rps_PayloadStrBuf::append_string
 
 void
@@ -84,21 +90,126 @@ Rps_PayloadStrBuf::prepend_string(const std::string&str)
   if (str.empty())
     return;
   std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
-#warning Rps_PayloadStrBuf::prepend_string implementation is inefficient
-  if (strbuf_buffer.str().empty())
+  if (!strbuf_chunks.empty()
+      && strbuf_chunks.front().size() + str.size() < strbuf_small_chunk)
+    strbuf_chunks.front().insert(0, str);
+  else
+    strbuf_chunks.push_front(str);
+  strbuf_size += str.size();
+} // end Rps_PayloadStrBuf::prepend_string
+
+void
+Rps_PayloadStrBuf::insert_string(size_t off, const std::string&str)
+{
+  if (str.empty())
+    return;
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  if (off == 0)
     {
-      strbuf_buffer.sputn(str.c_str(), str.size());
+      prepend_string(str);
       return;
-    }
-  else
+    };
+  if (off >= strbuf_size)
     {
-      /// inefficient; TODO: improve
-      std::string oldcont = strbuf_buffer.str();
-      std::string newcont = str + oldcont;
-      strbuf_buffer.sputn(newcont.c_str(), newcont.size());
+      append_string(str);
       return;
+    };
+  auto it = strbuf_chunks.begin();
+  while (off > it->size())
+    {
+      off -= it->size();
+      it++;
+    };
+  RPS_ASSERT(it != strbuf_chunks.end());
+  if (it->size() + str.size() < strbuf_small_chunk)
+    it->insert(off, str);
+  else if (off == it->size())
+    strbuf_chunks.insert(it+1, str);
+  else
+    {
+      /// split the chunk in two, and put STR between them
+      std::string tail = it->substr(off);
+      it->resize(off);
+      auto nextit = strbuf_chunks.insert(it+1, str);
+      strbuf_chunks.insert(nextit+1, std::move(tail));
     }
-} // end Rps_PayloadStrBuf::prepend_string
+  strbuf_size += str.size();
+} // end Rps_PayloadStrBuf::insert_string
+
+std::string
+Rps_PayloadStrBuf::buffer_cppstring(void) const
+{
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  std::string res;
+  res.reserve(strbuf_size);
+  for (const std::string&chunk: strbuf_chunks)
+    res.append(chunk);
+  return res;
+} // end Rps_PayloadStrBuf::buffer_cppstring
+
+void
+Rps_PayloadStrBuf::output_buffer(std::ostream&out) const
+{
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  for (const std::string&chunk: strbuf_chunks)
+    out.write(chunk.data(), chunk.size());
+} // end Rps_PayloadStrBuf::output_buffer
+
+ssize_t
+Rps_PayloadStrBuf::write_buffer_to_fd(int fd) const
+{
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  constexpr int maxiov = 64;
+  struct iovec iovarr[maxiov];
+  ssize_t total = 0;
+  auto it = strbuf_chunks.begin();
+  size_t skip = 0; // bytes already written in *it
+  while (it != strbuf_chunks.end())
+    {
+      int nbiov = 0;
+      size_t want = 0;
+      auto curit = it;
+      size_t curskip = skip;
+      while (curit != strbuf_chunks.end() && nbiov < maxiov)
+        {
+          if (curit->size() > curskip)
+            {
+              iovarr[nbiov].iov_base = const_cast<char*>(curit->data()) + curskip;
+              iovarr[nbiov].iov_len = curit->size() - curskip;
+              want += iovarr[nbiov].iov_len;
+              nbiov++;
+            };
+          curskip = 0;
+          curit++;
+        };
+      if (nbiov == 0)
+        break;
+      ssize_t wcnt = writev(fd, iovarr, nbiov);
+      if (wcnt < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return -1;
+        }
+      else if (wcnt == 0)
+        {
+          /// no progress, e.g. on a full non-blocking pipe; don't loop forever
+          errno = EIO;
+          return -1;
+        };
+      total += wcnt;
+      /// advance thru the written bytes, handling partial writes
+      size_t done = (size_t)wcnt + skip;
+      while (it != strbuf_chunks.end() && done >= it->size())
+        {
+          done -= it->size();
+          it++;
+        };
+      skip = done;
+      RPS_ASSERT((size_t)wcnt <= want);
+    };
+  return total;
+} // end Rps_PayloadStrBuf::write_buffer_to_fd
 
 void
 Rps_PayloadStrBuf::dump_scan(Rps_Dumper*du) const
@@ -142,7 +253,7 @@ Rps_PayloadStrBuf::dump_json_content(Rps_Dumper*du, Json::Value&jv) const
   RPS_ASSERT(jv.type() == Json::objectValue);
   if (strbuf_transient)
     return;
-  const std::string&str = strbuf_buffer.str();
+  const std::string str = buffer_cppstring();
   auto eol = str.find('\n');
   if (eol > 0)
     {
@@ -212,7 +323,9 @@ void
 Rps_PayloadStrBuf::clear_buffer()
 {
 /// clear the buffer
-  strbuf_buffer = std::stringbuf("");
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  strbuf_chunks.clear();
+  strbuf_size = 0;
 } // end Rps_PayloadStrBuf::clear_buffer
 
 void
@@ -229,12 +342,12 @@ Rps_PayloadStrBuf::output_payload(std::ostream&out,
   const char* BOLD_esc = (ontty?RPS_TERMINAL_BOLD_ESCAPE:"");
   const char* NORM_esc = (ontty?RPS_TERMINAL_NORMAL_ESCAPE:"");
   std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
-  const std::string&str = strbuf_buffer.str();
   out << std::endl << BOLD_esc << "*C++ stringbuffer payload"
-      << NORM_esc << " of " << str.size() << " bytes." << std::endl;
+      << NORM_esc << " of " << strbuf_size << " bytes in "
+      << strbuf_chunks.size() << " chunks." << std::endl;
   if (depth > 1)
     return;
-  out << "… " << Rps_QuotedC_String(str) << std::endl;
+  out << "… " << Rps_QuotedC_String(buffer_cppstring()) << std::endl;
 } // end Rps_PayloadStrBuf::output_payload
 
 
@@ -245,7 +358,12 @@ Rps_PayloadStrBuf::output_payload(std::ostream&out,
 
 Rps_PayloadStringDict::Rps_PayloadStringDict(Rps_ObjectZone*obz)
   : Rps_Payload(Rps_Type::PaylStringDict, obz),
-    dict_map(),
+    dict_entries(),
+    dict_index(dict_minindexsize, dict_emptyslot),
+    dict_count(0),
+    dict_iterating(0),
+    dict_sorted(),
+    dict_sorted_valid(true),
     dict_is_transient(false)
 {
 } // end PayloadStringDict::Rps_PayloadStringDict
@@ -253,16 +371,20 @@ Rps_PayloadStringDict::Rps_PayloadStringDict(Rps_ObjectZone*obz)
 
 Rps_PayloadStringDict::~Rps_PayloadStringDict()
 {
-  dict_map.clear();
+  dict_entries.clear();
+  dict_index.clear();
+  dict_sorted.clear();
+  dict_count = 0;
   dict_is_transient = false;
 } // end Rps_PayloadStringDict::~Rps_PayloadStringDict
 
 void
 Rps_PayloadStringDict::gc_mark(Rps_GarbageCollector&gc) const
 {
-  for (auto it : dict_map)
+  for (auto& ent : dict_entries)
     {
-      it.second.gc_mark(gc);
+      if (ent.de_val)
+        ent.de_val.gc_mark(gc);
     }
 } // end Rps_PayloadStringDict::gc_mark
 
@@ -272,9 +394,10 @@ Rps_PayloadStringDict::dump_scan(Rps_Dumper*du) const
   RPS_ASSERT(du != nullptr);
   if (dict_is_transient)
     return;
-  for (auto it : dict_map)
+  for (auto& ent : dict_entries)
     {
-      rps_dump_scan_value(du,it.second,0);
+      if (ent.de_val)
+        rps_dump_scan_value(du,ent.de_val,0);
     }
 } // end Rps_PayloadStringDict::dump_scan
 
@@ -287,13 +410,14 @@ Rps_PayloadStringDict::dump_json_content(Rps_Dumper*du, Json::Value&jv) const
   if (dict_is_transient)
     return;
   Json::Value jarr(Json::arrayValue);
-  for (auto it : dict_map)
+  for (unsigned entix : sorted_entries())
     {
-      if (!rps_is_dumpable_value(du,it.second))
+      const dict_entry_st& ent = dict_entries[entix];
+      if (!rps_is_dumpable_value(du,ent.de_val))
         continue;
-      Json::Value jcur = rps_dump_json_value(du, it.second);
+      Json::Value jcur = rps_dump_json_value(du, ent.de_val);
       Json::Value jent(Json::objectValue);
-      jent["str"] = it.first;
+      jent["str"] = ent.de_str;
       jent["val"] = jcur;
       jarr.append(jent);
     }
@@ -323,6 +447,8 @@ rpsldpy_string_dictionary(Rps_ObjectZone*obz, Rps_Loader*ld, const Json::Value&
     }
   auto payldict = obz->put_new_plain_payload<Rps_PayloadStringDict>();
   Json::Value jarr = jv["dictionary"];
+  if (jarr.isArray() && jarr.size() > Rps_PayloadStringDict::dict_minindexsize/2)
+    payldict->reorganize(jarr.size());
   if (!jarr.isArray())
     RPS_FATALOUT("rpsldpy_string_dictionary: object " << obz->oid()
                  << " in space " << spacid << " lineno#" << lineno
@@ -344,23 +470,97 @@ rpsldpy_string_dictionary(Rps_ObjectZone*obz, Rps_Loader*ld, const Json::Value&
     }
 } // end rpsldpy_string_dictionary
 
+/// give the position in dict_index of the entry for STR of hash H,
+/// or else the negated position plus one of the empty slot ending
+/// the probe
+int
+Rps_PayloadStringDict::find_index_slot(const std::string&str, Rps_HashInt h) const
+{
+  unsigned mask = dict_index.size() - 1;
+  RPS_ASSERT((dict_index.size() & mask) == 0);
+  for (unsigned pos = h & mask; ; pos = (pos+1) & mask)
+    {
+      int32_t entix = dict_index[pos];
+      if (entix == dict_emptyslot)
+        return -(int)pos - 1;
+      if (entix == dict_removedslot)
+        continue;
+      const dict_entry_st& ent = dict_entries[entix];
+      if (ent.de_hash == h && ent.de_str == str)
+        return (int)pos;
+    }
+} // end Rps_PayloadStringDict::find_index_slot
+
+
+/// rebuild the index with room for at least MINSIZE entries, and
+/// compact the removed entries unless some iteration is running
+void
+Rps_PayloadStringDict::reorganize(unsigned minsize)
+{
+  if (dict_iterating == 0 && dict_count < dict_entries.size())
+    {
+      std::vector<dict_entry_st> oldentries;
+      oldentries.swap(dict_entries);
+      dict_entries.reserve(dict_count + dict_count/4 + 4);
+      for (auto& ent: oldentries)
+        if (ent.de_val)
+          dict_entries.push_back(std::move(ent));
+      RPS_ASSERT(dict_entries.size() == dict_count);
+      dict_sorted_valid = false;
+    };
+  if (minsize < dict_entries.size())
+    minsize = dict_entries.size();
+  unsigned newsize = dict_minindexsize;
+  while (newsize < 2*minsize+1)
+    newsize *= 2;
+  dict_index.assign(newsize, dict_emptyslot);
+  unsigned mask = newsize - 1;
+  for (unsigned entix=0; entix<dict_entries.size(); entix++)
+    {
+      const dict_entry_st& ent = dict_entries[entix];
+      unsigned pos = ent.de_hash & mask;
+      while (dict_index[pos] != dict_emptyslot)
+        pos = (pos+1) & mask;
+      /// removed entries still get a slot, keeping one slot per entry
+      dict_index[pos] = ent.de_val?(int32_t)entix:dict_removedslot;
+    }
+} // end Rps_PayloadStringDict::reorganize
+
+
 void
 Rps_PayloadStringDict::add(const std::string&str, Rps_Value val)
 {
-  if (!str.empty() && !val.is_empty())
-    dict_map.insert({str,val});
-  else if (!str.empty() && !val)
-    dict_map.erase(str);
+  if (str.empty())
+    return;
+  if (!val)
+    {
+      remove(str);
+      return;
+    };
+  Rps_HashInt h = dict_hash(str);
+  int pos = find_index_slot(str, h);
+  if (pos >= 0) // like std::map::insert, keep the previous value
+    return;
+  if (2*(dict_entries.size()+1) > dict_index.size())
+    {
+      reorganize(dict_count+1);
+      pos = find_index_slot(str, h);
+      RPS_ASSERT(pos < 0);
+    };
+  dict_index[-pos-1] = (int32_t)dict_entries.size();
+  dict_entries.push_back(dict_entry_st{str, val, h});
+  dict_count++;
+  dict_sorted_valid = false;
 } // end Rps_PayloadStringDict::add
 
 Rps_Value
 Rps_PayloadStringDict::find(const std::string&str) const
 {
-  if (!str.empty())
+  if (!str.empty() && dict_count > 0)
     {
-      auto it = dict_map.find(str);
-      if (it != dict_map.end())
-        return it->second;
+      int pos = find_index_slot(str, dict_hash(str));
+      if (pos >= 0)
+        return dict_entries[dict_index[pos]].de_val;
     }
   return nullptr;
 } // end Rps_PayloadStringDict::find
@@ -368,7 +568,17 @@ Rps_PayloadStringDict::find(const std::string&str) const
 void
 Rps_PayloadStringDict::remove(const std::string&str)
 {
-  dict_map.erase(str);
+  if (str.empty() || dict_count == 0)
+    return;
+  int pos = find_index_slot(str, dict_hash(str));
+  if (pos < 0)
+    return;
+  dict_entry_st& ent = dict_entries[dict_index[pos]];
+  dict_index[pos] = dict_removedslot;
+  ent.de_val = nullptr;
+  ent.de_str.clear();
+  dict_count--;
+  dict_sorted_valid = false;
 } // end Rps_PayloadStringDict::remove
 
 void
@@ -377,15 +587,56 @@ Rps_PayloadStringDict::set_transient(bool transient)
   dict_is_transient = transient;
 } // end PayloadStringDict::set_transient
 
+const std::vector<unsigned>&
+Rps_PayloadStringDict::sorted_entries(void) const
+{
+  /// the cache is rebuilt by readers, so under the owner's lock like
+  /// every change invalidating it
+  std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+  if (!dict_sorted_valid)
+    {
+      dict_sorted.clear();
+      dict_sorted.reserve(dict_count);
+      for (unsigned entix=0; entix<dict_entries.size(); entix++)
+        if (dict_entries[entix].de_val)
+          dict_sorted.push_back(entix);
+      std::sort(dict_sorted.begin(), dict_sorted.end(),
+                [this](unsigned leftix, unsigned rightix)
+      {
+        return dict_entries[leftix].de_str < dict_entries[rightix].de_str;
+      });
+      dict_sorted_valid = true;
+    };
+  return dict_sorted;
+} // end Rps_PayloadStringDict::sorted_entries
+
+unsigned
+Rps_PayloadStringDict::sorted_lower_bound(const std::string&str) const
+{
+  const std::vector<unsigned>& sortvec = sorted_entries();
+  auto it = std::lower_bound(sortvec.begin(), sortvec.end(), str,
+                             [this](unsigned entix, const std::string&s)
+  {
+    return dict_entries[entix].de_str < s;
+  });
+  return it - sortvec.begin();
+} // end Rps_PayloadStringDict::sorted_lower_bound
+
 void
 Rps_PayloadStringDict::iterate_with_callframe(Rps_CallFrame*callerframe, const std::function <bool(Rps_CallFrame*,const std::string&,const Rps_Value)>& stopfun)
 {
   RPS_ASSERT(callerframe == nullptr || callerframe->is_good_call_frame());
   RPS_ASSERT(stopfun);
-  for (auto it : dict_map)
+  /// the callback might add or remove entries, so iterate on a copy
+  std::vector<unsigned> sortvec = sorted_entries();
+  iterating_guard itguard(this);
+  for (unsigned entix : sortvec)
     {
-      if (stopfun(callerframe, it.first, it.second))
-        return;
+      if (!dict_entries[entix].de_val)
+        continue;
+      std::string curstr = dict_entries[entix].de_str;
+      if (stopfun(callerframe, curstr, dict_entries[entix].de_val))
+        break;
     }
 } // end Rps_PayloadStringDict::iterate_with_callframe
 
@@ -393,12 +644,63 @@ void
 Rps_PayloadStringDict::iterate_with_data(void*data, const std::function <bool(void*,const std::string&,const Rps_Value)>& stopfun)
 {
   RPS_ASSERT(stopfun);
-  for (auto it : dict_map)
+  std::vector<unsigned> sortvec = sorted_entries();
+  iterating_guard itguard(this);
+  for (unsigned entix : sortvec)
     {
-      if (stopfun(data, it.first, it.second))
-        return;
+      if (!dict_entries[entix].de_val)
+        continue;
+      std::string curstr = dict_entries[entix].de_str;
+      if (stopfun(data, curstr, dict_entries[entix].de_val))
+        break;
     }
-} // end Rps_PayloadStringDict::iterate_with_callframe
+} // end Rps_PayloadStringDict::iterate_with_data
+
+void
+Rps_PayloadStringDict::iterate_prefixed(const std::string&prefix, void*data,
+                                        const std::function <bool(void*,const std::string&,const Rps_Value)>& stopfun)
+{
+  RPS_ASSERT(stopfun);
+  std::vector<unsigned> sortvec;
+  {
+    std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+    unsigned startpos = sorted_lower_bound(prefix);
+    for (unsigned sx=startpos; sx<dict_sorted.size(); sx++)
+      {
+        unsigned entix = dict_sorted[sx];
+        if (dict_entries[entix].de_str.compare(0, prefix.size(), prefix) != 0)
+          break;
+        sortvec.push_back(entix);
+      };
+  }
+  iterating_guard itguard(this);
+  for (unsigned entix : sortvec)
+    {
+      if (!dict_entries[entix].de_val)
+        continue;
+      std::string curstr = dict_entries[entix].de_str;
+      if (stopfun(data, curstr, dict_entries[entix].de_val))
+        break;
+    }
+} // end Rps_PayloadStringDict::iterate_prefixed
+
+std::vector<std::string>
+Rps_PayloadStringDict::prefixed_strings(const std::string&prefix, unsigned maxcount) const
+{
+  std::vector<std::string> vecstr;
+  std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+  unsigned startpos = sorted_lower_bound(prefix);
+  for (unsigned sx=startpos; sx<dict_sorted.size(); sx++)
+    {
+      const std::string& curstr = dict_entries[dict_sorted[sx]].de_str;
+      if (curstr.compare(0, prefix.size(), prefix) != 0)
+        break;
+      if (maxcount > 0 && vecstr.size() >= maxcount)
+        break;
+      vecstr.push_back(curstr);
+    };
+  return vecstr;
+} // end Rps_PayloadStringDict::prefixed_strings
 
 void
 Rps_PayloadStringDict::iterate_apply(Rps_CallFrame*callerframe, Rps_Value closarg)
@@ -418,15 +720,19 @@ Rps_PayloadStringDict::iterate_apply(Rps_CallFrame*callerframe, Rps_Value closar
   if (!_f.obown)
     return;
   _f.closv = closarg;
-  for (auto it : dict_map)
+  std::vector<unsigned> sortvec = sorted_entries();
+  iterating_guard itguard(this);
+  for (unsigned entix : sortvec)
     {
-      _f.curstrv = Rps_StringValue(it.first);
-      _f.curval = it.second;
+      if (!dict_entries[entix].de_val)
+        continue;
+      _f.curstrv = Rps_StringValue(dict_entries[entix].de_str);
+      _f.curval = dict_entries[entix].de_val;
       Rps_TwoValues pair =
         Rps_ClosureValue(_f.closv).apply3(&_, _f.obown, _f.curstrv,
                                           _f.curval);
       if (!pair)
-        return;
+        break;
       _f.curstrv = nullptr;
       _f.curval = nullptr;
     }
@@ -491,12 +797,12 @@ Rps_PayloadStringDict::output_payload(std::ostream&out, unsigned depth,
   std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
   out << std::endl << BOLD_esc << "**"
       << (dict_is_transient?" transient":"")
-      << " string dictionary payload of " << dict_map.size()
+      << " string dictionary payload of " << dict_count
       << " entries **" << NORM_esc;
-  for (auto it: dict_map)
+  for (unsigned entix : sorted_entries())
     {
-      const std::string &nam = it.first;
-      Rps_Value v = it.second;
+      const std::string &nam = dict_entries[entix].de_str;
+      Rps_Value v = dict_entries[entix].de_val;
       RPS_ASSERT(!nam.empty());
       RPS_ASSERT(v);
       out << "*:" << Rps_QuotedC_String(nam) << ":";
@@ -0,0 +1,167 @@
+#!/usr/bin/python3
+# file RefPerSys/tools/bench-synthetic-store.py
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Author(s):
+#      Basile Starynkevitch <basile@starynkevitch.net>
+#      © Copyright 2026 The Reflective Persistent System Team
+#      team@refpersys.org & http://refpersys.org/
+#
+# License:
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This Python script is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+## Benchmark ./refpersys on synthetic stores made by
+## tools/generate-synthetic-store.py: for each size the store is
+## generated once into _synthetic/store-SIZE, then loaded, garbage
+## collected with the !gc command and dumped, several times. The load
+## time comes from --load-profile, the dump time and the garbage
+## collection pause from the messages of refpersys, the peak resident
+## set size from wait4. For example
+##
+##   tools/bench-synthetic-store.py --sizes 10000,1000000 --repeat 3 \
+##       --csv bench-store.csv -- --jobs 4
+##
+## The arguments after -- are passed to every refpersys run.
+
+import argparse
+import json
+import os
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import time
+
+TOPDIR = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+
+DUMP_RE = re.compile(r"dump into .* completed in ([0-9.eE+-]+) wallclock")
+GC_RE = re.compile(r"garbage collection pause: ([0-9.eE+-]+) real")
+
+
+def generate_store(args, size):
+    storedir = os.path.join(args.workdir, "store-%d" % size)
+    if os.path.isfile(os.path.join(storedir, "rps_manifest.json")):
+        return storedir
+    nbspaces = max(4, size // 250000)
+    cmd = [sys.executable, os.path.join(TOPDIR, "tools", "generate-synthetic-store.py"),
+           "--objects", str(size), "--spaces", str(nbspaces),
+           "--seed", str(args.seed), "--output", storedir]
+    print("generating:", " ".join(cmd), flush=True)
+    subprocess.run(cmd, check=True)
+    return storedir
+
+
+def run_once(args, size, storedir, runix):
+    """run refpersys once on STOREDIR, giving a dict of measures"""
+    profpath = os.path.join(args.workdir, "load-profile-%d.json" % size)
+    dumpdir = os.path.join(args.workdir, "dump-%d" % size)
+    logpath = os.path.join(args.workdir, "run-%d-%d.log" % (size, runix))
+    shutil.rmtree(dumpdir, ignore_errors=True)
+    cmd = [args.refpersys, "--batch", "--load", storedir,
+           "--load-profile", profpath, "--command", "!gc",
+           "--dump", dumpdir, "--run-name", "bench-store-%d" % size] + args.extra
+    starttime = time.monotonic()
+    with open(logpath, "w") as logf:
+        proc = subprocess.Popen(cmd, stdout=logf, stderr=subprocess.STDOUT,
+                                cwd=TOPDIR)
+        _, status, rusage = os.wait4(proc.pid, 0)
+    walltime = time.monotonic() - starttime
+    if os.waitstatus_to_exitcode(status) != 0:
+        sys.exit("%s failed, see %s" % (" ".join(cmd), logpath))
+    with open(logpath, errors="replace") as logf:
+        log = logf.read()
+    with open(profpath) as proff:
+        profile = json.load(proff)
+    dumpm = DUMP_RE.search(log)
+    gcm = GC_RE.search(log)
+    if not args.keep:
+        shutil.rmtree(dumpdir, ignore_errors=True)
+    return {
+        "objects": profile["nbobjects"],
+        "bytes": profile["bytes"],
+        "load": profile["realtime"],
+        "dump": float(dumpm.group(1)) if dumpm else float("nan"),
+        "gc": float(gcm.group(1)) if gcm else float("nan"),
+        "rss_mb": rusage.ru_maxrss / 1024.0,
+        "wall": walltime,
+    }
+
+
+def git_short_id():
+    try:
+        return subprocess.run(["git", "rev-parse", "--short=12", "HEAD"], cwd=TOPDIR,
+                              capture_output=True, text=True, check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="benchmark loading, dumping and garbage collecting synthetic stores")
+    parser.add_argument("--sizes", default="10000,1000000,10000000",
+                        help="comma separated numbers of synthetic objects")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="number of runs per size, the median is reported")
+    parser.add_argument("--seed", type=int, default=1,
+                        help="random seed of the generated stores")
+    parser.add_argument("--refpersys", default=os.path.join(TOPDIR, "refpersys"),
+                        help="the refpersys executable")
+    parser.add_argument("--workdir", default=os.path.join(TOPDIR, "_synthetic"),
+                        help="directory of the generated stores and of the logs")
+    parser.add_argument("--csv", help="append the median measures to that CSV file")
+    parser.add_argument("--keep", action="store_true",
+                        help="keep the dumped stores")
+    parser.add_argument("--generate-only", action="store_true",
+                        help="only generate the missing stores")
+    parser.add_argument("extra", nargs="*",
+                        help="extra refpersys arguments, after --")
+    args = parser.parse_args()
+    sizes = [int(s) for s in args.sizes.split(",") if s]
+    args.workdir = os.path.realpath(args.workdir)
+    os.makedirs(args.workdir, exist_ok=True)
+    if args.generate_only:
+        for size in sizes:
+            generate_store(args, size)
+        return
+    if not os.access(args.refpersys, os.X_OK):
+        sys.exit("no executable " + args.refpersys + ", run make refpersys first")
+    gitid = git_short_id()
+    columns = ("objects", "bytes", "load", "dump", "gc", "rss_mb", "wall")
+    rows = []
+    for size in sizes:
+        storedir = generate_store(args, size)
+        runs = [run_once(args, size, storedir, runix) for runix in range(args.repeat)]
+        median = {col: statistics.median(run[col] for run in runs) for col in columns}
+        rows.append((size, median))
+        print("size %d: load %.3f s, dump %.3f s, gc pause %.3f s, peak rss %.1f Mb"
+              " (median of %d runs)" % (size, median["load"], median["dump"],
+                                         median["gc"], median["rss_mb"], args.repeat),
+              flush=True)
+    print("\n%10s %10s %12s %9s %9s %9s %10s %9s" % (("size",) + columns))
+    for size, median in rows:
+        print("%10d %10d %12d %9.3f %9.3f %9.4f %10.1f %9.3f"
+              % ((size,) + tuple(median[col] for col in columns)))
+    if args.csv:
+        newfile = not os.path.exists(args.csv)
+        with open(args.csv, "a") as csvf:
+            if newfile:
+                csvf.write("date,git,extra,size," + ",".join(columns) + "\n")
+            for size, median in rows:
+                csvf.write("%s,%s,%s,%d,%s\n"
+                           % (time.strftime("%Y-%m-%d %H:%M"), gitid, " ".join(args.extra),
+                              size, ",".join("%g" % median[col] for col in columns)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,361 @@
+#!/usr/bin/python3
+# file RefPerSys/tools/generate-synthetic-store.py
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Author(s):
+#      Basile Starynkevitch <basile@starynkevitch.net>
+#      © Copyright 2026 The Reflective Persistent System Team
+#      team@refpersys.org & http://refpersys.org/
+#
+# License:
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This Python script is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+## Generate a synthetic but loadable RefPerSys persistent store, for
+## scaling benchmarks. The initial space of some existing store (by
+## default our own) is copied, and extra spaces are added with
+## synthetic objects, attributes, classes and payloads. The same
+## arguments and --seed give the very same store, so benchmark
+## numbers are reproducible. For example
+##
+##   tools/generate-synthetic-store.py --objects 1000000 --spaces 8 \
+##       --output _synthetic/store-1000000
+##   ./refpersys --batch --load _synthetic/store-1000000
+##
+## All the synthetic objects are reachable from the RefPerSys_system
+## root object, thru the components of the synthetic space objects,
+## so a garbage collection or a dump keeps them.
+
+import argparse
+import json
+import os
+import random
+import sys
+import time
+
+## should be in sync with class Rps_Id in RefPerSys/oid_rps.hh
+B62DIGITS = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+MIN_HI = 62*62*62
+MAX_HI = 10 * 62 * (62*62*62) * (62*62*62) * (62*62*62)
+NBDIGITS_HI = 11
+MIN_LO = 62*62
+MAX_LO = 62 * (62*62*62) * (62*62*62)
+NBDIGITS_LO = 7
+
+## a few well known objects of the initial space
+RPS_SYSTEM_OID = "_1Io89yIORqn02SXx4p"       # RefPerSys_system root
+RPS_OBJECT_CLASS_OID = "_5yhJGgxLwLp00X0xEQ" # object
+RPS_CLASS_CLASS_OID = "_41OFI3r0S1t03qdB2E"  # class
+RPS_SPACE_CLASS_OID = "_2i66FFjmS7n03HNNBx"  # space
+RPS_ATTRIBUTE_CLASS_OID = "_4pSwobFHGf301Qgwzh" # named_attribute
+
+PAYLOAD_KINDS = ("none", "vectob", "setob", "vectval", "objmap",
+                 "value_map", "string_buffer")
+DEFAULT_PAYLOAD_MIX = "none:60,vectob:8,setob:8,vectval:8,objmap:6,value_map:5,string_buffer:5"
+
+
+def oid_string(hi: int, lo: int) -> str:
+    """Python's variant of Rps_Id::to_cbuf24 in values_rps.cc"""
+    dighi = []
+    for _ in range(NBDIGITS_HI):
+        hi, d = divmod(hi, 62)
+        dighi.append(B62DIGITS[d])
+    diglo = []
+    for _ in range(NBDIGITS_LO):
+        lo, d = divmod(lo, 62)
+        diglo.append(B62DIGITS[d])
+    return "_" + "".join(reversed(dighi)) + "".join(reversed(diglo))
+
+
+def mix64(x: int) -> int:
+    """the splitmix64 finalizer, to spread the synthetic oids"""
+    x = (x + 0x9E3779B97F4A7C15) & 0xFFFFFFFFFFFFFFFF
+    x = ((x ^ (x >> 30)) * 0xBF58476D1CE4E5B9) & 0xFFFFFFFFFFFFFFFF
+    x = ((x ^ (x >> 27)) * 0x94D049BB133111EB) & 0xFFFFFFFFFFFFFFFF
+    return x ^ (x >> 31)
+
+
+class SyntheticStore:
+    """the numbering of the synthetic objects: first the space
+    objects, then the classes, then the attributes, then the plain
+    objects. The oid of the synthetic object of index k is computed,
+    never kept, with a distinct low part for each k."""
+
+    def __init__(self, args, knownoids):
+        self.args = args
+        self.knownoids = knownoids
+        self.nbspaces = args.spaces
+        self.nbclasses = args.class_depth * args.class_width
+        self.nbattrs = args.attributes_pool
+        self.nbobjects = args.objects
+        self.firstclass = self.nbspaces
+        self.firstattr = self.firstclass + self.nbclasses
+        self.firstobject = self.firstattr + self.nbattrs
+        self.total = self.firstobject + self.nbobjects
+        if MIN_LO + 1 + self.total >= MAX_LO:
+            raise ValueError("too many synthetic objects")
+        self.payloadmix = []
+        for item in args.payload_mix.split(","):
+            kind, _, weight = item.partition(":")
+            if kind not in PAYLOAD_KINDS:
+                raise ValueError("unknown payload kind " + kind
+                                 + ", expecting one of " + " ".join(PAYLOAD_KINDS))
+            self.payloadmix.append((kind, int(weight or "1")))
+
+    def oid(self, k: int) -> str:
+        perturb = 0
+        while True:
+            hi = MIN_HI + mix64((self.args.seed << 40) ^ (k + (perturb << 36))) % (MAX_HI - MIN_HI)
+            s = oid_string(hi, MIN_LO + 1 + k)
+            if s not in self.knownoids:
+                return s
+            perturb += 1
+
+    def leaf_class(self, rng) -> str:
+        if self.nbclasses == 0:
+            return RPS_OBJECT_CLASS_OID
+        lastlevel = self.firstclass + (self.args.class_depth-1) * self.args.class_width
+        return self.oid(lastlevel + rng.randrange(self.args.class_width))
+
+    def random_object(self, rng) -> str:
+        return self.oid(self.firstobject + rng.randrange(self.nbobjects))
+
+    def random_value(self, rng, depth=0):
+        ## instances of synthetic classes are drawn only when asked,
+        ## so that stores generated without --instances don't change
+        if self.args.instances > 0 and depth == 0 \
+           and rng.random() * 100.0 < self.args.instances:
+            nbcomps = rng.randrange(0, 4)
+            return {"vtype": "instance", "isize": nbcomps,
+                    "iclass": self.leaf_class(rng), "iattrs": [],
+                    "icomps": [rng.randrange(-1000000, 1000000)
+                               for _ in range(nbcomps)]}
+        r = rng.random()
+        if r < 0.30:
+            return rng.randrange(-1000000, 1000000)
+        if r < 0.50:
+            return "str%d" % rng.randrange(1000000)
+        if r < 0.80 or depth > 0:
+            return self.random_object(rng)
+        if r < 0.85:
+            return rng.random() * 1000.0 + 0.5
+        nbelem = rng.randrange(1, 8)
+        elems = [self.random_object(rng) for _ in range(nbelem)]
+        if r < 0.93:
+            return {"elem": sorted(set(elems)), "vtype": "set"}
+        return {"comp": elems, "vtype": "tuple"}
+
+    def random_payload(self, rng, obj):
+        kind = rng.choices([k for k, _ in self.payloadmix],
+                           weights=[w for _, w in self.payloadmix])[0]
+        size = rng.randrange(1, 2*self.args.payload_size + 1)
+        if kind == "none":
+            return
+        obj["payload"] = kind
+        if kind == "vectob":
+            obj["vectob"] = [self.random_object(rng) for _ in range(size)]
+        elif kind == "setob":
+            obj["setob"] = sorted(set(self.random_object(rng) for _ in range(size)))
+        elif kind == "vectval":
+            obj["vectval"] = [self.random_value(rng) for _ in range(size)]
+        elif kind == "objmap":
+            obj["descr"] = "synthetic object map"
+            obj["objmap"] = {self.random_object(rng): self.random_value(rng, 1)
+                             for _ in range(size)}
+        elif kind == "value_map":
+            obj["valmap"] = [{"key": rng.randrange(1000000),
+                              "val": self.random_value(rng, 1)}
+                             for _ in range(size)]
+        elif kind == "string_buffer":
+            obj["strbuf_indent"] = 0
+            obj["strbuf_lines"] = ["synthetic line %d of %d" % (i, size)
+                                   for i in range(size)]
+
+    def make_object(self, k: int, rng):
+        oid = self.oid(k)
+        obj = {"oid": oid, "mtime": round(1.6e9 + rng.random() * 1.0e8, 2)}
+        if k < self.nbspaces:
+            first = self.firstobject + k * self.nbobjects // self.nbspaces
+            last = self.firstobject + (k+1) * self.nbobjects // self.nbspaces
+            comps = [self.oid(j) for j in range(first, last)]
+            if k == 0:
+                comps += [self.oid(j) for j in range(self.firstclass, self.firstobject)]
+            obj["class"] = RPS_SPACE_CLASS_OID
+            obj["comps"] = comps
+            obj["payload"] = "space"
+        elif k < self.firstattr:
+            level, _ = divmod(k - self.firstclass, self.args.class_width)
+            if level == 0:
+                superoid = RPS_OBJECT_CLASS_OID
+            else:
+                superoid = self.oid(self.firstclass + (level-1) * self.args.class_width
+                                    + rng.randrange(self.args.class_width))
+            obj["class"] = RPS_CLASS_CLASS_OID
+            obj["class_methodict"] = []
+            obj["class_super"] = superoid
+            obj["payload"] = "classinfo"
+        elif k < self.firstobject:
+            obj["class"] = RPS_ATTRIBUTE_CLASS_OID
+        else:
+            nbattrs = min(self.nbattrs, rng.randrange(0, 2*self.args.attributes + 1))
+            if nbattrs > 0:
+                attrs = sorted(rng.sample(range(self.nbattrs), nbattrs))
+                obj["attrs"] = [{"at": self.oid(self.firstattr + a),
+                                 "va": self.random_value(rng)} for a in attrs]
+            obj["class"] = self.leaf_class(rng)
+            nbcomps = rng.randrange(0, 2*self.args.components + 1)
+            if nbcomps > 0:
+                obj["comps"] = [self.random_value(rng) for _ in range(nbcomps)]
+            self.random_payload(rng, obj)
+        return obj
+
+
+def read_commented_json(path):
+    """read a manifest or space file; give its leading comment lines
+    and its text"""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    lines = text.split("\n")
+    nbcomm = 0
+    while nbcomm < len(lines) and lines[nbcomm].startswith("//"):
+        nbcomm += 1
+    body = [line for line in lines[nbcomm:] if not line.startswith("//")]
+    return "\n".join(lines[:nbcomm]), "\n".join(body)
+
+
+def known_oids_of_space(text):
+    return {line[5:5+19] for line in text.split("\n") if line.startswith("//+ob_")}
+
+
+def add_system_components(text, compoids):
+    """add COMPOIDS to the components of the RefPerSys_system root
+    object in the space file TEXT"""
+    startmark = "//+ob" + RPS_SYSTEM_OID
+    endmark = "//-ob" + RPS_SYSTEM_OID
+    start = text.index(startmark)
+    bodystart = text.index("\n", start) + 1
+    bodyend = text.index(endmark, bodystart)
+    obj = json.loads(text[bodystart:bodyend])
+    obj["comps"] = obj.get("comps", []) + compoids
+    return text[:bodystart] + json.dumps(obj, indent=1) + "\n" + text[bodyend:]
+
+
+def write_space(store, args, manifest, spaceix, path):
+    rng = random.Random(args.seed * 1000003 + spaceix)
+    indexes = [spaceix]
+    if spaceix == 0:
+        indexes += range(store.firstclass, store.firstobject)
+    first = store.firstobject + spaceix * store.nbobjects // store.nbspaces
+    last = store.firstobject + (spaceix+1) * store.nbobjects // store.nbspaces
+    indexes += range(first, last)
+    spaceid = store.oid(spaceix)
+    prologue = {
+        "dumpgmdate": time.strftime("%Y-%b-%d", time.gmtime()),
+        "format": manifest["format"],
+        "nbobjects": len(indexes),
+        "rpsmajorversion": manifest["rpsmajorversion"],
+        "rpsminorversion": manifest["rpsminorversion"],
+        "shortgit": manifest.get("shortgitid", ""),
+        "spaceid": spaceid,
+    }
+    with open(path, "w", encoding="utf-8") as out:
+        out.write("///.SPDX-License-Identifier: GPL-3.0-or-later\n")
+        out.write("///.GENERATED synthetic RefPerSys space file %s / DO NOT EDIT!\n"
+                  % os.path.basename(path))
+        out.write("///. by tools/generate-synthetic-store.py --seed %d\n\n\n" % args.seed)
+        out.write("///!!! prologue of RefPerSys space file:\n")
+        out.write(json.dumps(prologue, indent=1) + "\n\n\n")
+        for k in indexes:
+            obj = store.make_object(k, rng)
+            out.write("//+ob%s\n" % obj["oid"])
+            out.write(json.dumps(obj, indent=1))
+            out.write("\n//-ob%s\n\n\n\n" % obj["oid"])
+        out.write("//// end of RefPerSys generated space file persistore/%s\n"
+                  % os.path.basename(path))
+    return spaceid, len(indexes)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="generate a synthetic RefPerSys persistent store for benchmarks")
+    topdir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+    parser.add_argument("--base", default=topdir,
+                        help="directory of the store whose spaces are copied")
+    parser.add_argument("--output", "-o", required=True,
+                        help="directory of the generated store")
+    parser.add_argument("--objects", "-n", type=int, default=10000,
+                        help="number of synthetic objects")
+    parser.add_argument("--spaces", type=int, default=4,
+                        help="number of synthetic spaces")
+    parser.add_argument("--attributes", type=int, default=3,
+                        help="mean number of attributes per object")
+    parser.add_argument("--attributes-pool", type=int, default=64,
+                        help="number of synthetic attribute objects")
+    parser.add_argument("--components", type=int, default=2,
+                        help="mean number of components per object")
+    parser.add_argument("--class-depth", type=int, default=4,
+                        help="depth of the synthetic class hierarchy")
+    parser.add_argument("--class-width", type=int, default=8,
+                        help="number of synthetic classes at each depth")
+    parser.add_argument("--payload-mix", default=DEFAULT_PAYLOAD_MIX,
+                        help="comma separated KIND:WEIGHT of payloads, with KIND in "
+                        + ",".join(PAYLOAD_KINDS))
+    parser.add_argument("--payload-size", type=int, default=8,
+                        help="mean number of entries of payloads")
+    parser.add_argument("--instances", type=float, default=0.0,
+                        help="percentage of attribute and component values which are "
+                        "instances of synthetic classes, loaded while their classes are")
+    parser.add_argument("--seed", type=int, default=1,
+                        help="the random seed")
+    args = parser.parse_args()
+    if args.spaces < 1 or args.objects < args.spaces or args.class_width < 1 \
+       or args.class_depth < 0 or args.attributes_pool < 1:
+        parser.error("need at least one space, one object per space, "
+                     "one attribute and one class per level")
+    manifcomm, maniftext = read_commented_json(os.path.join(args.base, "rps_manifest.json"))
+    manifest = json.loads(maniftext)
+    os.makedirs(os.path.join(args.output, "persistore"), exist_ok=True)
+    basespaces = {}
+    knownoids = set()
+    for spid in manifest["spaceset"]:
+        spname = "sp%s-rps.json" % spid
+        with open(os.path.join(args.base, "persistore", spname), encoding="utf-8") as f:
+            basespaces[spname] = f.read()
+        knownoids |= known_oids_of_space(basespaces[spname])
+    store = SyntheticStore(args, knownoids)
+    starttime = time.time()
+    synthspaces = [store.oid(s) for s in range(store.nbspaces)]
+    for spname, text in basespaces.items():
+        if ("//+ob" + RPS_SYSTEM_OID) in text:
+            text = add_system_components(text, synthspaces)
+        with open(os.path.join(args.output, "persistore", spname), "w",
+                  encoding="utf-8") as f:
+            f.write(text)
+    nbwritten = 0
+    for spaceix in range(store.nbspaces):
+        path = os.path.join(args.output, "persistore",
+                            "sp%s-rps.json" % store.oid(spaceix))
+        spaceid, nbob = write_space(store, args, manifest, spaceix, path)
+        nbwritten += nbob
+        print("%s: wrote space %s with %d objects (%.1f s)"
+              % (sys.argv[0], spaceid, nbob, time.time() - starttime))
+    manifest["spaceset"] = manifest["spaceset"] + synthspaces
+    with open(os.path.join(args.output, "rps_manifest.json"), "w", encoding="utf-8") as f:
+        f.write(manifcomm + "\n")
+        f.write(json.dumps(manifest, indent=1, sort_keys=True) + "\n")
+        f.write("\n//// end of RefPerSys manifest file\n")
+    print("%s: generated %d synthetic objects in %d spaces into %s in %.1f s"
+          % (sys.argv[0], nbwritten, store.nbspaces, args.output, time.time() - starttime))
+
+
+if __name__ == "__main__":
+    main()
@@ -453,6 +453,8 @@ rps_type_name(std::int16_t typenum)
 {
   switch (typenum)
     {
+    case (int)Rps_Type::PaylValMap:
+      return "Rps_PayloadValMap"; // in valmap_rps.cc
     case (int)Rps_Type::PaylLightCodeGen:
       return "Rps_PayloadLightningCodeGen"; // in lightgen_rps.cc
     case (int)Rps_Type::PaylCplusplusGen:
@@ -519,6 +521,12 @@ rps_type_name(std::int16_t typenum)
       return "Rps_InstanceZone";  // in morevalues_rps.cc
     case (int)Rps_Type::LexToken:
       return "Rps_LexTokenZone"; // in repl_rps.cc
+    case (int)Rps_Type::Hamt:
+      return "Rps_HamtZone"; // in hamt_rps.cc
+    case (int)Rps_Type::DoubleVect:
+      return "Rps_DoubleVectZone"; // in numvect_rps.cc
+    case (int)Rps_Type::IntVect:
+      return "Rps_IntVectZone"; // in numvect_rps.cc
 #warning rps_type_name need code review
     default:
       RPS_WARNOUT("rps_type_name strange typenum=" << typenum
@@ -598,9 +606,12 @@ rps_print_types_info(void)
   EXPLAIN_TYPE(Rps_ClosureValue);
   EXPLAIN_TYPE(Rps_ClosureZone);
   EXPLAIN_TYPE(Rps_Double);
+  EXPLAIN_TYPE(Rps_DoubleVectZone);
   EXPLAIN_TYPE(Rps_DoubleValue);
   EXPLAIN_TYPE(Rps_GarbageCollector);
+  EXPLAIN_TYPE(Rps_HamtZone);
   EXPLAIN_TYPE(Rps_HashInt);
+  EXPLAIN_TYPE(Rps_IntVectZone);
   EXPLAIN_TYPE(Rps_Id);
   EXPLAIN_TYPE(Rps_ObjectRef);
   EXPLAIN_TYPE(Rps_ObjectValue);
@@ -1131,6 +1142,22 @@ rps_check_mtime_files(void)
 static double rps_start_monotonic_time;
 static double rps_start_wallclock_real_time;
 
+/// the --plugin-after-load plugins to be dlopen-ed, see
+/// rps_start_plugins_loading
+struct rps_pending_plugin_st
+{
+  size_t pendplug_index;        // in rps_plugins_vector
+  const char* pendplug_path;
+};
+static std::vector<rps_pending_plugin_st> rps_pending_plugins;
+static std::mutex rps_plugins_loading_mtx;
+static std::thread rps_plugins_loader;
+static bool rps_plugins_loading_started;
+/// set once the plugins are dlopen-ed, to avoid locking the mutex
+/// for every symbol looked up by the loader
+static std::atomic<bool> rps_plugins_loaded;
+static std::string rps_plugins_loading_error;
+
 
 
 /// rps_early_initialization is called by rps_parse_program_arguments
@@ -1158,6 +1185,7 @@ rps_early_initialization(int argc, char** argv)
              err, cwdbuf);
       exit(EXIT_FAILURE);
     };
+  rps_startup_phase("dlopen of the program");
   if (argc == 2 && !strcmp(argv[1], "--full-git"))   /// see also rps_parse1opt
     {
       printf("%s\n", rps_gitid);
@@ -1321,6 +1349,7 @@ rps_early_initialization(int argc, char** argv)
       fprintf(stderr, "%s failed to make backtrace state.\n", rps_progname);
       exit(EXIT_FAILURE);
     }
+  rps_startup_phase("early initialization");
   pthread_setname_np(pthread_self(), "rps-main");
   // hack to handle debug flag as first program argument
   if (argc>1 && !strncmp(argv[1], "--debug=", strlen("--debug=")))
@@ -1666,6 +1695,63 @@ rps_parse1opt (int key, char *arg, struct argp_state *state)
       RPS_ASSERT(rps_disable_aslr);
     }
     return 0;
+    case RPSPROGOPT_INTERN_VALUES:
+    {
+      Rps_InternTable::set_enabled(true);
+    }
+    return 0;
+    case RPSPROGOPT_REFERRERS_INDEX:
+    {
+      rps_build_referrers_index = true;
+    }
+    return 0;
+    case RPSPROGOPT_BINARY_STORE:
+    {
+      rps_binary_store = true;
+    }
+    return 0;
+    case RPSPROGOPT_CONVERT_STORE:
+    {
+      if (strcmp(arg, "to-binary") && strcmp(arg, "to-json")
+          && strcmp(arg, "force-to-json"))
+        RPS_FATALOUT("--convert-store=" << arg
+                     << " expects to-binary, to-json or force-to-json");
+      rps_convert_store = arg;
+    }
+    return 0;
+    case RPSPROGOPT_LAZY_LOAD:
+    {
+      rps_lazy_load = true;
+    }
+    return 0;
+    case RPSPROGOPT_LOAD_PROFILE:
+    {
+      rps_load_profile = arg;
+    }
+    return 0;
+    case RPSPROGOPT_CHECK_HEAP:
+    {
+      if (!arg || !strcmp(arg, "load"))
+        rps_check_heap_after_load = true;
+      else if (!strcmp(arg, "dump"))
+        rps_check_heap_before_dump = true;
+      else if (!strcmp(arg, "both"))
+        rps_check_heap_after_load = rps_check_heap_before_dump = true;
+      else
+        RPS_FATALOUT("--check-heap=" << arg
+                     << " expects load, dump or both");
+    }
+    return 0;
+    case RPSPROGOPT_CHECK_PULL_PARSER:
+    {
+      rps_check_pull_parser = true;
+    }
+    return 0;
+    case RPSPROGOPT_STARTUP_PROFILE:
+    {
+      rps_startup_profile = (arg && arg[0]) ? arg : "-";
+    }
+    return 0;
     case RPSPROGOPT_NO_QUICK_TESTS:
     {
       rps_without_quick_tests = true;
@@ -1760,22 +1846,15 @@ rps_parse1opt (int key, char *arg, struct argp_state *state)
     return 0;
     case RPSPROGOPT_PLUGIN_AFTER_LOAD:
     {
-      char cwdbuf[rps_path_byte_size];
-      memset (cwdbuf, 0, sizeof(cwdbuf));
-      if (!getcwd(cwdbuf, sizeof(cwdbuf)-1))
-        strcpy(cwdbuf, "./");
-      void* dlh = dlopen(arg, RTLD_NOW|RTLD_GLOBAL);
-      if (!dlh)
-        RPS_FATALOUT("failed to dlopen plugin " << arg
-                     << " : " << dlerror()
-                     << " in " << cwdbuf);
       const char* bnplug = basename(arg);
-      Rps_Plugin curplugin(bnplug, dlh);
-      RPS_INFORMOUT("loaded plugin#" << rps_plugins_vector.size()
+      /// the plugin is named now, for --plugin-arg, but dlopen-ed by
+      /// rps_start_plugins_loading which reports a failure
+      Rps_Plugin curplugin(bnplug, nullptr);
+      RPS_INFORMOUT("will load plugin#" << rps_plugins_vector.size()
                     << " from " << arg << " from process pid#"
                     << (int)getpid()
-                    << " basenamed " << Rps_QuotedC_String(bnplug)
-                    << " in " << cwdbuf);
+                    << " basenamed " << Rps_QuotedC_String(bnplug));
+      rps_pending_plugins.push_back({rps_plugins_vector.size(), arg});
       rps_plugins_vector.push_back(curplugin);
     }
     return 0;
@@ -1912,6 +1991,7 @@ rps_parse_program_arguments(int &argc, char**argv)
   if (argp_parse(&argparser_rps, argc, argv, 0, &aix, nullptr))
     RPS_FATALOUT("failed to parse program arguments to " << argv[0]
                  << " at program argument index aix=" << aix);
+  rps_startup_phase("program arguments");
   if (rps_helpwanted) {
     RPS_UNIQUE_BREAKPOINT();
     std::cout << "*** debug level flag in C++ code ***" << std::endl;
@@ -1931,6 +2011,76 @@ rps_parse_program_arguments(int &argc, char**argv)
 
 
 
+////////////////////////////////////////////////////////////////
+//// loading the --plugin-after-load plugins, overlapping the load
+
+static void
+rps_plugins_loading_thread(void)
+{
+  pthread_setname_np(pthread_self(), "rps-plugins");
+  double startmonotime = rps_monotonic_real_time();
+  char cwdbuf[rps_path_byte_size];
+  memset (cwdbuf, 0, sizeof(cwdbuf));
+  if (!getcwd(cwdbuf, sizeof(cwdbuf)-1))
+    strcpy(cwdbuf, "./");
+  for (auto& pendplug : rps_pending_plugins)
+    {
+      void* dlh = dlopen(pendplug.pendplug_path, RTLD_NOW|RTLD_GLOBAL);
+      if (!dlh)
+        {
+          /// dlerror is thread local, the failure is reported by
+          /// rps_wait_plugins_loading
+          rps_plugins_loading_error = std::string{"failed to dlopen plugin "}
+                                      + pendplug.pendplug_path + " : " + dlerror()
+                                      + " in " + cwdbuf;
+          break;
+        }
+      rps_plugins_vector[pendplug.pendplug_index].plugin_dlh = dlh;
+    }
+  rps_startup_background_phase("plugins loading", startmonotime,
+                               rps_thread_cpu_time());
+} // end rps_plugins_loading_thread
+
+void
+rps_start_plugins_loading(void)
+{
+  RPS_ASSERT(rps_is_main_thread());
+  std::lock_guard<std::mutex> gu(rps_plugins_loading_mtx);
+  if (rps_plugins_loading_started)
+    return;
+  if (rps_pending_plugins.empty())
+    {
+      rps_plugins_loaded.store(true, std::memory_order_release);
+      return;
+    };
+  rps_plugins_loading_started = true;
+  rps_plugins_loader = std::thread(rps_plugins_loading_thread);
+} // end rps_start_plugins_loading
+
+/// may be called from several loading threads, needing a symbol
+/// perhaps defined by a plugin
+void
+rps_wait_plugins_loading(void)
+{
+  if (rps_plugins_loaded.load(std::memory_order_acquire))
+    return;
+  std::lock_guard<std::mutex> gu(rps_plugins_loading_mtx);
+  if (!rps_plugins_loading_started)
+    return;
+  if (rps_plugins_loader.joinable())
+    rps_plugins_loader.join();
+  if (!rps_plugins_loading_error.empty())
+    RPS_FATALOUT(rps_plugins_loading_error);
+  for (auto& pendplug : rps_pending_plugins)
+    RPS_INFORMOUT("loaded plugin#" << pendplug.pendplug_index
+                  << " from " << pendplug.pendplug_path
+                  << " from process pid#" << (int)getpid());
+  rps_pending_plugins.clear();
+  rps_plugins_loaded.store(true, std::memory_order_release);
+} // end rps_wait_plugins_loading
+
+
+
 /// most of the time this function is used thru RPS_OUT_PROGARGS macro
 void
 rps_output_program_arguments(std::ostream& out, int argc,
@@ -2259,6 +2409,176 @@ double rps_get_start_wallclock_real_time()
 }
 
 
+
+////////////////////////////////////////////////////////////////
+// STARTUP TIMELINE, see --startup-profile
+////////////////////////////////////////////////////////////////
+
+struct rps_startup_phase_st
+{
+  const char* stph_name;
+  double stph_start;            // monotonic time
+  double stph_end;
+  double stph_cpu;
+  bool stph_background;
+};
+static std::mutex rps_startup_mtx;
+static std::vector<rps_startup_phase_st> rps_startup_phases;
+static double rps_startup_last_monotime;
+static double rps_startup_last_cputime;
+
+/// the monotonic time of the start of the process, from its start
+/// time in clock ticks since boot in /proc/self/stat; so the first
+/// startup phase includes the execve, the dynamic linking and the
+/// static constructors
+static double
+rps_startup_process_monotime(void)
+{
+  double nowmono = rps_monotonic_real_time();
+  FILE* statf = fopen("/proc/self/stat", "r");
+  if (!statf)
+    return nowmono;
+  char statbuf[1024];
+  memset (statbuf, 0, sizeof(statbuf));
+  bool gotstat = fgets(statbuf, sizeof(statbuf)-1, statf) != nullptr;
+  fclose(statf);
+  /// the command name may contain spaces, fields after it are
+  /// counted from its closing parenthesis, the start time being the
+  /// 22nd field
+  const char* endcomm = gotstat ? strrchr(statbuf, ')') : nullptr;
+  if (!endcomm)
+    return nowmono;
+  const char* pc = endcomm + 1;
+  for (int fieldix = 2; fieldix < 21 && pc; fieldix++)
+    pc = strchr(pc+1, ' ');
+  unsigned long long starticks = 0;
+  if (!pc || sscanf(pc, " %llu", &starticks) < 1)
+    return nowmono;
+  struct timespec boots = {0,0};
+  clock_gettime(CLOCK_BOOTTIME, &boots);
+  double nowboot = (double)boots.tv_sec + 1.0e-9*boots.tv_nsec;
+  double premain = nowboot - (double)starticks / (double)sysconf(_SC_CLK_TCK);
+  if (premain < 0.0 || premain > 60.0)
+    return nowmono;
+  return nowmono - premain;
+} // end rps_startup_process_monotime
+
+void
+rps_startup_phase(const char*name)
+{
+  RPS_ASSERT(name != nullptr);
+  double nowmono = rps_monotonic_real_time();
+  double nowcpu = rps_process_cpu_time();
+  std::lock_guard<std::mutex> gu(rps_startup_mtx);
+  if (rps_startup_phases.empty())
+    {
+      /// the process CPU time before main is all the startup CPU time so far
+      rps_startup_last_monotime = rps_startup_process_monotime();
+      rps_startup_last_cputime = 0.0;
+    };
+  rps_startup_phases.push_back({name, rps_startup_last_monotime, nowmono,
+                                nowcpu - rps_startup_last_cputime, false});
+  rps_startup_last_monotime = nowmono;
+  rps_startup_last_cputime = nowcpu;
+} // end rps_startup_phase
+
+void
+rps_startup_background_phase(const char*name, double startmonotime,
+                             double threadcputime)
+{
+  RPS_ASSERT(name != nullptr);
+  double nowmono = rps_monotonic_real_time();
+  std::lock_guard<std::mutex> gu(rps_startup_mtx);
+  rps_startup_phases.push_back({name, startmonotime, nowmono,
+                                threadcputime, true});
+} // end rps_startup_background_phase
+
+void
+rps_show_startup_profile(const char*path)
+{
+  RPS_ASSERT(path != nullptr);
+  std::vector<rps_startup_phase_st> phasevec;
+  {
+    std::lock_guard<std::mutex> gu(rps_startup_mtx);
+    phasevec = rps_startup_phases;
+  }
+  if (phasevec.empty())
+    return;
+  std::stable_sort(phasevec.begin(), phasevec.end(),
+                   [](const rps_startup_phase_st&left, const rps_startup_phase_st&right)
+  {
+    return left.stph_start < right.stph_start;
+  });
+  double origin = phasevec[0].stph_start;
+  double totalreal = 0.0;
+  for (auto& ph : phasevec)
+    if (ph.stph_end - origin > totalreal)
+      totalreal = ph.stph_end - origin;
+  double totalcpu = rps_process_cpu_time();
+  std::string pathstr{path};
+  bool asjson = pathstr.size() > 5 && pathstr.substr(pathstr.size()-5) == ".json";
+  std::ofstream outf;
+  if (pathstr != "-")
+    {
+      outf.open(pathstr);
+      if (!outf)
+        {
+          RPS_WARNOUT("cannot write startup profile into " << pathstr
+                      << ":" << strerror(errno));
+          return;
+        }
+    };
+  std::ostream& out = (pathstr == "-") ? std::cout : outf;
+  if (asjson)
+    {
+      Json::Value jprof(Json::objectValue);
+      jprof["pid"] = Json::Value((int)getpid());
+      jprof["shortgitid"] = Json::Value(rps_shortgitid);
+      jprof["batch"] = Json::Value(rps_batch);
+      jprof["realtime"] = Json::Value(totalreal);
+      jprof["cputime"] = Json::Value(totalcpu);
+      Json::Value jphases(Json::arrayValue);
+      for (auto& ph : phasevec)
+        {
+          Json::Value jph(Json::objectValue);
+          jph["phase"] = Json::Value(ph.stph_name);
+          jph["start"] = Json::Value(ph.stph_start - origin);
+          jph["duration"] = Json::Value(ph.stph_end - ph.stph_start);
+          jph["cpu"] = Json::Value(ph.stph_cpu);
+          jph["background"] = Json::Value(ph.stph_background);
+          jphases.append(jph);
+        }
+      jprof["phases"] = jphases;
+      Json::StreamWriterBuilder jswb;
+      jswb["indentation"] = " ";
+      std::unique_ptr<Json::StreamWriter> jsw(jswb.newStreamWriter());
+      jsw->write(jprof, &out);
+      out << std::endl;
+    }
+  else
+    {
+      char buf[256];
+      snprintf(buf, sizeof(buf),
+               "RefPerSys startup profile of pid %d (git %s): %zu phases in %.4f s real, %.4f s cpu\n",
+               (int)getpid(), rps_shortgitid, phasevec.size(), totalreal, totalcpu);
+      out << buf;
+      snprintf(buf, sizeof(buf), "%10s %11s %10s  %s\n",
+               "start ms", "duration ms", "cpu ms", "phase");
+      out << buf;
+      for (auto& ph : phasevec)
+        {
+          snprintf(buf, sizeof(buf), "%10.3f %11.3f %10.3f  %s%s\n",
+                   (ph.stph_start - origin)*1.0e3,
+                   (ph.stph_end - ph.stph_start)*1.0e3,
+                   ph.stph_cpu*1.0e3, ph.stph_name,
+                   ph.stph_background ? " [background]" : "");
+          out << buf;
+        }
+    };
+  out << std::flush;
+} // end rps_show_startup_profile
+
+
 void
 rps_print_objectref(Rps_ObjectRef ob)
 {
@@ -2926,5 +3246,91 @@ rps_real_shell_file_path(const std::string& filpath)
 
 
 
+static const char rps_base64_alphabet[]=
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// standard base64 encoding (RFC 4648) with padding, used for
+/// compact binary data inside our JSON dumps
+std::string
+rps_base64_encode(const void*data, size_t len)
+{
+  const unsigned char*pb = reinterpret_cast<const unsigned char*>(data);
+  std::string res;
+  res.reserve(4*((len+2)/3));
+  size_t ix = 0;
+  for (; ix+3 <= len; ix += 3)
+    {
+      uint32_t w = (pb[ix]<<16) | (pb[ix+1]<<8) | pb[ix+2];
+      res.push_back(rps_base64_alphabet[(w>>18)&63]);
+      res.push_back(rps_base64_alphabet[(w>>12)&63]);
+      res.push_back(rps_base64_alphabet[(w>>6)&63]);
+      res.push_back(rps_base64_alphabet[w&63]);
+    };
+  if (ix+1 == len)
+    {
+      uint32_t w = pb[ix]<<16;
+      res.push_back(rps_base64_alphabet[(w>>18)&63]);
+      res.push_back(rps_base64_alphabet[(w>>12)&63]);
+      res.append("==");
+    }
+  else if (ix+2 == len)
+    {
+      uint32_t w = (pb[ix]<<16) | (pb[ix+1]<<8);
+      res.push_back(rps_base64_alphabet[(w>>18)&63]);
+      res.push_back(rps_base64_alphabet[(w>>12)&63]);
+      res.push_back(rps_base64_alphabet[(w>>6)&63]);
+      res.push_back('=');
+    };
+  return res;
+} // end rps_base64_encode
+
+
+/// decode base64 into OUT, giving false on invalid input
+bool
+rps_base64_decode(const std::string&str, std::string&out)
+{
+  out.clear();
+  size_t len = str.size();
+  if (len % 4 != 0)
+    return false;
+  out.reserve(3*(len/4));
+  auto decode_char = [](char c) -> int
+  {
+    if (c >= 'A' && c <= 'Z') return c-'A';
+    if (c >= 'a' && c <= 'z') return c-'a'+26;
+    if (c >= '0' && c <= '9') return c-'0'+52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  };
+  for (size_t ix=0; ix<len; ix += 4)
+    {
+      bool last = ix+4 == len;
+      int nbpad = 0;
+      if (last && str[ix+3] == '=')
+        nbpad = (str[ix+2] == '=')?2:1;
+      uint32_t w = 0;
+      for (int j=0; j<4; j++)
+        {
+          int d = 0;
+          if (j < 4-nbpad)
+            {
+              d = decode_char(str[ix+j]);
+              if (d<0)
+                return false;
+            };
+          w = (w<<6) | d;
+        };
+      out.push_back((char)((w>>16)&0xff));
+      if (nbpad < 2)
+        out.push_back((char)((w>>8)&0xff));
+      if (nbpad < 1)
+        out.push_back((char)(w&0xff));
+    };
+  return true;
+} // end rps_base64_decode
+
+
+
 #pragma message "may need to define output of more vectors (of objects, values, ...) and indented output"
 //// end of file utilities_rps.cc
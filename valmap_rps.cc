@@ -0,0 +1,490 @@
+/****************************************************************
+ * file valmap_rps.cc
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * Description:
+ *      This file is part of the Reflective Persistent System.
+ *
+ *      It has the code of the mutable hash map payload, associating
+ *      arbitrary non-empty values to values.
+ *
+ * Author(s):
+ *      Basile Starynkevitch, France    <basile@starynkevitch.net>
+ *      Niklas Rozencrantz, Sweden     <niklasr@protonmail.com>
+ *
+ *      © Copyright (C) 2026 The Reflective Persistent System Team
+ *      team@refpersys.org & http://refpersys.org/
+ *
+ * License:
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#include "refpersys.hh"
+
+
+
+extern "C" const char rps_valmap_gitid[];
+const char rps_valmap_gitid[]= RPS_GITID;
+
+
+extern "C" const char rps_valmap_shortgitid[];
+const char rps_valmap_shortgitid[]= RPS_SHORTGITID;
+
+
+extern "C" const char rps_valmap_basename[];
+const char rps_valmap_basename[]= RPS_BASENAME;
+
+extern "C" const char rps_valmap_baseid[];
+const char rps_valmap_baseid[]= RPS_BASEID;
+
+
+Rps_PayloadValMap::Rps_PayloadValMap(Rps_ObjectZone*obz)
+  : Rps_Payload(Rps_Type::PaylValMap, obz),
+    vm_slots(), vm_oldslots(),
+    vm_count(0), vm_used(0), vm_oldcount(0), vm_migrated(0),
+    vm_is_transient(false), vm_snapshots()
+{
+} // end Rps_PayloadValMap::Rps_PayloadValMap
+
+Rps_PayloadValMap::~Rps_PayloadValMap()
+{
+  vm_slots.clear();
+  vm_oldslots.clear();
+  vm_snapshots.clear();
+  vm_count = 0;
+} // end Rps_PayloadValMap::~Rps_PayloadValMap
+
+void
+Rps_PayloadValMap::gc_mark(Rps_GarbageCollector&gc) const
+{
+  each_slot([&](const vm_slot_st&slot)
+  {
+    gc.mark_value(slot.vs_key);
+    gc.mark_value(slot.vs_val);
+  });
+  for (auto& snapvec : vm_snapshots)
+    for (Rps_Value v : snapvec)
+      gc.mark_value(v);
+} // end Rps_PayloadValMap::gc_mark
+
+void
+Rps_PayloadValMap::each_referenced_object(const std::function<void(Rps_ObjectZone*)>&f) const
+{
+  each_slot([&](const vm_slot_st&slot)
+  {
+    rps_each_object_in_value(slot.vs_key, f);
+    rps_each_object_in_value(slot.vs_val, f);
+  });
+} // end Rps_PayloadValMap::each_referenced_object
+
+void
+Rps_PayloadValMap::dump_scan(Rps_Dumper*du) const
+{
+  RPS_ASSERT(du != nullptr);
+  if (vm_is_transient)
+    return;
+  each_slot([&](const vm_slot_st&slot)
+  {
+    rps_dump_scan_value(du, slot.vs_key, 0);
+    rps_dump_scan_value(du, slot.vs_val, 0);
+  });
+} // end Rps_PayloadValMap::dump_scan
+
+void
+Rps_PayloadValMap::dump_json_content(Rps_Dumper*du, Json::Value&jv) const
+{
+  /// see function rpsldpy_value_map below
+  RPS_ASSERT(du != nullptr);
+  RPS_ASSERT(jv.type() == Json::objectValue);
+  if (vm_is_transient)
+    return;
+  Json::Value jarr(Json::arrayValue);
+  for (auto& ent : sorted_entries())
+    {
+      if (!rps_is_dumpable_value(du, ent.first)
+          || !rps_is_dumpable_value(du, ent.second))
+        continue;
+      Json::Value jent(Json::objectValue);
+      jent["key"] = rps_dump_json_value(du, ent.first);
+      jent["val"] = rps_dump_json_value(du, ent.second);
+      jarr.append(jent);
+    }
+  jv["payload"] = "value_map";
+  jv["valmap"] = jarr;
+} // end Rps_PayloadValMap::dump_json_content
+
+
+//// loading of Rps_PayloadValMap; see above Rps_PayloadValMap::dump_json_content
+void
+rpsldpy_value_map(Rps_ObjectZone*obz, Rps_Loader*ld, const Json::Value& jv, Rps_Id spacid, unsigned lineno)
+{
+  RPS_ASSERT(obz != nullptr);
+  RPS_ASSERT(ld != nullptr);
+  RPS_DEBUG_LOG(LOAD, "rpsldpy_value_map object " << obz->oid()
+                << " in space " << spacid << " lineno#" << lineno << " jv="
+                << jv);
+  RPS_ASSERT(obz->get_payload() == nullptr);
+  RPS_ASSERT(jv.type() == Json::objectValue);
+  Json::Value jarr = jv["valmap"];
+  if (!jarr.isArray())
+    RPS_FATALOUT("rpsldpy_value_map: object " << obz->oid()
+                 << " in space " << spacid << " lineno#" << lineno
+                 << " has bad valmap "
+                 << std::endl
+                 << " jv " << jv);
+  auto paylvalmap = obz->put_new_plain_payload<Rps_PayloadValMap>();
+  unsigned nbent = jarr.size();
+  paylvalmap->grow(nbent);
+  for (int entix=0; entix<(int)nbent; entix++)
+    {
+      Json::Value jcurent = jarr[entix];
+      if (!jcurent.isObject()
+          || !jcurent.isMember("key")
+          || !jcurent.isMember("val"))
+        continue;
+      Rps_Value keyv(jcurent["key"], ld);
+      Rps_Value valv(jcurent["val"], ld);
+      if (!keyv || !valv)
+        continue;
+      paylvalmap->put(keyv, valv);
+    }
+} // end rpsldpy_value_map
+
+
+/// give the position in SLOTS of the live entry for KEY of hash H, or
+/// else -1
+int
+Rps_PayloadValMap::find_in_slots(const std::vector<vm_slot_st>&slots,
+                                 Rps_Value key, Rps_HashInt h)
+{
+  if (slots.empty())
+    return -1;
+  unsigned mask = slots.size() - 1;
+  for (unsigned pos = h & mask; ; pos = (pos+1) & mask)
+    {
+      const vm_slot_st& slot = slots[pos];
+      if (slot.vs_state == vm_state_empty)
+        return -1;
+      if (slot.vs_state == vm_state_used && slot.vs_hash == h
+          && slot.vs_key == key)
+        return (int)pos;
+    }
+} // end Rps_PayloadValMap::find_in_slots
+
+/// put a new entry, known to be absent, into SLOTS which has some
+/// empty slot; return true if an empty slot (not a removed one) was
+/// used
+bool
+Rps_PayloadValMap::place_in_slots(std::vector<vm_slot_st>&slots,
+                                  Rps_Value key, Rps_Value val,
+                                  Rps_HashInt h)
+{
+  RPS_ASSERT(!slots.empty());
+  unsigned mask = slots.size() - 1;
+  unsigned pos = h & mask;
+  while (slots[pos].vs_state == vm_state_used)
+    pos = (pos+1) & mask;
+  bool wasempty = slots[pos].vs_state == vm_state_empty;
+  slots[pos] = vm_slot_st{key, val, h, vm_state_used};
+  return wasempty;
+} // end Rps_PayloadValMap::place_in_slots
+
+/// move the next NBSLOTS slots of the previous table into the current
+/// one; the moved ones become removed, so probes in the previous
+/// table still work
+void
+Rps_PayloadValMap::migrate_some(unsigned nbslots)
+{
+  while (nbslots-- > 0 && vm_migrated < vm_oldslots.size())
+    {
+      vm_slot_st& oldslot = vm_oldslots[vm_migrated++];
+      if (oldslot.vs_state != vm_state_used)
+        continue;
+      if (place_in_slots(vm_slots, oldslot.vs_key, oldslot.vs_val,
+                         oldslot.vs_hash))
+        vm_used++;
+      oldslot = vm_slot_st{nullptr, nullptr, 0, vm_state_removed};
+      vm_oldcount--;
+    };
+  if (vm_migrated >= vm_oldslots.size())
+    {
+      RPS_ASSERT(vm_oldcount == 0);
+      std::vector<vm_slot_st>().swap(vm_oldslots);
+      vm_migrated = 0;
+    }
+} // end Rps_PayloadValMap::migrate_some
+
+/// start using a fresh table for at least MINCOUNT entries; the
+/// current one becomes the previous table, migrated lazily
+void
+Rps_PayloadValMap::grow(unsigned mincount)
+{
+  migrate_some(vm_oldslots.size());
+  if (mincount < vm_count)
+    mincount = vm_count;
+  unsigned newsize = vm_minsize;
+  while (newsize < 4*mincount)
+    newsize *= 2;
+  if (newsize <= vm_slots.size() && 2*(vm_used+1) <= vm_slots.size())
+    return;
+  vm_oldslots.swap(vm_slots);
+  vm_slots.assign(newsize, vm_slot_st{nullptr, nullptr, 0, vm_state_empty});
+  vm_oldcount = vm_count;
+  vm_used = 0;
+  vm_migrated = 0;
+  if (vm_oldcount == 0)
+    std::vector<vm_slot_st>().swap(vm_oldslots);
+} // end Rps_PayloadValMap::grow
+
+Rps_Value
+Rps_PayloadValMap::find(Rps_Value key, bool*pmissing) const
+{
+  if (pmissing)
+    *pmissing = true;
+  if (!key)
+    return nullptr;
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  Rps_HashInt h = key.valhash();
+  int pos = find_in_slots(vm_slots, key, h);
+  if (pos >= 0)
+    {
+      if (pmissing)
+        *pmissing = false;
+      return vm_slots[pos].vs_val;
+    };
+  pos = find_in_slots(vm_oldslots, key, h);
+  if (pos >= 0)
+    {
+      if (pmissing)
+        *pmissing = false;
+      return vm_oldslots[pos].vs_val;
+    };
+  return nullptr;
+} // end Rps_PayloadValMap::find
+
+bool
+Rps_PayloadValMap::contains(Rps_Value key) const
+{
+  bool missing = true;
+  (void) find(key, &missing);
+  return !missing;
+} // end Rps_PayloadValMap::contains
+
+void
+Rps_PayloadValMap::put(Rps_Value key, Rps_Value val)
+{
+  if (!key)
+    return;
+  if (!val)
+    {
+      (void) remove(key);
+      return;
+    };
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  migrate_some(vm_migratestep);
+  Rps_HashInt h = key.valhash();
+  int pos = find_in_slots(vm_slots, key, h);
+  if (pos >= 0)
+    {
+      note_payload_references(vm_slots[pos].vs_val, val);
+      vm_slots[pos].vs_val = val;
+      return;
+    };
+  pos = find_in_slots(vm_oldslots, key, h);
+  if (pos >= 0)
+    {
+      note_payload_references(vm_oldslots[pos].vs_key, nullptr);
+      note_payload_references(vm_oldslots[pos].vs_val, nullptr);
+      vm_oldslots[pos] = vm_slot_st{nullptr, nullptr, 0, vm_state_removed};
+      vm_oldcount--;
+      vm_count--;
+    };
+  if (2*(vm_used+vm_oldcount+1) > vm_slots.size())
+    grow(vm_count+1);
+  if (place_in_slots(vm_slots, key, val, h))
+    vm_used++;
+  vm_count++;
+  note_payload_references(nullptr, key);
+  note_payload_references(nullptr, val);
+} // end Rps_PayloadValMap::put
+
+bool
+Rps_PayloadValMap::remove(Rps_Value key)
+{
+  if (!key)
+    return false;
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  migrate_some(vm_migratestep);
+  Rps_HashInt h = key.valhash();
+  int pos = find_in_slots(vm_slots, key, h);
+  if (pos >= 0)
+    {
+      note_payload_references(vm_slots[pos].vs_key, nullptr);
+      note_payload_references(vm_slots[pos].vs_val, nullptr);
+      vm_slots[pos] = vm_slot_st{nullptr, nullptr, 0, vm_state_removed};
+      vm_count--;
+      return true;
+    };
+  pos = find_in_slots(vm_oldslots, key, h);
+  if (pos >= 0)
+    {
+      note_payload_references(vm_oldslots[pos].vs_key, nullptr);
+      note_payload_references(vm_oldslots[pos].vs_val, nullptr);
+      vm_oldslots[pos] = vm_slot_st{nullptr, nullptr, 0, vm_state_removed};
+      vm_oldcount--;
+      vm_count--;
+      return true;
+    };
+  return false;
+} // end Rps_PayloadValMap::remove
+
+void
+Rps_PayloadValMap::clear(void)
+{
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  each_slot([&](const vm_slot_st&slot)
+  {
+    note_payload_references(slot.vs_key, nullptr);
+    note_payload_references(slot.vs_val, nullptr);
+  });
+  vm_slots.clear();
+  vm_oldslots.clear();
+  vm_count = vm_used = vm_oldcount = vm_migrated = 0;
+} // end Rps_PayloadValMap::clear
+
+void
+Rps_PayloadValMap::set_transient(bool transient)
+{
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  vm_is_transient = transient;
+} // end Rps_PayloadValMap::set_transient
+
+std::vector<std::pair<Rps_Value,Rps_Value>>
+    Rps_PayloadValMap::sorted_entries(void) const
+{
+  std::lock_guard<std::recursive_mutex> gu(*owner()->objmtxptr());
+  std::vector<std::pair<Rps_Value,Rps_Value>> vecent;
+  vecent.reserve(vm_count);
+  each_slot([&](const vm_slot_st&slot)
+  {
+    vecent.push_back({slot.vs_key, slot.vs_val});
+  });
+  /// integers, doubles, strings and other keys are totally ordered
+  std::sort(vecent.begin(), vecent.end(),
+            [](const std::pair<Rps_Value,Rps_Value>&e1,
+               const std::pair<Rps_Value,Rps_Value>&e2)
+  {
+    return Rps_Value::compare_total(e1.first, e2.first) < 0;
+  });
+  return vecent;
+} // end Rps_PayloadValMap::sorted_entries
+
+/// copy the keys and values, alternated, into a new snapshot under
+/// the owner's lock; the snapshot is removed, again under the lock,
+/// when the iteration ends, even by an exception
+Rps_PayloadValMap::snapshot_st::snapshot_st(const Rps_PayloadValMap*valmap)
+  : sn_valmap(valmap)
+{
+  RPS_ASSERT(valmap != nullptr);
+  std::lock_guard<std::recursive_mutex> gu(*valmap->owner()->objmtxptr());
+  sn_it = valmap->vm_snapshots.emplace(valmap->vm_snapshots.end());
+  sn_it->reserve(2*valmap->vm_count);
+  valmap->each_slot([&](const vm_slot_st&slot)
+  {
+    sn_it->push_back(slot.vs_key);
+    sn_it->push_back(slot.vs_val);
+  });
+} // end Rps_PayloadValMap::snapshot_st::snapshot_st
+
+Rps_PayloadValMap::snapshot_st::~snapshot_st()
+{
+  std::lock_guard<std::recursive_mutex> gu(*sn_valmap->owner()->objmtxptr());
+  sn_valmap->vm_snapshots.erase(sn_it);
+} // end Rps_PayloadValMap::snapshot_st::~snapshot_st
+
+void
+Rps_PayloadValMap::iterate_with_data(void*data,
+                                     const std::function <bool(void*,const Rps_Value,const Rps_Value)>& stopfun) const
+{
+  RPS_ASSERT(stopfun);
+  snapshot_st snap(this);
+  const std::vector<Rps_Value>& snapvec = snap.keys_and_values();
+  for (unsigned ix = 0; ix+1 < snapvec.size(); ix += 2)
+    {
+      if (stopfun(data, snapvec[ix], snapvec[ix+1]))
+        break;
+    }
+} // end Rps_PayloadValMap::iterate_with_data
+
+void
+Rps_PayloadValMap::iterate_apply(Rps_CallFrame*callerframe, Rps_Value closarg)
+{
+  RPS_LOCALFRAME(RPS_CALL_FRAME_UNDESCRIBED,
+                 /*prev:*/callerframe,
+                 Rps_ObjectRef obown;
+                 Rps_Value closv;
+                 Rps_Value curkeyv;
+                 Rps_Value curval;
+                );
+  RPS_ASSERT(callerframe == nullptr || callerframe->is_good_call_frame());
+  if (!closarg.is_closure())
+    return;
+  _f.obown = owner();
+  if (!_f.obown)
+    return;
+  _f.closv = closarg;
+  snapshot_st snap(this);
+  const std::vector<Rps_Value>& snapvec = snap.keys_and_values();
+  for (unsigned ix = 0; ix+1 < snapvec.size(); ix += 2)
+    {
+      _f.curkeyv = snapvec[ix];
+      _f.curval = snapvec[ix+1];
+      Rps_TwoValues pair =
+        Rps_ClosureValue(_f.closv).apply3(&_, _f.obown, _f.curkeyv,
+                                          _f.curval);
+      if (!pair)
+        break;
+    }
+} // end Rps_PayloadValMap::iterate_apply
+
+void
+Rps_PayloadValMap::output_payload(std::ostream&out, unsigned depth,
+                                  unsigned maxdepth) const
+{
+  RPS_ASSERT(depth <= maxdepth);
+  bool ontty =
+    (&out == &std::cout)?isatty(STDOUT_FILENO)
+    :(&out == &std::cerr)?isatty(STDERR_FILENO)
+    :false;
+  if (rps_without_terminal_escape)
+    ontty = false;
+  const char* BOLD_esc = (ontty?RPS_TERMINAL_BOLD_ESCAPE:"");
+  const char* NORM_esc = (ontty?RPS_TERMINAL_NORMAL_ESCAPE:"");
+  std::lock_guard<std::recursive_mutex> guown(*(owner()->objmtxptr()));
+  out << std::endl << BOLD_esc << "**"
+      << (vm_is_transient?" transient":"")
+      << " value map payload of " << vm_count
+      << " entries **" << NORM_esc;
+  if (depth >= maxdepth)
+    return;
+  for (auto& ent : sorted_entries())
+    {
+      out << std::endl << "*:";
+      ent.first.output(out, depth+1, maxdepth);
+      out << " => ";
+      ent.second.output(out, depth+1, maxdepth);
+    }
+  out << std::endl;
+} // end Rps_PayloadValMap::output_payload
+
+//// end of file valmap_rps.cc
@@ -204,6 +204,21 @@ Rps_QuasiZone::unregister_in_zonevec(void)
   qz_cnt--;
 } // end of Rps_QuasiZone::unregister_in_zonevec
 
+std::vector<const Rps_QuasiZone*>
+Rps_QuasiZone::sorted_live_zones(void)
+{
+  std::vector<const Rps_QuasiZone*> zonevec;
+  {
+    std::lock_guard<std::recursive_mutex> gu(qz_mtx);
+    zonevec.reserve(qz_cnt);
+    for (Rps_QuasiZone *qz : qz_zonvec)
+      if (qz)
+        zonevec.push_back(qz);
+  }
+  std::sort(zonevec.begin(), zonevec.end());
+  return zonevec;
+} // end of Rps_QuasiZone::sorted_live_zones
+
 void
 Rps_QuasiZone::clear_all_gcmarks(Rps_GarbageCollector&gc)
 {
@@ -250,6 +265,97 @@ rps_limited_print_ptr_value(const void*v, unsigned depth, unsigned maxdepth)
   std::cout << Rps_OutputValue(val, depth, maxdepth) << std::endl;
 } // end rps_limited_print_ptr_value
 
+//////////////////////////////////////////////// weak intern table
+std::mutex Rps_InternTable::intern_mtx;
+std::unordered_multimap<Rps_HashInt,const Rps_LazyHashedZoneValue*> Rps_InternTable::intern_map;
+std::atomic<bool> Rps_InternTable::intern_enabled;
+std::atomic<uint64_t> Rps_InternTable::intern_hits;
+
+void
+Rps_InternTable::set_enabled(bool on)
+{
+  std::lock_guard<std::mutex> gu(intern_mtx);
+  intern_enabled.store(on);
+  if (!on)
+    {
+      for (auto it: intern_map)
+        it.second->set_interned(false);
+      intern_map.clear();
+    }
+} // end Rps_InternTable::set_enabled
+
+const Rps_LazyHashedZoneValue*
+Rps_InternTable::intern(const Rps_LazyHashedZoneValue*zv)
+{
+  if (!zv || !enabled())
+    return zv;
+  if (zv->is_interned())
+    return zv;
+  Rps_HashInt h = zv->val_hash();
+  std::lock_guard<std::mutex> gu(intern_mtx);
+  auto range = intern_map.equal_range(h);
+  for (auto it = range.first; it != range.second; it++)
+    {
+      const Rps_ZoneValue*oldzv = it->second;
+      if (oldzv->stored_type() == zv->stored_type()
+          && oldzv->equal(*zv))
+        {
+          intern_hits.fetch_add(1);
+          return it->second;
+        }
+    };
+  intern_map.insert({h, zv});
+  zv->set_interned(true);
+  return zv;
+} // end Rps_InternTable::intern
+
+const Rps_String*
+Rps_InternTable::find_string(const char*cstr, int len)
+{
+  if (!enabled() || !cstr || len<0)
+    return nullptr;
+  Rps_HashInt h = rps_hash_cstr(cstr, len);
+  if (h == 0)
+    return nullptr;
+  std::lock_guard<std::mutex> gu(intern_mtx);
+  auto range = intern_map.equal_range(h);
+  for (auto it = range.first; it != range.second; it++)
+    {
+      if (it->second->stored_type() != Rps_Type::String)
+        continue;
+      auto oldstr = static_cast<const Rps_String*>(it->second);
+      const char*oldcstr = oldstr->cstr();
+      if (!strncmp(oldcstr, cstr, len) && oldcstr[len] == (char)0)
+        {
+          intern_hits.fetch_add(1);
+          return oldstr;
+        }
+    };
+  return nullptr;
+} // end Rps_InternTable::find_string
+
+/* called by the garbage collector after marking and before deleting
+   the unmarked zones */
+void
+Rps_InternTable::gc_remove_unmarked(Rps_GarbageCollector&gc)
+{
+  std::lock_guard<std::mutex> gu(intern_mtx);
+  for (auto it = intern_map.begin(); it != intern_map.end(); )
+    {
+      if (it->second->is_gcmarked(gc))
+        it++;
+      else
+        it = intern_map.erase(it);
+    };
+} // end Rps_InternTable::gc_remove_unmarked
+
+size_t
+Rps_InternTable::size(void)
+{
+  std::lock_guard<std::mutex> gu(intern_mtx);
+  return intern_map.size();
+} // end Rps_InternTable::size
+
 //////////////////////////////////////////////// sets
 
 Rps_SetOb::Rps_SetOb(const std::set<Rps_ObjectRef>& setob, Rps_SetTag)
@@ -275,9 +381,10 @@ Rps_SetOb::make(const std::set<Rps_ObjectRef>& setob)
   for (auto ob : setob)
     if (RPS_UNLIKELY(!ob))
       throw std::invalid_argument("empty element to Rps_SetOb::make");
-  return
+  const Rps_SetOb*newset =
     rps_allocate_with_wordgap<Rps_SetOb,const std::set<Rps_ObjectRef>&,Rps_SetTag>
     (setsiz,setob,Rps_SetTag{});
+  return Rps_InternTable::intern_value(newset);
 } // end of Rps_SetOb::make with set
 
 
@@ -440,7 +547,7 @@ Rps_TupleOb::make(const std::vector<Rps_ObjectRef>& vecob)
         (nbob, nbob, Rps_TupleTag{});
       auto rd = tup->raw_data();
       for (int ix=0; ix<(int)nbob; ix++) rd[ix] = vecob[ix];
-      return tup;
+      return Rps_InternTable::intern_value<Rps_TupleOb>(tup);
     }
   else
     {
@@ -674,7 +781,7 @@ Rps_Value::get_attr(Rps_CallFrame*stkf, const Rps_ObjectRef obattr) const
   if (is_object())
     {
       const Rps_ObjectZone*thisob = as_object();
-      std::lock_guard gu(thisob->ob_mtx);
+      std::lock_guard gu(*thisob->objmtxptr());
       auto it = thisob->ob_attrs.find(obattr);
       if (it != thisob->ob_attrs.end())
         return it->second;